@@ -0,0 +1,131 @@
+/*********************************************************************
+ * FILE NAME: Atom.c
+ * AUTHOR: Andrew O'Donohue
+ * PURPOSE: Interning of identifiers, so each name is stored once and
+ *          compared by pointer.
+ *********************************************************************/
+#include "globals.h"
+#include "Atom.h"
+#include "SymbolTable.h"
+#include "Memory.h"
+
+
+/*********************************************************************
+ * FUNCTION NAME: hashText
+ * PURPOSE: FNV-1a hash of an identifier, for the atom table itself
+ * ARGUMENTS: . The identifier (const char *)
+ *            . Its length (size_t)
+ * RETURNS: The hash (unsigned int)
+ *********************************************************************/
+static unsigned int hashText(const char *text, size_t len) {
+
+    unsigned int h = 2166136261u;
+    size_t i;
+    for(i=0; i<len; ++i)
+        h = (h ^ (unsigned char)text[i]) * 16777619u;
+    return h;
+}
+
+
+/*********************************************************************
+ * FUNCTION NAME: growAtoms
+ * PURPOSE: Doubles the atom table, keeping one atom per bucket on
+ *          average
+ * ARGUMENTS: The compilation context (CompilerContext *)
+ *********************************************************************/
+static void growAtoms(CompilerContext *ctx) {
+
+    int cap = ctx->atomCap == 0 ? 256 : ctx->atomCap * 2;
+    Atom **atoms = (Atom **)calloc(cap, sizeof(Atom *));
+    Atom *a, *next;
+    int i;
+
+    ASSERT(atoms != NULL) {
+        fprintf(stderr, "Failed to grow atom table.\n");
+    }
+    for(i=0; i<ctx->atomCap; ++i) {
+        for(a = ctx->atoms[i]; a != NULL; a = next) {
+            next = a->next;
+            a->next = atoms[a->hash & (cap - 1)];
+            atoms[a->hash & (cap - 1)] = a;
+        }
+    }
+    free(ctx->atoms);
+    ctx->atoms = atoms;
+    ctx->atomNames = (char **)realloc(ctx->atomNames, cap * sizeof(char *));
+    ASSERT(ctx->atomNames != NULL) {
+        fprintf(stderr, "Failed to grow atom table.\n");
+    }
+    ctx->atomCap = cap;
+}
+
+
+/*********************************************************************
+ * FUNCTION NAME: addAtom
+ * PURPOSE: internAtom without the lock
+ * ARGUMENTS: . The compilation context (CompilerContext *)
+ *            . The identifier (const char *)
+ *            . Its length (size_t)
+ * RETURNS: The atom's name (char *)
+ *********************************************************************/
+static char *addAtom(CompilerContext *ctx, const char *text, size_t len) {
+
+    unsigned int h = hashText(text, len);
+    Atom *a;
+
+    if(ctx->atomCap != 0) {
+        for(a = ctx->atoms[h & (ctx->atomCap - 1)]; a != NULL; a = a->next) {
+            if(a->hash == h && a->length == len && memcmp(a->text, text, len) == 0)
+                return a->text;
+        }
+    }
+    if(ctx->atomCount >= ctx->atomCap)
+        growAtoms(ctx);
+
+    a = (Atom *)arenaAlloc(ctx, &ctx->atomArena, MEM_IDENTIFIER, sizeof(Atom) + len + 1);
+    memcpy(a->text, text, len);
+    a->text[len] = '\0';
+    a->hash = h;
+    a->length = len;
+    a->bucket = hash(a->text);
+    a->fun = NULL;
+    a->id = ctx->atomCount;
+    ctx->atomNames[a->id] = a->text;
+    a->next = ctx->atoms[h & (ctx->atomCap - 1)];
+    ctx->atoms[h & (ctx->atomCap - 1)] = a;
+    ctx->atomCount++;
+    return a->text;
+}
+
+
+char *internAtom(CompilerContext *ctx, const char *text, size_t len) {
+
+    char *name;
+
+    /* With -ftokens=pipeline the scanner thread interns identifiers
+     * while the parser thread may intern names of its own. */
+    if(ctx->tokenMode != TOKENS_PIPELINE)
+        return addAtom(ctx, text, len);
+    pthread_mutex_lock(&ctx->internLock);
+    name = addAtom(ctx, text, len);
+    pthread_mutex_unlock(&ctx->internLock);
+    return name;
+}
+
+
+char *internName(CompilerContext *ctx, const char *name) {
+
+    return internAtom(ctx, name, strlen(name));
+}
+
+
+void freeAtoms(CompilerContext *ctx) {
+
+    freeArena(&ctx->atomArena);
+    free(ctx->atoms);
+    free(ctx->atomNames);
+    ctx->atoms = NULL;
+    ctx->atomNames = NULL;
+    ctx->atomCap = 0;
+    ctx->atomCount = 0;
+}
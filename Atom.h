@@ -0,0 +1,49 @@
+/*********************************************************************
+ * FILE NAME: Atom.h
+ * AUTHOR: Andrew O'Donohue
+ * PURPOSE: Atom.c public interface.
+ *********************************************************************/
+#ifndef ATOM_H
+#define ATOM_H
+
+#include <stddef.h>
+#include "globals.h"
+
+/* An atom is handed out as a pointer to its name; the header before
+ * the name holds the cached hashes. */
+#define ATOM(name) ((Atom *)((name) - offsetof(Atom, text)))
+
+
+/*********************************************************************
+ * FUNCTION NAME: internAtom
+ * PURPOSE: Finds or creates the unique copy of an identifier. Two
+ *          identifiers are equal exactly when their atoms are the
+ *          same pointer
+ * ARGUMENTS: . The compilation context (CompilerContext *)
+ *            . The identifier, not necessarily NUL terminated
+ *              (const char *)
+ *            . The length of the identifier (size_t)
+ * RETURNS: The atom's name, which lives as long as the context (char *)
+ *********************************************************************/
+char *internAtom(CompilerContext *ctx, const char *text, size_t len);
+
+
+/*********************************************************************
+ * FUNCTION NAME: internName
+ * PURPOSE: internAtom for a NUL terminated name
+ * ARGUMENTS: . The compilation context (CompilerContext *)
+ *            . The name (const char *)
+ * RETURNS: The atom's name (char *)
+ *********************************************************************/
+char *internName(CompilerContext *ctx, const char *name);
+
+
+/*********************************************************************
+ * FUNCTION NAME: freeAtoms
+ * PURPOSE: Releases every atom of a compilation
+ * ARGUMENTS: The compilation context (CompilerContext *)
+ *********************************************************************/
+void freeAtoms(CompilerContext *ctx);
+
+
+#endif
@@ -0,0 +1,187 @@
+/*********************************************************************
+ * FILE NAME: Batch.c
+ * AUTHOR: Andrew O'Donohue
+ * PURPOSE: Compiles several source files in parallel.
+ *********************************************************************/
+#define _GNU_SOURCE
+#include <pthread.h>
+#include <sys/stat.h>
+#include <time.h>
+#include "globals.h"
+#include "Compiler.h"
+#include "Timer.h"
+#include "Memory.h"
+#include "Batch.h"
+
+typedef struct batch_result BatchResult;
+struct batch_result {
+    int done;
+    int status;
+    char *listing;
+    size_t listingLen;
+    char *diagnostics;
+    size_t diagnosticsLen;
+};
+
+typedef struct batch_queue BatchQueue;
+struct batch_queue {
+    char **files;
+    int count;
+    int next;
+    int printed;
+    int failed;
+    long bytes;
+    const CompileOptions *options;
+    PhaseTimer timer;
+    MemStats memory;
+    BatchResult *results;
+    pthread_mutex_t lock;
+};
+
+
+/*********************************************************************
+ * FUNCTION NAME: writeDiagnostics
+ * PURPOSE: Writes a file's diagnostics to stderr, each line prefixed
+ *          with the file name so it can be told apart from the other
+ *          files' when stderr is read on its own. A line that starts
+ *          with a line:column position is joined to the name as
+ *          name:line:column
+ * ARGUMENTS: . The name of the source file (const char *)
+ *            . The diagnostics (const char *)
+ *            . The length of the diagnostics (size_t)
+ *********************************************************************/
+static void writeDiagnostics(const char *file, const char *text, size_t len) {
+
+    size_t start = 0;
+    while(start < len) {
+        const char *nl = memchr(text + start, '\n', len - start);
+        size_t end = nl ? (size_t)(nl - text) + 1 : len;
+        fprintf(stderr, isdigit((unsigned char)text[start]) ? "%s:" : "%s: ", file);
+        fwrite(text + start, 1, end - start, stderr);
+        start = end;
+    }
+}
+
+
+/*********************************************************************
+ * FUNCTION NAME: printFinished
+ * PURPOSE: Prints the output of every finished file that follows the
+ *          last printed one, so output keeps the input order.
+ *          stdout is flushed before each file's diagnostics so its
+ *          listing header comes first. Called with queue->lock held
+ * ARGUMENTS: The batch being compiled (BatchQueue *)
+ *********************************************************************/
+static void printFinished(BatchQueue *queue) {
+
+    while(queue->printed < queue->count && queue->results[queue->printed].done) {
+        BatchResult *result = &queue->results[queue->printed];
+        fwrite(result->listing, 1, result->listingLen, stdout);
+        fflush(stdout);
+        writeDiagnostics(queue->files[queue->printed], result->diagnostics, result->diagnosticsLen);
+        free(result->listing);
+        free(result->diagnostics);
+        result->listing = NULL;
+        result->diagnostics = NULL;
+        queue->printed++;
+    }
+}
+
+
+/*********************************************************************
+ * FUNCTION NAME: batchWorker
+ * PURPOSE: Takes files off the queue and compiles them until the
+ *          queue is empty
+ * ARGUMENTS: The batch being compiled (BatchQueue *)
+ * RETURNS: NULL
+ *********************************************************************/
+static void *batchWorker(void *arg) {
+
+    BatchQueue *queue = (BatchQueue *)arg;
+    for(;;) {
+        pthread_mutex_lock(&queue->lock);
+        int i = queue->next++;
+        pthread_mutex_unlock(&queue->lock);
+        if(i >= queue->count)
+            break;
+
+        BatchResult *result = &queue->results[i];
+        FILE *listing = open_memstream(&result->listing, &result->listingLen);
+        FILE *diagnostics = open_memstream(&result->diagnostics, &result->diagnosticsLen);
+        ASSERT(listing != NULL && diagnostics != NULL) {
+            fprintf(stderr, "Failed to open output buffers for %s.\n", queue->files[i]);
+        }
+
+        CompilerContext *ctx = newCompilerContext(listing);
+        ctx->diagnostics = diagnostics;
+        applyOptions(ctx, queue->options);
+        int status = compileFile(ctx, queue->files[i]);
+        fclose(listing);
+        fclose(diagnostics);
+
+        struct stat st;
+        long size = stat(queue->files[i], &st) == 0 ? (long)st.st_size : 0;
+
+        pthread_mutex_lock(&queue->lock);
+        timerAdd(&queue->timer, &ctx->timer);
+        memAdd(&queue->memory, &ctx->memory);
+        freeCompilerContext(ctx);
+        result->status = status;
+        result->done = TRUE;
+        queue->bytes += size;
+        if(status != 0)
+            queue->failed++;
+        printFinished(queue);
+        pthread_mutex_unlock(&queue->lock);
+    }
+    return NULL;
+}
+
+
+int compileBatch(char **files, int count, int jobs, const CompileOptions *options) {
+
+    BatchQueue queue;
+    struct timespec start, end;
+    int i;
+
+    if(jobs < 1)
+        jobs = 1;
+    if(jobs > count)
+        jobs = count;
+
+    memset(&queue, 0, sizeof(queue));
+    queue.files = files;
+    queue.count = count;
+    queue.options = options;
+    queue.results = (BatchResult *)calloc(count, sizeof(BatchResult));
+    pthread_t *workers = (pthread_t *)malloc(jobs * sizeof(pthread_t));
+    ASSERT(queue.results != NULL && workers != NULL) {
+        fprintf(stderr, "Failed to malloc for batch of %d files.\n", count);
+    }
+    pthread_mutex_init(&queue.lock, NULL);
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for(i=0; i<jobs; ++i) {
+        ASSERT(pthread_create(&workers[i], NULL, batchWorker, &queue) == 0) {
+            fprintf(stderr, "Failed to start worker thread %d.\n", i);
+        }
+    }
+    for(i=0; i<jobs; ++i)
+        pthread_join(workers[i], NULL);
+    clock_gettime(CLOCK_MONOTONIC, &end);
+
+    double seconds = (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9;
+    if(seconds <= 0)
+        seconds = 1e-9;
+    fprintf(stderr, "cm: %d files (%d failed), %ld bytes, %d jobs in %.3f s: "
+            "%.1f files/s, %.1f KB/s\n", count, queue.failed, queue.bytes, jobs,
+            seconds, count / seconds, queue.bytes / 1024.0 / seconds);
+    if(options->timeReport != REPORT_NONE)
+        printTimeReport(stderr, &queue.timer, count, options->timeReport);
+    if(options->memReport != REPORT_NONE)
+        printMemReport(stderr, &queue.memory, count, options->memReport);
+
+    pthread_mutex_destroy(&queue.lock);
+    free(workers);
+    free(queue.results);
+    return queue.failed;
+}
@@ -0,0 +1,31 @@
+/*********************************************************************
+ * FILE NAME: Batch.h
+ * AUTHOR: Andrew O'Donohue
+ * PURPOSE: Batch.c public interface.
+ *********************************************************************/
+#ifndef BATCH_H
+#define BATCH_H
+
+#include "globals.h"
+
+
+/*********************************************************************
+ * FUNCTION NAME: compileBatch
+ * PURPOSE: Compiles many source files on a pool of worker threads.
+ *          Each file gets its own context, listing and diagnostics,
+ *          which are printed in input order once the file is done,
+ *          the diagnostics prefixed with the file name.
+ *          A throughput summary, and the time and memory reports
+ *          summed over all files if asked for, is printed to stderr
+ *          at the end
+ * ARGUMENTS: . The names of the source files (char **)
+ *            . The number of source files (int)
+ *            . The number of worker threads (int)
+ *            . The options each file is compiled with
+ *              (const CompileOptions *)
+ * RETURNS: The number of files that failed to compile
+ *********************************************************************/
+int compileBatch(char **files, int count, int jobs, const CompileOptions *options);
+
+
+#endif
@@ -0,0 +1,303 @@
+/*********************************************************************
+ * FILE NAME: Cache.c
+ * AUTHOR: Andrew O'Donohue
+ * PURPOSE: Content-addressed on-disk cache of compilation results.
+ *********************************************************************/
+#include <stdint.h>
+#include <unistd.h>
+#include <dirent.h>
+#include <errno.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include "globals.h"
+#include "Cache.h"
+
+#define ENTRY_SUFFIX ".cme"
+#define ENTRY_MAGIC "cm-cache-1"
+
+typedef struct cache_entry CacheEntry;
+struct cache_entry {
+    char *path;
+    long size;
+    time_t used;
+};
+
+
+CompileCache *openCache(const char *dir, long maxBytes) {
+
+    struct stat st;
+    if(mkdir(dir, 0777) != 0 && errno != EEXIST) {
+        perror(dir);
+        return NULL;
+    }
+    if(stat(dir, &st) != 0 || !S_ISDIR(st.st_mode) || access(dir, R_OK | W_OK | X_OK) != 0) {
+        fprintf(stderr, "Cache directory %s is not usable.\n", dir);
+        return NULL;
+    }
+
+    CompileCache *cache = (CompileCache *)calloc(1, sizeof(CompileCache));
+    ASSERT(cache != NULL) {
+        fprintf(stderr, "Failed to malloc for CompileCache.\n");
+    }
+    cache->dir = strdup(dir);
+    cache->maxBytes = maxBytes;
+    pthread_mutex_init(&cache->lock, NULL);
+    return cache;
+}
+
+
+void closeCache(CompileCache *cache) {
+
+    if(cache == NULL)
+        return;
+    pthread_mutex_destroy(&cache->lock);
+    free(cache->dir);
+    free(cache);
+}
+
+
+/*********************************************************************
+ * FUNCTION NAME: hashBytes
+ * PURPOSE: Feeds bytes into the two halves of a 128 bit hash: FNV-1a
+ *          and a multiply-rotate hash with unrelated constants
+ * ARGUMENTS: . The two hash halves (uint64_t *)
+ *            . The bytes (const void *)
+ *            . The number of bytes (size_t)
+ *********************************************************************/
+static void hashBytes(uint64_t *h, const void *bytes, size_t len) {
+
+    const unsigned char *p = (const unsigned char *)bytes;
+    size_t i;
+    for(i=0; i<len; ++i) {
+        h[0] = (h[0] ^ p[i]) * 0x100000001b3ULL;
+        h[1] = (h[1] + p[i] + 1) * 0x9e3779b97f4a7c15ULL;
+        h[1] = (h[1] << 23) | (h[1] >> 41);
+    }
+}
+
+
+/*********************************************************************
+ * FUNCTION NAME: mix
+ * PURPOSE: Spreads every input bit over the whole word, so the
+ *          key's hex digits are all significant
+ * ARGUMENTS: The value to mix (uint64_t)
+ * RETURNS: The mixed value (uint64_t)
+ *********************************************************************/
+static uint64_t mix(uint64_t x) {
+
+    x ^= x >> 33;
+    x *= 0xff51afd7ed558ccdULL;
+    x ^= x >> 33;
+    x *= 0xc4ceb9fe1a85ec53ULL;
+    x ^= x >> 33;
+    return x;
+}
+
+
+void cacheKey(CompilerContext *ctx, const char *src, size_t len, char *key) {
+
+    uint64_t h[2] = {0xcbf29ce484222325ULL, 0x6a09e667f3bcc908ULL};
+    char flags[6];
+    uint64_t length = len;
+
+    flags[0] = ctx->AST ? 'a' : '-';
+    flags[1] = ctx->Table ? 's' : '-';
+    flags[2] = ctx->Assembly ? 'c' : '-';
+    flags[3] = ctx->streaming ? 'f' : '-';
+    flags[4] = ctx->checkSemantics ? '-' : 'n';
+    flags[5] = '\0';
+    hashBytes(h, CM_VERSION, sizeof(CM_VERSION));
+    hashBytes(h, flags, sizeof(flags));
+    hashBytes(h, &length, sizeof(length));
+    hashBytes(h, src, len);
+    snprintf(key, CACHE_KEY_LEN, "%016llx%016llx",
+             (unsigned long long)mix(h[0] ^ mix(h[1])), (unsigned long long)mix(h[1]));
+}
+
+
+/*********************************************************************
+ * FUNCTION NAME: entryPath
+ * PURPOSE: Builds the path of the entry for a key
+ * ARGUMENTS: . The cache (CompileCache *)
+ *            . The key (const char *)
+ * RETURNS: The path, which the caller frees (char *)
+ *********************************************************************/
+static char *entryPath(CompileCache *cache, const char *key) {
+
+    size_t len = strlen(cache->dir) + 1 + strlen(key) + strlen(ENTRY_SUFFIX) + 1;
+    char *path = (char *)malloc(len);
+    ASSERT(path != NULL) {
+        fprintf(stderr, "Failed to malloc for cache path.\n");
+    }
+    snprintf(path, len, "%s/%s%s", cache->dir, key, ENTRY_SUFFIX);
+    return path;
+}
+
+
+/*********************************************************************
+ * FUNCTION NAME: readEntry
+ * PURPOSE: Reads the listing and code out of an entry file
+ * ARGUMENTS: . The entry file (FILE *)
+ *            . The rest as for cacheLookup
+ * RETURNS: 0 if the entry was read, nonzero if it is damaged
+ *********************************************************************/
+static int readEntry(FILE *entry, char **listing, size_t *listingLen, char **code, size_t *codeLen) {
+
+    char magic[sizeof(ENTRY_MAGIC)];
+    if(fscanf(entry, "%10s %zu %zu", magic, listingLen, codeLen) != 3
+            || strcmp(magic, ENTRY_MAGIC) != 0
+            || fgetc(entry) != '\n')
+        return 1;
+
+    *listing = (char *)malloc(*listingLen + 1);
+    *code = (char *)malloc(*codeLen + 1);
+    if(*listing == NULL || *code == NULL
+            || fread(*listing, 1, *listingLen, entry) != *listingLen
+            || fread(*code, 1, *codeLen, entry) != *codeLen) {
+        free(*listing);
+        free(*code);
+        return 1;
+    }
+    return 0;
+}
+
+
+int cacheLookup(CompileCache *cache, const char *key, char **listing, size_t *listingLen,
+                char **code, size_t *codeLen) {
+
+    char *path = entryPath(cache, key);
+    FILE *entry = fopen(path, "rb");
+    int status = 1;
+
+    if(entry != NULL) {
+        status = readEntry(entry, listing, listingLen, code, codeLen);
+        fclose(entry);
+        if(status == 0)
+            utimes(path, NULL);
+    }
+    free(path);
+
+    pthread_mutex_lock(&cache->lock);
+    if(status == 0)
+        cache->hits++;
+    else
+        cache->misses++;
+    pthread_mutex_unlock(&cache->lock);
+    return status;
+}
+
+
+/*********************************************************************
+ * FUNCTION NAME: compareEntries
+ * PURPOSE: Orders cache entries from least to most recently used
+ * ARGUMENTS: The two entries (const void *)
+ * RETURNS: Negative, zero or positive as for qsort
+ *********************************************************************/
+static int compareEntries(const void *a, const void *b) {
+
+    const CacheEntry *x = (const CacheEntry *)a;
+    const CacheEntry *y = (const CacheEntry *)b;
+    return (x->used > y->used) - (x->used < y->used);
+}
+
+
+/*********************************************************************
+ * FUNCTION NAME: evictEntries
+ * PURPOSE: Removes the least recently used entries until the cache
+ *          fits its size bound. Called with cache->lock held
+ * ARGUMENTS: The cache (CompileCache *)
+ *********************************************************************/
+static void evictEntries(CompileCache *cache) {
+
+    DIR *dir = opendir(cache->dir);
+    struct dirent *d;
+    CacheEntry *entries = NULL;
+    int count = 0, capacity = 0, i;
+    long total = 0;
+
+    if(dir == NULL)
+        return;
+    while((d = readdir(dir)) != NULL) {
+        size_t len = strlen(d->d_name);
+        if(len <= strlen(ENTRY_SUFFIX) || strcmp(d->d_name + len - strlen(ENTRY_SUFFIX), ENTRY_SUFFIX) != 0)
+            continue;
+        size_t pathLen = strlen(cache->dir) + 1 + len + 1;
+        char *path = (char *)malloc(pathLen);
+        struct stat st;
+        snprintf(path, pathLen, "%s/%s", cache->dir, d->d_name);
+        if(stat(path, &st) != 0) {
+            free(path);
+            continue;
+        }
+        if(count == capacity) {
+            capacity = capacity ? 2 * capacity : 64;
+            entries = (CacheEntry *)realloc(entries, capacity * sizeof(CacheEntry));
+            ASSERT(entries != NULL) {
+                fprintf(stderr, "Failed to malloc for cache entries.\n");
+            }
+        }
+        entries[count].path = path;
+        entries[count].size = (long)st.st_size;
+        entries[count].used = st.st_mtime;
+        total += entries[count].size;
+        count++;
+    }
+    closedir(dir);
+
+    if(total > cache->maxBytes) {
+        qsort(entries, count, sizeof(CacheEntry), compareEntries);
+        for(i=0; i<count && total > cache->maxBytes; ++i) {
+            if(unlink(entries[i].path) == 0) {
+                total -= entries[i].size;
+                cache->evictions++;
+            }
+        }
+    }
+    for(i=0; i<count; ++i)
+        free(entries[i].path);
+    free(entries);
+}
+
+
+void cacheStore(CompileCache *cache, const char *key, const char *listing, size_t listingLen,
+                const char *code, size_t codeLen) {
+
+    if((long)(listingLen + codeLen) > cache->maxBytes)
+        return;
+
+    char *path = entryPath(cache, key);
+    size_t tmpLen = strlen(cache->dir) + strlen("/.tmpXXXXXX") + 1;
+    char *tmp = (char *)malloc(tmpLen);
+    snprintf(tmp, tmpLen, "%s/.tmpXXXXXX", cache->dir);
+
+    int fd = mkstemp(tmp);
+    FILE *entry = fd >= 0 ? fdopen(fd, "wb") : NULL;
+    if(entry != NULL) {
+        fprintf(entry, "%s %zu %zu\n", ENTRY_MAGIC, listingLen, codeLen);
+        fwrite(listing, 1, listingLen, entry);
+        fwrite(code, 1, codeLen, entry);
+        if(fclose(entry) == 0 && rename(tmp, path) == 0) {
+            pthread_mutex_lock(&cache->lock);
+            cache->stores++;
+            evictEntries(cache);
+            pthread_mutex_unlock(&cache->lock);
+        }
+        else
+            unlink(tmp);
+    }
+    else if(fd >= 0) {
+        close(fd);
+        unlink(tmp);
+    }
+    free(tmp);
+    free(path);
+}
+
+
+void printCacheReport(FILE *out, CompileCache *cache) {
+
+    pthread_mutex_lock(&cache->lock);
+    fprintf(out, "cm: cache %s: %ld hits, %ld misses, %ld stores, %ld evictions\n",
+            cache->dir, cache->hits, cache->misses, cache->stores, cache->evictions);
+    pthread_mutex_unlock(&cache->lock);
+}
@@ -0,0 +1,89 @@
+/*********************************************************************
+ * FILE NAME: Cache.h
+ * AUTHOR: Andrew O'Donohue
+ * PURPOSE: Cache.c public interface.
+ *
+ * Entries are named after a hash of the compiler version, the -a/-s/-c
+ * flags and the source bytes, so an entry never needs invalidating.
+ * Each entry holds the listing and the TM code of a successful
+ * compilation. When the directory grows past its size bound the least
+ * recently used entries are removed.
+ *********************************************************************/
+#ifndef CACHE_H
+#define CACHE_H
+
+#include "globals.h"
+
+#define CACHE_KEY_LEN 33
+
+
+/*********************************************************************
+ * FUNCTION NAME: openCache
+ * PURPOSE: Opens a cache directory, creating it if needed
+ * ARGUMENTS: . The cache directory (const char *)
+ *            . The most bytes the cache may hold (long)
+ * RETURNS: The cache, NULL if the directory cannot be used
+ *          (CompileCache *)
+ *********************************************************************/
+CompileCache *openCache(const char *dir, long maxBytes);
+
+
+/*********************************************************************
+ * FUNCTION NAME: closeCache
+ * PURPOSE: Releases a cache; the directory is left as it is
+ * ARGUMENTS: The cache (CompileCache *)
+ *********************************************************************/
+void closeCache(CompileCache *cache);
+
+
+/*********************************************************************
+ * FUNCTION NAME: cacheKey
+ * PURPOSE: Computes the key of a source under the context's flags
+ * ARGUMENTS: . The compilation context (CompilerContext *)
+ *            . The source text (const char *)
+ *            . The length of the source text (size_t)
+ *            . Receives the key, CACHE_KEY_LEN bytes (char *)
+ *********************************************************************/
+void cacheKey(CompilerContext *ctx, const char *src, size_t len, char *key);
+
+
+/*********************************************************************
+ * FUNCTION NAME: cacheLookup
+ * PURPOSE: Looks up an entry and counts the hit or miss
+ * ARGUMENTS: . The cache (CompileCache *)
+ *            . The key (const char *)
+ *            . Receives the listing, which the caller frees (char **)
+ *            . Receives the length of the listing (size_t *)
+ *            . Receives the code, which the caller frees (char **)
+ *            . Receives the length of the code (size_t *)
+ * RETURNS: 0 on a hit, nonzero on a miss
+ *********************************************************************/
+int cacheLookup(CompileCache *cache, const char *key, char **listing, size_t *listingLen,
+                char **code, size_t *codeLen);
+
+
+/*********************************************************************
+ * FUNCTION NAME: cacheStore
+ * PURPOSE: Adds an entry, then evicts old entries over the size bound.
+ *          Entries larger than the whole bound are not stored
+ * ARGUMENTS: . The cache (CompileCache *)
+ *            . The key (const char *)
+ *            . The listing (const char *)
+ *            . The length of the listing (size_t)
+ *            . The code (const char *)
+ *            . The length of the code (size_t)
+ *********************************************************************/
+void cacheStore(CompileCache *cache, const char *key, const char *listing, size_t listingLen,
+                const char *code, size_t codeLen);
+
+
+/*********************************************************************
+ * FUNCTION NAME: printCacheReport
+ * PURPOSE: Prints the hit, miss, store and eviction counters
+ * ARGUMENTS: . The stream to print to (FILE *)
+ *            . The cache (CompileCache *)
+ *********************************************************************/
+void printCacheReport(FILE *out, CompileCache *cache);
+
+
+#endif
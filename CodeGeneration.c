@@ -6,440 +6,685 @@
 #include "globals.h"
 #include "parse.h"
 #include "SymbolTable.h"
+#include "SyntaxTree.h"
 #include "CodeGeneration.h"
+#include "Timer.h"
+#include "Memory.h"
+#include "Atom.h"
+#include "Constant.h"
+#include "CompactTree.h"
+#include "SemanticAnalysis.h"
 
 
-TreeNode *paramStack[SIZE];
-int top = 0;
-int emitLoc = 0;
-int highEmitLoc = 0;
+int pushParam(CompilerContext *ctx, int param) {
 
-
-int pushParam(TreeNode *param) {
-
-    if(top == SIZE)
+    if(ctx->top == SIZE)
         return 1;
-    paramStack[top++] = param;
+    ctx->paramStack[ctx->top++] = param;
 
     return 0;
 }
 
 
-TreeNode *popParam() {
+int popParam(CompilerContext *ctx) {
 
-    if(top == 0)
-        return NULL;
+    if(ctx->top == 0)
+        return NO_NODE;
 
-    return paramStack[--top];
+    return ctx->paramStack[--ctx->top];
 }
 
 
-int generateSkip(int howMany) {
-    int i = emitLoc;
+int generateSkip(CompilerContext *ctx, int howMany) {
+    int i = ctx->emitLoc;
 
-    emitLoc += howMany;
-    if (highEmitLoc < emitLoc)
-        highEmitLoc = emitLoc;
+    ctx->emitLoc += howMany;
+    if (ctx->highEmitLoc < ctx->emitLoc)
+        ctx->highEmitLoc = ctx->emitLoc;
 
     return i;
 }
 
 
-void generateRewind(int loc) {
+void generateRewind(CompilerContext *ctx, int loc) {
 
-    if (loc > highEmitLoc)
-        generateComment("BUG in generateRewind");
-    emitLoc = loc;
+    if (loc > ctx->highEmitLoc)
+        generateComment(ctx, "BUG in generateRewind");
+    ctx->emitLoc = loc;
 
 }
 
 
-void generateRestore(void) {
-    emitLoc = highEmitLoc;
+void generateRestore(CompilerContext *ctx) {
+    ctx->emitLoc = ctx->highEmitLoc;
 }
 
 
-void generateComment(char *c) {
+static const char *opNames[OP_COUNT] = {
+    "", "HALT", "IN", "OUT", "ADD", "SUB", "MUL", "DIV", "LD", "ST", "LDA",
+    "LDC", "JLT", "JLE", "JGT", "JGE", "JEQ", "JNE"
+};
 
-    if (TraceCode)
-        fprintf(code,"* %s\n",c);
+
+/* The index in ctx->instructions of a location still kept there. */
+#define INSTRUCTION_INDEX(ctx, loc) \
+    ((loc) < (ctx)->heldLocs ? (loc) : (loc) - (ctx)->codeBase + (ctx)->heldLocs)
+
+
+/*********************************************************************
+ * FUNCTION NAME: emitInstruction
+ * PURPOSE: Stores an instruction at the current location, growing the
+ *          instruction buffer as needed
+ * ARGUMENTS: . The compilation context (CompilerContext *)
+ *            . The operation (Opcode)
+ *            . The three operands (int)
+ *            . The comment, which must outlive the compilation (char *)
+ *********************************************************************/
+static void emitInstruction(CompilerContext *ctx, Opcode op, int r, int s, int t, char *c) {
+
+    int loc = ctx->emitLoc++;
+    int i = INSTRUCTION_INDEX(ctx, loc);
+
+    if(i >= ctx->instructionCap) {
+        int cap = ctx->instructionCap == 0 ? 1024 : ctx->instructionCap * 2;
+        while(cap <= i)
+            cap *= 2;
+        ctx->instructions = (Instruction *)realloc(ctx->instructions, cap * sizeof(Instruction));
+        ASSERT(ctx->instructions != NULL) {
+            fprintf(stderr, "Failed to grow instruction buffer.\n");
+        }
+        memset(ctx->instructions + ctx->instructionCap, 0,
+               (cap - ctx->instructionCap) * sizeof(Instruction));
+        ctx->instructionCap = cap;
+    }
+    ctx->instructions[i].op = op;
+    ctx->instructions[i].r = r;
+    ctx->instructions[i].s = s;
+    ctx->instructions[i].t = t;
+    ctx->instructions[i].comment = c;
+    if (ctx->highEmitLoc < ctx->emitLoc)
+        ctx->highEmitLoc = ctx->emitLoc;
 }
 
 
-void generateRegOnly(char *op, int r, int s, int t, char *c) {
+void generateComment(CompilerContext *ctx, char *c) {
 
-    fprintf(code,"%3d:  %5s  %d,%d,%d ",emitLoc++,op,r,s,t);
-    if (TraceCode)
-        fprintf(code,"\t%s",c);
-    fprintf(code,"\n");
-    if (highEmitLoc < emitLoc)
-        highEmitLoc = emitLoc;
+    if (!TraceCode)
+        return;
+    if(ctx->commentCount == ctx->commentCap) {
+        ctx->commentCap = ctx->commentCap == 0 ? 256 : ctx->commentCap * 2;
+        ctx->comments = (CodeComment *)realloc(ctx->comments, ctx->commentCap * sizeof(CodeComment));
+        ASSERT(ctx->comments != NULL) {
+            fprintf(stderr, "Failed to grow comment buffer.\n");
+        }
+    }
+    ctx->comments[ctx->commentCount].loc = ctx->emitLoc;
+    ctx->comments[ctx->commentCount].text = c;
+    ctx->commentCount++;
 }
 
 
-void generateRegMem(char *op, int r, int d, int s, char *c) {
+void generateRegOnly(CompilerContext *ctx, Opcode op, int r, int s, int t, char *c) {
 
-    fprintf(code,"%3d:  %5s  %d,%d(%d) ",emitLoc++,op,r,d,s);
-    if (TraceCode)
-        fprintf(code,"\t%s",c);
-    fprintf(code,"\n");
-    if (highEmitLoc < emitLoc)
-        highEmitLoc = emitLoc;
+    emitInstruction(ctx, op, r, s, t, c);
+}
+
+
+void generateRegMem(CompilerContext *ctx, Opcode op, int r, int d, int s, char *c) {
+
+    emitInstruction(ctx, op, r, d, s, c);
+}
+
+
+typedef struct code_text CodeText;
+struct code_text {
+    char *text;
+    size_t len;
+    size_t cap;
+};
+
+
+/*********************************************************************
+ * FUNCTION NAME: reserveText
+ * PURPOSE: Makes room at the end of the code text
+ * ARGUMENTS: . The code text (CodeText *)
+ *            . The number of bytes needed (size_t)
+ * RETURNS: Where to write the next bytes (char *)
+ *********************************************************************/
+static char *reserveText(CodeText *out, size_t need) {
+
+    if(out->len + need > out->cap) {
+        out->cap = out->cap == 0 ? 65536 : out->cap;
+        while(out->len + need > out->cap)
+            out->cap *= 2;
+        out->text = (char *)realloc(out->text, out->cap);
+        ASSERT(out->text != NULL) {
+            fprintf(stderr, "Failed to grow code output buffer.\n");
+        }
+    }
+    return out->text + out->len;
+}
+
+
+/*********************************************************************
+ * FUNCTION NAME: putInt
+ * PURPOSE: Writes a number right aligned in a field, as "%*d" would
+ * ARGUMENTS: . Where to write (char *)
+ *            . The number (int)
+ *            . The field width (int)
+ * RETURNS: The end of what was written (char *)
+ *********************************************************************/
+static char *putInt(char *p, int v, int width) {
+
+    char digits[12];
+    unsigned int u = v < 0 ? -(unsigned int)v : (unsigned int)v;
+    int n = 0;
+
+    do {
+        digits[n++] = '0' + u % 10;
+        u /= 10;
+    } while(u != 0);
+    if(v < 0)
+        digits[n++] = '-';
+    for(; width > n; --width)
+        *p++ = ' ';
+    while(n > 0)
+        *p++ = digits[--n];
+    return p;
+}
+
+
+/*********************************************************************
+ * FUNCTION NAME: putText
+ * PURPOSE: Writes a string right aligned in a field, as "%*s" would
+ * ARGUMENTS: . Where to write (char *)
+ *            . The string (const char *)
+ *            . The field width (int)
+ * RETURNS: The end of what was written (char *)
+ *********************************************************************/
+static char *putText(char *p, const char *text, int width) {
+
+    size_t n = strlen(text);
+
+    for(; width > (int)n; --width)
+        *p++ = ' ';
+    memcpy(p, text, n);
+    return p + n;
+}
+
+
+/*********************************************************************
+ * FUNCTION NAME: writeRange
+ * PURPOSE: Writes the instructions of a range of locations and the
+ *          comments recorded against them and the location after, in
+ *          location order, with a single write to the code file. The
+ *          comments are removed from those still to be written
+ * ARGUMENTS: . The compilation context (CompilerContext *)
+ *            . The first location (int)
+ *            . The location after the last (int)
+ *********************************************************************/
+static void writeRange(CompilerContext *ctx, int from, int to) {
+
+    int n = to - from + 1;
+    int count = 0, kept = 0;
+    int i, loc;
+
+    /* Comments are recorded against the location that followed them.
+     * A counting sort on that location keeps the comments of each
+     * location in the order they were generated. */
+    int *first = (int *)calloc(n + 1, sizeof(int));
+    CodeComment *sorted = (CodeComment *)malloc((ctx->commentCount + 1) * sizeof(CodeComment));
+    ASSERT(first != NULL && sorted != NULL) {
+        fprintf(stderr, "Failed to allocate code output buffers.\n");
+    }
+    for(i=0; i<ctx->commentCount; ++i) {
+        loc = ctx->comments[i].loc;
+        if(loc >= from && loc <= to) {
+            first[loc - from + 1]++;
+            count++;
+        }
+    }
+    for(loc=0; loc<n; ++loc)
+        first[loc + 1] += first[loc];
+    for(i=0; i<ctx->commentCount; ++i) {
+        loc = ctx->comments[i].loc;
+        if(loc >= from && loc <= to)
+            sorted[first[loc - from]++] = ctx->comments[i];
+        else
+            ctx->comments[kept++] = ctx->comments[i];
+    }
+    ctx->commentCount = kept;
+
+    timerStart(ctx, PHASE_OUTPUT);
+    CodeText out = {NULL, 0, 0};
+    i = 0;
+    for(loc=from; loc<=to; ++loc) {
+        for(; i<count && sorted[i].loc == loc; ++i) {
+            char *p = reserveText(&out, strlen(sorted[i].text) + 3);
+            *p++ = '*';
+            *p++ = ' ';
+            p = putText(p, sorted[i].text, 0);
+            *p++ = '\n';
+            out.len = p - out.text;
+        }
+        if(loc == to || loc >= ctx->highEmitLoc || ctx->instructions[INSTRUCTION_INDEX(ctx, loc)].op == OP_NONE)
+            continue;
+
+        /* The same layout as "%3d:  %5s  %d,%d,%d \t%s\n", with
+         * "%d,%d(%d)" for register-memory instructions. */
+        Instruction *in = &ctx->instructions[INSTRUCTION_INDEX(ctx, loc)];
+        char *p = reserveText(&out, (TraceCode ? strlen(in->comment) : 0) + 64);
+        p = putInt(p, loc, 3);
+        p = putText(p, ":  ", 0);
+        p = putText(p, opNames[in->op], 5);
+        p = putText(p, "  ", 0);
+        p = putInt(p, in->r, 0);
+        *p++ = ',';
+        p = putInt(p, in->s, 0);
+        *p++ = in->op < OP_LD ? ',' : '(';
+        p = putInt(p, in->t, 0);
+        if(in->op >= OP_LD)
+            *p++ = ')';
+        *p++ = ' ';
+        if (TraceCode) {
+            *p++ = '\t';
+            p = putText(p, in->comment, 0);
+        }
+        *p++ = '\n';
+        out.len = p - out.text;
+    }
+    if(out.len > 0)
+        fwrite(out.text, 1, out.len, ctx->code);
+    timerStop(ctx);
+    free(out.text);
+    free(sorted);
+    free(first);
 }
 
 
-void generatePrelude() {
+/*********************************************************************
+ * FUNCTION NAME: flushCode
+ * PURPOSE: In streaming mode, writes the code generated since the last
+ *          flush and releases it, keeping the held locations
+ * ARGUMENTS: The compilation context (CompilerContext *)
+ *********************************************************************/
+static void flushCode(CompilerContext *ctx) {
+
+    int n = ctx->highEmitLoc - ctx->codeBase;
+
+    if(n > ctx->instructionCap - ctx->heldLocs)
+        n = ctx->instructionCap - ctx->heldLocs;
+    writeRange(ctx, ctx->codeBase, ctx->highEmitLoc);
+    memset(ctx->instructions + ctx->heldLocs, 0, n * sizeof(Instruction));
+    ctx->codeBase = ctx->highEmitLoc;
+}
+
+
+void writeCode(CompilerContext *ctx) {
+
+    int end = ctx->highEmitLoc;
+    int i;
+
+    /* Comments after the last instruction are written last. */
+    for(i=0; i<ctx->commentCount; ++i)
+        if(ctx->comments[i].loc > end)
+            end = ctx->comments[i].loc;
+    if(ctx->heldLocs > 0)
+        writeRange(ctx, 0, ctx->heldLocs);
+    writeRange(ctx, ctx->codeBase, end);
+}
+
+
+void generatePrelude(CompilerContext *ctx) {
 
     if (TraceCode)
-        generateComment("Begin prelude");
-    generateRegMem("LD",gp,0,zero,"load from location 0");
-    generateRegMem("ST",zero,0,zero,"clear location 0");
-    generateRegMem("LDA",sp,-(topTable()->size),gp,"allocate for global variables");
+        generateComment(ctx, "Begin prelude");
+    generateRegMem(ctx, OP_LD,gp,0,zero,"load from location 0");
+    generateRegMem(ctx, OP_ST,zero,0,zero,"clear location 0");
+    generateRegMem(ctx, OP_LDA,sp,-(topTable(ctx)->size),gp,"allocate for global variables");
     if (TraceCode)
-        generateComment("End of prelude");
+        generateComment(ctx, "End of prelude");
 }
 
 
-void generateInput() {
+void generateInput(CompilerContext *ctx) {
 
     if (TraceCode)
-        generateComment("Begin input()");
-    FunSymbol *fun = getFunction("input");
-    fun->offset = generateSkip(0);
-    generateRegOnly("IN",ax,0,0,"read input into ax");
-    generateRegMem("LDA",sp,1,sp,"pop prepare");
-    generateRegMem("LD",pc,-1,sp,"pop return addr");
+        generateComment(ctx, "Begin input()");
+    FunSymbol *fun = getFunction(ctx, internName(ctx, "input"));
+    fun->offset = generateSkip(ctx, 0);
+    generateRegOnly(ctx, OP_IN,ax,0,0,"read input into ax");
+    generateRegMem(ctx, OP_LDA,sp,1,sp,"pop prepare");
+    generateRegMem(ctx, OP_LD,pc,-1,sp,"pop return addr");
     if (TraceCode)
-        generateComment("End input()");
+        generateComment(ctx, "End input()");
 }
 
 
-void generateOutput() {
+void generateOutput(CompilerContext *ctx) {
 
     if (TraceCode)
-        generateComment("Begin output()");
-    FunSymbol *fun = getFunction("output");
-    fun->offset = generateSkip(0);
-    generateRegMem("LD",ax,1,sp,"load param into ax");
-    generateRegOnly("OUT",ax,0,0,"output using ax");
-    generateRegMem("LDA",sp,1,sp,"pop prepare");
-    generateRegMem("LD",pc,-1,sp,"pop return addr");
+        generateComment(ctx, "Begin output()");
+    FunSymbol *fun = getFunction(ctx, internName(ctx, "output"));
+    fun->offset = generateSkip(ctx, 0);
+    generateRegMem(ctx, OP_LD,ax,1,sp,"load param into ax");
+    generateRegOnly(ctx, OP_OUT,ax,0,0,"output using ax");
+    generateRegMem(ctx, OP_LDA,sp,1,sp,"pop prepare");
+    generateRegMem(ctx, OP_LD,pc,-1,sp,"pop return addr");
     if (TraceCode)
-        generateComment("End output()");
+        generateComment(ctx, "End output()");
 }
 
 
-void generateGetAddr(VarSymbol *var) {
+void generateGetAddr(CompilerContext *ctx, VarSymbol *var) {
 
     switch(var->scope) {
     case GLOBAL:
         if(var->type == TYPE_ARRAY) {
-            generateRegMem("LDA",bx,-(var->offset),gp,"get global array address");
+            generateRegMem(ctx, OP_LDA,bx,-(var->offset),gp,"get global array address");
         } else {
-            generateRegMem("LDA",bx,-1-(var->offset),gp,"get global address");
+            generateRegMem(ctx, OP_LDA,bx,-1-(var->offset),gp,"get global address");
         }
         break;
     case LOCAL:
         if(var->type == TYPE_ARRAY) {
-            generateRegMem("LDA",bx,-(var->offset),bp,"get local array address");
+            generateRegMem(ctx, OP_LDA,bx,-(var->offset),bp,"get local array address");
         } else {
-            generateRegMem("LDA",bx,-1-(var->offset),bp,"get local address");
+            generateRegMem(ctx, OP_LDA,bx,-1-(var->offset),bp,"get local address");
         }
         break;
     case PARAM:
         if(var->type == TYPE_ARRAY) {
-            generateRegMem("LD",bx,2+(var->offset),bp,"get param array address");
+            generateRegMem(ctx, OP_LD,bx,2+(var->offset),bp,"get param array address");
         } else {
-            generateRegMem("LDA",bx,2+(var->offset),bp,"get param variable address");
+            generateRegMem(ctx, OP_LDA,bx,2+(var->offset),bp,"get param variable address");
         }
         break;
     }
 }
 
 
-void generateFunCall(FunSymbol *fun) {
+void generateFunCall(CompilerContext *ctx, FunSymbol *fun) {
 
-    generateRegMem("LDA",ax,3,pc,"store returned PC");
-    generateRegMem("LDA",sp,-1,sp,"push prepare");
-    generateRegMem("ST",ax,0,sp,"push returned PC");
-    generateRegMem("LDC",pc,fun->offset,0,"jump to function");
-    generateRegMem("LDA",sp,fun->paramNum,sp,"release parameters");
+    generateRegMem(ctx, OP_LDA,ax,3,pc,"store returned PC");
+    generateRegMem(ctx, OP_LDA,sp,-1,sp,"push prepare");
+    generateRegMem(ctx, OP_ST,ax,0,sp,"push returned PC");
+    generateRegMem(ctx, OP_LDC,pc,fun->offset,0,"jump to function");
+    generateRegMem(ctx, OP_LDA,sp,fun->paramNum,sp,"release parameters");
 }
 
 
-static int getValue = 1;
-static int isRecursive = 1;
-
-
-void recursiveGen(TreeNode *tree) {
+void recursiveGen(CompilerContext *ctx, int tree) {
     int tmp;
-    TreeNode *p1, *p2, *p3;
+    int p1, p2, p3;
     int savedLoc1,savedLoc2,currentLoc;
     VarSymbol *var;
     FunSymbol *fun;
+    CompactNode *node;
 
-    while(tree) {
-        switch (tree->astType) {
+    while(tree != NO_NODE) {
+        node = NODE(ctx, tree);
+        switch (node->astType) {
         case FUNDEC_AST:
             if (TraceCode)
-                generateComment("-> function:");
-            p1 = tree->child[0];
-            p2 = tree->child[1];
-            fun = getFunction(p1->attr.name);
-            fun->offset = generateSkip(0);
-            generateRegMem("LDA",sp,-1,sp,"push prepare");
-            generateRegMem("ST",bp,0,sp,"push old bp");
-            generateRegMem("LDA",bp,0,sp,"let bp == sp");
-            generateRegMem("LDA",sp,-(p2->symbolTable->size),sp,"allocate for local variables");
-            pushTable(fun->symbolTable);
-            recursiveGen(p2);
-            popTable();
-            if(p1->type == TYPE_VOID) {
-                generateRegMem("LDA",sp,0,bp,"let sp == bp");
-                generateRegMem("LDA",sp,2,sp,"pop prepare");
-                generateRegMem("LD",bp,-2,sp,"pop old bp");
-                generateRegMem("LD",pc,-1,sp,"pop return addr");
+                generateComment(ctx, "-> function:");
+            p1 = CHILD(ctx, tree, 0);
+            p2 = CHILD(ctx, tree, 1);
+            fun = getFunction(ctx, NODE_NAME(ctx, p1));
+            fun->offset = generateSkip(ctx, 0);
+            generateRegMem(ctx, OP_LDA,sp,-1,sp,"push prepare");
+            generateRegMem(ctx, OP_ST,bp,0,sp,"push old bp");
+            generateRegMem(ctx, OP_LDA,bp,0,sp,"let bp == sp");
+            generateRegMem(ctx, OP_LDA,sp,-(ctx->compact.tables[NODE(ctx, p2)->payload]->size),sp,"allocate for local variables");
+            pushTable(ctx, fun->symbolTable);
+            recursiveGen(ctx, p2);
+            popTable(ctx);
+            if(NODE(ctx, p1)->type == TYPE_VOID) {
+                generateRegMem(ctx, OP_LDA,sp,0,bp,"let sp == bp");
+                generateRegMem(ctx, OP_LDA,sp,2,sp,"pop prepare");
+                generateRegMem(ctx, OP_LD,bp,-2,sp,"pop old bp");
+                generateRegMem(ctx, OP_LD,pc,-1,sp,"pop return addr");
             }
             if (TraceCode)
-                generateComment("<- function");
+                generateComment(ctx, "<- function");
             break;
 
         case COMPOUND_AST:
             if (TraceCode)
-                generateComment("-> compound");
-            p1 = tree->child[1];
-            if(tree->symbolTable)
-                pushTable(tree->symbolTable);
-            recursiveGen(p1);
-            if(tree->symbolTable)
-                popTable();
+                generateComment(ctx, "-> compound");
+            p1 = CHILD(ctx, tree, 1);
+            if(node->payload != NO_NODE)
+                pushTable(ctx, ctx->compact.tables[node->payload]);
+            recursiveGen(ctx, p1);
+            if(node->payload != NO_NODE)
+                popTable(ctx);
             if (TraceCode)
-                generateComment("<- compound");
+                generateComment(ctx, "<- compound");
             break;
 
         case SELESTMT_AST:
             if (TraceCode)
-                generateComment("-> if");
-            p1 = tree->child[0];
-            p2 = tree->child[1];
-            p3 = tree->child[2];
-            recursiveGen(p1);
-            savedLoc1 = generateSkip(1);
-            generateComment("jump to else ");
-            recursiveGen(p2);
-            savedLoc2 = generateSkip(1);
-            generateComment("jump to end");
-            currentLoc = generateSkip(0);
-            generateRewind(savedLoc1);
-            generateRegMem("JEQ",ax,currentLoc,zero,"if: jmp to else");
-            generateRestore();
-            recursiveGen(p3);
-            currentLoc = generateSkip(0);
-            generateRewind(savedLoc2);
-            generateRegMem("LDA",pc,currentLoc,zero,"jmp to end");
-            generateRestore();
+                generateComment(ctx, "-> if");
+            p1 = CHILD(ctx, tree, 0);
+            p2 = CHILD(ctx, tree, 1);
+            p3 = CHILD(ctx, tree, 2);
+            recursiveGen(ctx, p1);
+            savedLoc1 = generateSkip(ctx, 1);
+            generateComment(ctx, "jump to else ");
+            recursiveGen(ctx, p2);
+            savedLoc2 = generateSkip(ctx, 1);
+            generateComment(ctx, "jump to end");
+            currentLoc = generateSkip(ctx, 0);
+            generateRewind(ctx, savedLoc1);
+            generateRegMem(ctx, OP_JEQ,ax,currentLoc,zero,"if: jmp to else");
+            generateRestore(ctx);
+            recursiveGen(ctx, p3);
+            currentLoc = generateSkip(ctx, 0);
+            generateRewind(ctx, savedLoc2);
+            generateRegMem(ctx, OP_LDA,pc,currentLoc,zero,"jmp to end");
+            generateRestore(ctx);
             if (TraceCode)
-                generateComment("<- if");
+                generateComment(ctx, "<- if");
             break;
 
         case ITERSTMT_AST:
             if (TraceCode)
-                generateComment("-> while");
-            p1 = tree->child[0];
-            p2 = tree->child[1];
-            savedLoc1 = generateSkip(0);
-            generateComment("jump here after body");
-            recursiveGen(p1);
-            savedLoc2 = generateSkip(1);
-            generateComment("jump to end if test fails");
-            recursiveGen(p2);
-            generateRegMem("LDA",pc,savedLoc1,zero,"jump to test");
-            currentLoc = generateSkip(0);
-            generateRewind(savedLoc2);
-            generateRegMem("JEQ",ax,currentLoc,zero,"jump to end");
-            generateRestore();
+                generateComment(ctx, "-> while");
+            p1 = CHILD(ctx, tree, 0);
+            p2 = CHILD(ctx, tree, 1);
+            savedLoc1 = generateSkip(ctx, 0);
+            generateComment(ctx, "jump here after body");
+            recursiveGen(ctx, p1);
+            savedLoc2 = generateSkip(ctx, 1);
+            generateComment(ctx, "jump to end if test fails");
+            recursiveGen(ctx, p2);
+            generateRegMem(ctx, OP_LDA,pc,savedLoc1,zero,"jump to test");
+            currentLoc = generateSkip(ctx, 0);
+            generateRewind(ctx, savedLoc2);
+            generateRegMem(ctx, OP_JEQ,ax,currentLoc,zero,"jump to end");
+            generateRestore(ctx);
             if (TraceCode)
-                generateComment("<- while");
+                generateComment(ctx, "<- while");
             break;
 
         case RETSTMT_AST:
             if (TraceCode)
-                generateComment("-> return");
-            p1 = tree->child[0];
-            if(tree->type != TYPE_VOID)
-                recursiveGen(p1);
-            generateRegMem("LDA",sp,0,bp,"let sp == bp");
-            generateRegMem("LDA",sp,2,sp,"pop prepare");
-            generateRegMem("LD",bp,-2,sp,"pop old bp");
-            generateRegMem("LD",pc,-1,sp,"pop return addr");
+                generateComment(ctx, "-> return");
+            p1 = CHILD(ctx, tree, 0);
+            if(node->type != TYPE_VOID)
+                recursiveGen(ctx, p1);
+            generateRegMem(ctx, OP_LDA,sp,0,bp,"let sp == bp");
+            generateRegMem(ctx, OP_LDA,sp,2,sp,"pop prepare");
+            generateRegMem(ctx, OP_LD,bp,-2,sp,"pop old bp");
+            generateRegMem(ctx, OP_LD,pc,-1,sp,"pop return addr");
             if (TraceCode)
-                generateComment("<- return");
+                generateComment(ctx, "<- return");
             break;
 
         case NUM_AST:
             if(TraceCode)
-                generateComment("-> number");
-            generateRegMem("LDC",ax,tree->attr.value,0,"store number");
+                generateComment(ctx, "-> number");
+            generateRegMem(ctx, OP_LDC,ax,constantValue(ctx, node->payload),0,"store number");
             if(TraceCode)
-                generateComment("<- number");
+                generateComment(ctx, "<- number");
             break;
 
         case VAR_AST:
             if(TraceCode)
-                generateComment("-> variable");
-            var = getVariable(tree->attr.name);
-            generateGetAddr(var);
-            if(getValue) {
+                generateComment(ctx, "-> variable");
+            var = getVariable(ctx, NODE_NAME(ctx, tree));
+            generateGetAddr(ctx, var);
+            if(ctx->getValue) {
                 if(var->type == TYPE_ARRAY) {
-                    generateRegMem("LDA",ax,0,bx,"get array variable value( == address)");
+                    generateRegMem(ctx, OP_LDA,ax,0,bx,"get array variable value( == address)");
                 } else {
-                    generateRegMem("LD",ax,0,bx,"get variable value");
+                    generateRegMem(ctx, OP_LD,ax,0,bx,"get variable value");
                 }
             }
             if(TraceCode)
-                generateComment("<- variable");
+                generateComment(ctx, "<- variable");
             break;
 
         case ARRAYVAR_AST:
             if(TraceCode)
-                generateComment("-> array element");
-            p1 = tree->child[0];
-            var = getVariable(tree->attr.name);
-            generateGetAddr(var);
-            generateRegMem("LDA",sp,-1,sp,"push prepare");
-            generateRegMem("ST",bx,0,sp,"protect array address");
-            tmp = getValue;
-            getValue = 1;
-            recursiveGen(p1);
-            getValue = tmp;
-            generateRegMem("LDA",sp,1,sp,"pop prepare");
-            generateRegMem("LD",bx,-1,sp,"recover array address");
-            generateRegOnly("SUB",bx,bx,ax,"get address of array element");
-            if(getValue)
-                generateRegMem("LD",ax,0,bx,"get value of array element");
+                generateComment(ctx, "-> array element");
+            p1 = CHILD(ctx, tree, 0);
+            var = getVariable(ctx, NODE_NAME(ctx, tree));
+            generateGetAddr(ctx, var);
+            generateRegMem(ctx, OP_LDA,sp,-1,sp,"push prepare");
+            generateRegMem(ctx, OP_ST,bx,0,sp,"protect array address");
+            tmp = ctx->getValue;
+            ctx->getValue = 1;
+            recursiveGen(ctx, p1);
+            ctx->getValue = tmp;
+            generateRegMem(ctx, OP_LDA,sp,1,sp,"pop prepare");
+            generateRegMem(ctx, OP_LD,bx,-1,sp,"recover array address");
+            generateRegOnly(ctx, OP_SUB,bx,bx,ax,"get address of array element");
+            if(ctx->getValue)
+                generateRegMem(ctx, OP_LD,ax,0,bx,"get value of array element");
             if(TraceCode)
-                generateComment("<- array element");
+                generateComment(ctx, "<- array element");
             break;
 
         case ASSIGN_AST:
             if (TraceCode)
-                generateComment("-> assign");
-            p1 = tree->child[0];
-            p2 = tree->child[1];
-            getValue = 0;
-            recursiveGen(p1);
-            generateRegMem("LDA",sp,-1,sp,"push prepare");
-            generateRegMem("ST",bx,0,sp,"protect bx");
-            getValue = 1;
-            recursiveGen(p2);
-            generateRegMem("LDA",sp,1,sp,"pop prepare");
-            generateRegMem("LD",bx,-1,sp,"recover bx");
-            generateRegMem("ST",ax,0,bx,"assign: store");
+                generateComment(ctx, "-> assign");
+            p1 = CHILD(ctx, tree, 0);
+            p2 = CHILD(ctx, tree, 1);
+            ctx->getValue = 0;
+            recursiveGen(ctx, p1);
+            generateRegMem(ctx, OP_LDA,sp,-1,sp,"push prepare");
+            generateRegMem(ctx, OP_ST,bx,0,sp,"protect bx");
+            ctx->getValue = 1;
+            recursiveGen(ctx, p2);
+            generateRegMem(ctx, OP_LDA,sp,1,sp,"pop prepare");
+            generateRegMem(ctx, OP_LD,bx,-1,sp,"recover bx");
+            generateRegMem(ctx, OP_ST,ax,0,bx,"assign: store");
             if (TraceCode)
-                generateComment("<- assign");
+                generateComment(ctx, "<- assign");
             break;
 
         case EXP_AST:
             if (TraceCode)
-                generateComment("-> op");
-            p1 = tree->child[0];
-            p2 = tree->child[1];
-            recursiveGen(p1);
-            generateRegMem("LDA",sp,-1,sp,"push prepare");
-            generateRegMem("ST",ax,0,sp,"op: protect left");
-            recursiveGen(p2);
-            generateRegMem("LDA",sp,1,sp,"pop prepare");
-            generateRegMem("LD",bx,-1,sp,"op: recover left");
-            switch (tree->attr.op) {
+                generateComment(ctx, "-> op");
+            p1 = CHILD(ctx, tree, 0);
+            p2 = CHILD(ctx, tree, 1);
+            recursiveGen(ctx, p1);
+            generateRegMem(ctx, OP_LDA,sp,-1,sp,"push prepare");
+            generateRegMem(ctx, OP_ST,ax,0,sp,"op: protect left");
+            recursiveGen(ctx, p2);
+            generateRegMem(ctx, OP_LDA,sp,1,sp,"pop prepare");
+            generateRegMem(ctx, OP_LD,bx,-1,sp,"op: recover left");
+            switch (node->payload) {
             case PLUS :
-                generateRegOnly("ADD",ax,bx,ax,"op +");
+                generateRegOnly(ctx, OP_ADD,ax,bx,ax,"op +");
                 break;
             case MINUS :
-                generateRegOnly("SUB",ax,bx,ax,"op -");
+                generateRegOnly(ctx, OP_SUB,ax,bx,ax,"op -");
                 break;
             case MULTI :
-                generateRegOnly("MUL",ax,bx,ax,"op *");
+                generateRegOnly(ctx, OP_MUL,ax,bx,ax,"op *");
                 break;
             case DIV :
-                generateRegOnly("DIV",ax,bx,ax,"op /");
+                generateRegOnly(ctx, OP_DIV,ax,bx,ax,"op /");
                 break;
             case EQ :
-                generateRegOnly("SUB",ax,bx,ax,"op ==");
-                generateRegMem("JEQ",ax,2,pc,"br if true");
-                generateRegMem("LDC",ax,0,0,"false case");
-                generateRegMem("LDA",pc,1,pc,"unconditional jmp");
-                generateRegMem("LDC",ax,1,0,"true case");
+                generateRegOnly(ctx, OP_SUB,ax,bx,ax,"op ==");
+                generateRegMem(ctx, OP_JEQ,ax,2,pc,"br if true");
+                generateRegMem(ctx, OP_LDC,ax,0,0,"false case");
+                generateRegMem(ctx, OP_LDA,pc,1,pc,"unconditional jmp");
+                generateRegMem(ctx, OP_LDC,ax,1,0,"true case");
                 break;
             case NE :
-                generateRegOnly("SUB",ax,bx,ax,"op !=");
-                generateRegMem("JNE",ax,2,pc,"br if true");
-                generateRegMem("LDC",ax,0,0,"false case");
-                generateRegMem("LDA",pc,1,pc,"unconditional jmp");
-                generateRegMem("LDC",ax,1,0,"true case");
+                generateRegOnly(ctx, OP_SUB,ax,bx,ax,"op !=");
+                generateRegMem(ctx, OP_JNE,ax,2,pc,"br if true");
+                generateRegMem(ctx, OP_LDC,ax,0,0,"false case");
+                generateRegMem(ctx, OP_LDA,pc,1,pc,"unconditional jmp");
+                generateRegMem(ctx, OP_LDC,ax,1,0,"true case");
                 break;
             case LT :
-                generateRegOnly("SUB",ax,bx,ax,"op <");
-                generateRegMem("JLT",ax,2,pc,"br if true");
-                generateRegMem("LDC",ax,0,0,"false case");
-                generateRegMem("LDA",pc,1,pc,"unconditional jmp");
-                generateRegMem("LDC",ax,1,0,"true case");
+                generateRegOnly(ctx, OP_SUB,ax,bx,ax,"op <");
+                generateRegMem(ctx, OP_JLT,ax,2,pc,"br if true");
+                generateRegMem(ctx, OP_LDC,ax,0,0,"false case");
+                generateRegMem(ctx, OP_LDA,pc,1,pc,"unconditional jmp");
+                generateRegMem(ctx, OP_LDC,ax,1,0,"true case");
                 break;
             case GT :
-                generateRegOnly("SUB",ax,bx,ax,"op >");
-                generateRegMem("JGT",ax,2,pc,"br if true");
-                generateRegMem("LDC",ax,0,0,"false case");
-                generateRegMem("LDA",pc,1,pc,"unconditional jmp");
-                generateRegMem("LDC",ax,1,0,"true case");
+                generateRegOnly(ctx, OP_SUB,ax,bx,ax,"op >");
+                generateRegMem(ctx, OP_JGT,ax,2,pc,"br if true");
+                generateRegMem(ctx, OP_LDC,ax,0,0,"false case");
+                generateRegMem(ctx, OP_LDA,pc,1,pc,"unconditional jmp");
+                generateRegMem(ctx, OP_LDC,ax,1,0,"true case");
                 break;
             case LE :
-                generateRegOnly("SUB",ax,bx,ax,"op <=");
-                generateRegMem("JLE",ax,2,pc,"br if true");
-                generateRegMem("LDC",ax,0,0,"false case");
-                generateRegMem("LDA",pc,1,pc,"unconditional jmp");
-                generateRegMem("LDC",ax,1,0,"true case");
+                generateRegOnly(ctx, OP_SUB,ax,bx,ax,"op <=");
+                generateRegMem(ctx, OP_JLE,ax,2,pc,"br if true");
+                generateRegMem(ctx, OP_LDC,ax,0,0,"false case");
+                generateRegMem(ctx, OP_LDA,pc,1,pc,"unconditional jmp");
+                generateRegMem(ctx, OP_LDC,ax,1,0,"true case");
                 break;
             case GE :
-                generateRegOnly("SUB",ax,bx,ax,"op >=");
-                generateRegMem("JGE",ax,2,pc,"br if true");
-                generateRegMem("LDC",ax,0,0,"false case");
-                generateRegMem("LDA",pc,1,pc,"unconditional jmp");
-                generateRegMem("LDC",ax,1,0,"true case");
+                generateRegOnly(ctx, OP_SUB,ax,bx,ax,"op >=");
+                generateRegMem(ctx, OP_JGE,ax,2,pc,"br if true");
+                generateRegMem(ctx, OP_LDC,ax,0,0,"false case");
+                generateRegMem(ctx, OP_LDA,pc,1,pc,"unconditional jmp");
+                generateRegMem(ctx, OP_LDC,ax,1,0,"true case");
                 break;
             default:
-                generateComment("BUG: Unknown operator");
+                generateComment(ctx, "BUG: Unknown operator");
                 break;
             }
             if (TraceCode)
-                generateComment("<- op");
+                generateComment(ctx, "<- op");
             break;
 
         case CALL_AST:
             if (TraceCode)
-                generateComment("-> call");
-            p1 = tree->child[0];
-            while(p1 != NULL) {
-                pushParam(p1);
-                p1 = p1->sibling;
+                generateComment(ctx, "-> call");
+            p1 = CHILD(ctx, tree, 0);
+            while(p1 != NO_NODE) {
+                pushParam(ctx, p1);
+                p1 = NODE(ctx, p1)->sibling;
             }
-            isRecursive = 0;
-            while((p1 = popParam()) != NULL) {
-                recursiveGen(p1);
-                generateRegMem("LDA",sp,-1,sp,"push prepare");
-                generateRegMem("ST",ax,0,sp,"push parameters");
+            ctx->isRecursive = 0;
+            while((p1 = popParam(ctx)) != NO_NODE) {
+                recursiveGen(ctx, p1);
+                generateRegMem(ctx, OP_LDA,sp,-1,sp,"push prepare");
+                generateRegMem(ctx, OP_ST,ax,0,sp,"push parameters");
             }
-            isRecursive = 1;
-            fun = getFunction(tree->attr.name);
-            generateFunCall(fun);
+            ctx->isRecursive = 1;
+            fun = getFunction(ctx, NODE_NAME(ctx, tree));
+            generateFunCall(ctx, fun);
             if (TraceCode)
-                generateComment("<- call");
+                generateComment(ctx, "<- call");
 
             break;
             default:
             break;
         }
 
-        if(isRecursive) {
-            tree = tree->sibling;
+        if(ctx->isRecursive) {
+            tree = node->sibling;
         } else {
             break;
         }
@@ -447,17 +692,73 @@ void recursiveGen(TreeNode *tree) {
 }
 
 
-void generateCode() {
+void generateCode(CompilerContext *ctx) {
+
+    generatePrelude(ctx);
+    if (TraceCode)
+        generateComment(ctx, "Jump to main()");
+    int loc = generateSkip(ctx, 6);
+    generateInput(ctx);
+    generateOutput(ctx);
+    recursiveGen(ctx, TREE_ROOT(ctx));
+    generateRewind(ctx, loc);
+    FunSymbol *fun = getFunction(ctx, internName(ctx, "main"));
+    generateFunCall(ctx, fun);
+    generateRegOnly(ctx, OP_HALT,0,0,0,"END OF PROGRAM");
+    writeCode(ctx);
+}
+
+
+void beginStreamingCode(CompilerContext *ctx) {
 
-    generatePrelude();
     if (TraceCode)
-        generateComment("Jump to main()");
-    int loc = generateSkip(6);
-    generateInput();
-    generateOutput();
-    recursiveGen(ASTRoot);
-    generateRewind(loc);
-    FunSymbol *fun = getFunction("main");
-    generateFunCall(fun);
-    generateRegOnly("HALT",0,0,0,"END OF PROGRAM");
+        generateComment(ctx, "Begin prelude");
+    generateRegMem(ctx, OP_LD,gp,0,zero,"load from location 0");
+    generateRegMem(ctx, OP_ST,zero,0,zero,"clear location 0");
+    ctx->preludeLoc = generateSkip(ctx, 1);
+    if (TraceCode)
+        generateComment(ctx, "End of prelude");
+    if (TraceCode)
+        generateComment(ctx, "Jump to main()");
+    ctx->mainCallLoc = generateSkip(ctx, 6);
+    generateInput(ctx);
+    generateOutput(ctx);
+    /* Everything so far is written at the end, after the backpatches;
+     * each function is written as soon as it is generated. */
+    ctx->heldLocs = ctx->codeBase = ctx->highEmitLoc;
+}
+
+
+void streamDeclaration(CompilerContext *ctx, int dec) {
+
+    if(!ctx->streaming)
+        return;
+    analyzeDeclaration(ctx, dec);
+    if(ctx->AST == TRUE) {
+        timerStart(ctx, PHASE_OUTPUT);
+        printAST(ctx, dec, 0);
+        timerStop(ctx);
+    }
+    if(NODE(ctx, dec)->astType == FUNDEC_AST) {
+        timerStart(ctx, PHASE_CODEGEN);
+        recursiveGen(ctx, dec);
+        timerStop(ctx);
+        flushCode(ctx);
+    }
+    /* Nothing of the declaration is needed any more, and nothing of
+     * the next one has been made yet. */
+    resetCompactTree(&ctx->compact);
+    resetArena(&ctx->scopeArena);
+}
+
+
+void finishStreamingCode(CompilerContext *ctx) {
+
+    generateRewind(ctx, ctx->preludeLoc);
+    generateRegMem(ctx, OP_LDA,sp,-(topTable(ctx)->size),gp,"allocate for global variables");
+    generateRewind(ctx, ctx->mainCallLoc);
+    FunSymbol *fun = getFunction(ctx, internName(ctx, "main"));
+    generateFunCall(ctx, fun);
+    generateRegOnly(ctx, OP_HALT,0,0,0,"END OF PROGRAM");
+    writeCode(ctx);
 }
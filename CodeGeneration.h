@@ -22,110 +22,170 @@
 
 /*********************************************************************
  * FUNCTION NAME: generateComment
- * PURPOSE: Generates a comment line in assembly
- * ARGUMENTS: The comment to be generated (char *) 
+ * PURPOSE: Records a comment line, to be written before the
+ *          instruction at the current location
+ * ARGUMENTS: . The compilation context (CompilerContext *)
+ *            . The comment to be generated (char *) 
  *********************************************************************/
-void generateComment(char *c);
+void generateComment(CompilerContext *ctx, char *c);
 
 
 /*********************************************************************
  * FUNCTION NAME: generateRegOnly
- * PURPOSE: Generates a register line in assembly
- * ARGUMENTS: . The operation (char *) 
+ * PURPOSE: Stores a register-only instruction at the current
+ *          location
+ * ARGUMENTS: . The compilation context (CompilerContext *)
+ *            . The operation (Opcode)
  *            . The location of the register in memory (int)
  *            . The initial value of the register (int)
  *            . The offset of the register (int)
  *            . The name of the register (char *)
  *********************************************************************/
-void generateRegOnly(char *op, int r, int s, int t, char *c);
+void generateRegOnly(CompilerContext *ctx, Opcode op, int r, int s, int t, char *c);
 
 
 /*********************************************************************
  * FUNCTION NAME: generateRegMem
- * PURPOSE: Generates a register line in memory
- * ARGUMENTS: . The operation (char *) 
+ * PURPOSE: Stores a register-memory instruction at the current
+ *          location
+ * ARGUMENTS: . The compilation context (CompilerContext *)
+ *            . The operation (Opcode)
  *            . The location of the register in memory (int)
  *            . The initial value of the register (int)
  *            . The offset of the register (int)
  *            . The name of the register (char *)
  *********************************************************************/
-void generateRegMem(char *op, int r, int d, int s, char *c);
+void generateRegMem(CompilerContext *ctx, Opcode op, int r, int d, int s, char *c);
+
+
+/*********************************************************************
+ * FUNCTION NAME: writeCode
+ * PURPOSE: Writes the stored instructions, in location order, with a
+ *          single write to the code file. In streaming mode, only
+ *          the held locations and those not yet flushed are left,
+ *          and the held ones are written first
+ * ARGUMENTS: The compilation context (CompilerContext *)
+ *********************************************************************/
+void writeCode(CompilerContext *ctx);
 
 
 /*********************************************************************
  * FUNCTION NAME: generateSkip
  * PURPOSE: Generates skips in assembly
- * ARGUMENTS: The amount of skips (int)
+ * ARGUMENTS: . The compilation context (CompilerContext *)
+ *            . The amount of skips (int)
  *********************************************************************/
-int generateSkip(int howMany);
+int generateSkip(CompilerContext *ctx, int howMany);
 
 
 /*********************************************************************
  * FUNCTION NAME: generateRewind
  * PURPOSE: Generates a rewind line in assembly
- * ARGUMENTS: The location in memory to rewind to (int) 
+ * ARGUMENTS: . The compilation context (CompilerContext *)
+ *            . The location in memory to rewind to (int) 
  *********************************************************************/
-void generateRewind(int loc);
+void generateRewind(CompilerContext *ctx, int loc);
 
 
 /*********************************************************************
  * FUNCTION NAME: generateRestore
  * PURPOSE: Generates a restore in assembly
+ * ARGUMENTS: The compilation context (CompilerContext *)
  *********************************************************************/
-void generateRestore(void);
+void generateRestore(CompilerContext *ctx);
 
 
 /*********************************************************************
  * FUNCTION NAME: generatePrelude
  * PURPOSE: Generates a prelude line in assembly
+ * ARGUMENTS: The compilation context (CompilerContext *)
  *********************************************************************/
-void generatePrelude();
+void generatePrelude(CompilerContext *ctx);
 
 
 /*********************************************************************
  * FUNCTION NAME: generateInput
  * PURPOSE: Generates an input line in assembly
+ * ARGUMENTS: The compilation context (CompilerContext *)
  *********************************************************************/
-void generateInput();
+void generateInput(CompilerContext *ctx);
 
 
 /*********************************************************************
  * FUNCTION NAME: generateOutput
  * PURPOSE: Generates an output line in assembly
+ * ARGUMENTS: The compilation context (CompilerContext *)
  *********************************************************************/
-void generateOutput();
+void generateOutput(CompilerContext *ctx);
 
 
 /*********************************************************************
  * FUNCTION NAME: generateGetAddr
  * PURPOSE: Generates a load address command in assembly
- * ARGUMENTS: The variable address to load (VarSymbol *) 
+ * ARGUMENTS: . The compilation context (CompilerContext *)
+ *            . The variable address to load (VarSymbol *) 
  *********************************************************************/
-void generateGetAddr(VarSymbol *var);
+void generateGetAddr(CompilerContext *ctx, VarSymbol *var);
 
 
 /*********************************************************************
  * FUNCTION NAME: generateFunCall
  * PURPOSE: Generates a series of assembly lines simulating a function
  *          call
- * ARGUMENTS: The function to call (FunSymbol *) 
+ * ARGUMENTS: . The compilation context (CompilerContext *)
+ *            . The function to call (FunSymbol *) 
  *********************************************************************/
-void generateFunCall(FunSymbol *fun);
+void generateFunCall(CompilerContext *ctx, FunSymbol *fun);
 
 
 /*********************************************************************
  * FUNCTION NAME: recursiveGen
  * PURPOSE: Recursively generates assembly code given a syntax tree
- * ARGUMENTS: The syntax tree to be generated (TreeNode *) 
+ * ARGUMENTS: . The compilation context (CompilerContext *)
+ *            . The index of the compact tree node to generate, or
+ *              NO_NODE (int)
  *********************************************************************/
-void recursiveGen(TreeNode *tree);
+void recursiveGen(CompilerContext *ctx, int tree);
 
 
 /*********************************************************************
  * FUNCTION NAME: generateCode
  * PURPOSE: The main driver function for assembly code generation
+ * ARGUMENTS: The compilation context (CompilerContext *)
+ *********************************************************************/
+void generateCode(CompilerContext *ctx);
+
+
+/*********************************************************************
+ * FUNCTION NAME: beginStreamingCode
+ * PURPOSE: Generates everything that precedes the first function,
+ *          leaving room for the global allocation and the call to
+ *          main, which are not known until the whole file is parsed.
+ *          This code is held back and written last
+ * ARGUMENTS: The compilation context (CompilerContext *)
+ *********************************************************************/
+void beginStreamingCode(CompilerContext *ctx);
+
+
+/*********************************************************************
+ * FUNCTION NAME: streamDeclaration
+ * PURPOSE: In streaming mode, analyzes, prints and generates a top
+ *          level declaration as soon as it is added to the compact tree,
+ *          writes its code, then releases it, its code and its local
+ *          symbol tables
+ * ARGUMENTS: . The compilation context (CompilerContext *)
+ *            . The index of the declaration (int)
+ *********************************************************************/
+void streamDeclaration(CompilerContext *ctx, int dec);
+
+
+/*********************************************************************
+ * FUNCTION NAME: finishStreamingCode
+ * PURPOSE: Backpatches the global allocation and the call to main,
+ *          then writes the code
+ * ARGUMENTS: The compilation context (CompilerContext *)
  *********************************************************************/
-void generateCode();
+void finishStreamingCode(CompilerContext *ctx);
 
 
 #endif
\ No newline at end of file
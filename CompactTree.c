@@ -0,0 +1,260 @@
+/*********************************************************************
+ * FILE NAME: CompactTree.c
+ * AUTHOR: Andrew O'Donohue
+ * PURPOSE: Flattens the parser's syntax tree into the compact tree
+ *          that code generation reads, and prints it. Each declaration
+ *          is copied in preorder as soon as it is parsed, so walking
+ *          the tree reads its nodes in the order they are stored.
+ *********************************************************************/
+#include "globals.h"
+#include "Atom.h"
+#include "Memory.h"
+#include "CompactTree.h"
+
+/* The children each kind of node has, whether or not they are NULL. */
+static const unsigned char childCounts[] = {
+    [TYPE_AST] = 0, [VARDEC_AST] = 1, [ARRAYDEC_AST] = 1, [FUNDEC_AST] = 2,
+    [FUNHEAD_AST] = 2, [PARAMID_AST] = 1, [PARAMARRAY_AST] = 1,
+    [COMPOUND_AST] = 2,
+    [EXPSTMT_AST] = 1, [SELESTMT_AST] = 3, [ITERSTMT_AST] = 2, [RETSTMT_AST] = 1,
+    [ASSIGN_AST] = 2,
+    [EXP_AST] = 2, [VAR_AST] = 0, [ARRAYVAR_AST] = 1,
+    [FACTOR_AST] = 1,
+    [CALL_AST] = 1, [NUM_AST] = 0
+};
+
+
+/*********************************************************************
+ * FUNCTION NAME: reserve
+ * PURPOSE: Makes room in one of the arrays of a compact tree
+ * ARGUMENTS: . The array (void **)
+ *            . Its capacity in elements (int *)
+ *            . The number of elements it must hold (int)
+ *            . The size of an element (size_t)
+ *********************************************************************/
+static void reserve(void **array, int *cap, int need, size_t size) {
+
+    if(need <= *cap)
+        return;
+    *cap = *cap * 2 > need ? *cap * 2 : need + 256;
+    *array = realloc(*array, *cap * size);
+    ASSERT(*array != NULL) {
+        fprintf(stderr, "Failed to malloc for compact tree.\n");
+    }
+}
+
+
+/*********************************************************************
+ * FUNCTION NAME: copyNode
+ * PURPOSE: Appends one node of the parser's tree to the compact tree,
+ *          with its child slots still to be filled
+ * ARGUMENTS: . The compilation context (CompilerContext *)
+ *            . The node (TreeNode *)
+ * RETURNS: The index of the copy (int)
+ *********************************************************************/
+static int copyNode(CompilerContext *ctx, TreeNode *node) {
+
+    CompactTree *tree = &ctx->compact;
+    int slots = childCounts[node->astType] + (node->astType == ARRAYDEC_AST);
+    CompactNode *copy;
+
+    reserve((void **)&tree->nodes, &tree->cap, tree->count + 1, sizeof(CompactNode));
+    reserve((void **)&tree->slots, &tree->slotCap, tree->slotCount + slots, sizeof(int));
+    ctx->memory.count[MEM_COMPACTNODE]++;
+    ctx->memory.bytes[MEM_COMPACTNODE] += sizeof(CompactNode) + slots * sizeof(int);
+
+    copy = &tree->nodes[tree->count];
+    copy->astType = node->astType;
+    copy->type = node->type;
+    copy->offset = node->offset;
+    copy->children = tree->slotCount;
+    copy->sibling = NO_NODE;
+    tree->slotCount += slots;
+
+    switch(node->astType) {
+    case EXP_AST:
+        copy->payload = node->attr.op;
+        break;
+    case NUM_AST:
+        copy->payload = node->attr.value;
+        break;
+    case COMPOUND_AST:
+        /* The semantic pass gives a function body its table. */
+        copy->payload = NO_NODE;
+        break;
+    case ARRAYDEC_AST:
+        /* The size goes in the extra slot and the name is the payload,
+         * as for any other named node. */
+        tree->slots[copy->children + 1] = node->attr.value;
+        /* fall through */
+    default:
+        copy->payload = node->attr.name != NULL ? ATOM(node->attr.name)->id : NO_NODE;
+        if(copy->payload != NO_NODE) {
+            reserve((void **)&tree->names, &tree->nameCap, copy->payload + 1, sizeof(char *));
+            tree->names[copy->payload] = node->attr.name;
+        }
+        break;
+    }
+    return tree->count++;
+}
+
+
+/*********************************************************************
+ * FUNCTION NAME: copyList
+ * PURPOSE: Appends a list of siblings and their subtrees to the
+ *          compact tree in preorder. Siblings are walked in a loop, so
+ *          only nesting costs stack
+ * ARGUMENTS: . The compilation context (CompilerContext *)
+ *            . The first node of the list, or NULL (TreeNode *)
+ * RETURNS: The index of the first copy, or NO_NODE (int)
+ *********************************************************************/
+static int copyList(CompilerContext *ctx, TreeNode *node) {
+
+    CompactTree *tree = &ctx->compact;
+    int first = NO_NODE, prev = NO_NODE, index, i, n;
+
+    for(; node != NULL; node = node->sibling) {
+        index = copyNode(ctx, node);
+        if(prev == NO_NODE)
+            first = index;
+        else
+            tree->nodes[prev].sibling = index;
+        prev = index;
+        n = childCounts[node->astType];
+        for(i=0; i<n; ++i) {
+            int child = copyList(ctx, node->child[i]);
+            tree->slots[tree->nodes[index].children + i] = child;
+        }
+    }
+    return first;
+}
+
+
+/*********************************************************************
+ * FUNCTION NAME: printNodeKind
+ * PURPOSE: Prints what kind of node a node is
+ * ARGUMENTS: . The compilation context (CompilerContext *)
+ *            . The kind of node (ASTType)
+ *********************************************************************/
+static void printNodeKind(CompilerContext *ctx, ASTType astType) {
+
+    switch(astType) {
+    case VARDEC_AST:
+        fprintf(ctx->listing, "Var declaration \n");
+        break;
+    case ARRAYDEC_AST:
+        fprintf(ctx->listing, "Array declaration \n");
+        break;
+    case FUNDEC_AST:
+        fprintf(ctx->listing, "Function declaration \n");
+        break;
+    case TYPE_AST:
+        fprintf(ctx->listing, "Type specifier \n");
+        break;
+    case PARAMID_AST:
+        fprintf(ctx->listing, "Param of ID \n");
+        break;
+    case PARAMARRAY_AST:
+        fprintf(ctx->listing, "Param of Array \n");
+        break;
+    case COMPOUND_AST:
+        fprintf(ctx->listing, "Counpound statements \n");
+        break;
+    case EXPSTMT_AST:
+        fprintf(ctx->listing, "Expression statement\n");
+        break;
+    case SELESTMT_AST:
+        fprintf(ctx->listing, "Select statement\n");
+        break;
+    case ITERSTMT_AST:
+        fprintf(ctx->listing, "Iteration statement\n");
+        break;
+    case RETSTMT_AST:
+        fprintf(ctx->listing, "Return statement\n");
+        break;
+    case ASSIGN_AST:
+        fprintf(ctx->listing, "Assign statement\n");
+        break;
+    case EXP_AST:
+        fprintf(ctx->listing, "Expression \n");
+        break;
+    case VAR_AST:
+        fprintf(ctx->listing, "Var \n");
+        break;
+    case ARRAYVAR_AST:
+        fprintf(ctx->listing, "Array var ASt\n");
+        break;
+    case FACTOR_AST:
+        fprintf(ctx->listing, "Factor \n");
+        break;
+    case CALL_AST:
+        fprintf(ctx->listing, "Call stement \n");
+        break;
+    case NUM_AST:
+        fprintf(ctx->listing, "Number \n");
+        break;
+    default:
+    	break;
+    }
+}
+
+
+void printAST(CompilerContext *ctx, int root, int indent) {
+	int i;
+
+    int node = root;
+    while(node != NO_NODE) {
+        for (i = 0; i<indent; ++i) {
+            fprintf(ctx->listing, "  ");
+        }
+        printNodeKind(ctx, NODE(ctx, node)->astType);
+        for (i = 0; i<childCounts[NODE(ctx, node)->astType]; ++i) {
+            printAST(ctx, CHILD(ctx, node, i), indent+4);
+        }
+        node = NODE(ctx, node)->sibling;
+    }
+}
+
+
+int addDeclaration(CompilerContext *ctx, TreeNode *dec) {
+
+    CompactTree *tree = &ctx->compact;
+    int last = tree->count > 0 ? tree->last : NO_NODE;
+    int index = copyList(ctx, dec);
+
+    if(last != NO_NODE)
+        tree->nodes[last].sibling = index;
+    tree->last = index;
+    /* Nothing of the declaration is read from the parser's tree any
+     * more, and nothing of the next one has been made yet. */
+    resetArena(&ctx->treeArena);
+    return index;
+}
+
+
+int addTable(CompilerContext *ctx, SymbolTable *table) {
+
+    CompactTree *tree = &ctx->compact;
+
+    reserve((void **)&tree->tables, &tree->tableCap, tree->tableCount + 1, sizeof(SymbolTable *));
+    tree->tables[tree->tableCount] = table;
+    return tree->tableCount++;
+}
+
+
+void resetCompactTree(CompactTree *tree) {
+
+    tree->count = 0;
+    tree->slotCount = 0;
+    tree->tableCount = 0;
+}
+
+
+void freeCompactTree(CompactTree *tree) {
+
+    free(tree->nodes);
+    free(tree->slots);
+    free(tree->tables);
+    free(tree->names);
+    memset(tree, 0, sizeof(CompactTree));
+}
@@ -0,0 +1,70 @@
+/*********************************************************************
+ * FILE NAME: CompactTree.h
+ * AUTHOR: Andrew O'Donohue
+ * PURPOSE: CompactTree.c public interface.
+ *********************************************************************/
+#ifndef COMPACTTREE_H
+#define COMPACTTREE_H
+
+#include "globals.h"
+
+/* The node at an index of the compilation's compact tree, the index of
+ * its kth child, and the name of a node that has one. */
+#define NODE(ctx, i) (&(ctx)->compact.nodes[i])
+#define CHILD(ctx, i, k) ((ctx)->compact.slots[NODE(ctx, i)->children + (k)])
+#define NODE_NAME(ctx, i) ((ctx)->compact.names[NODE(ctx, i)->payload])
+
+/* The first declaration, whose siblings are the rest of them. */
+#define TREE_ROOT(ctx) ((ctx)->compact.count > 0 ? 0 : NO_NODE)
+
+
+/*********************************************************************
+ * FUNCTION NAME: addDeclaration
+ * PURPOSE: Appends a parsed declaration to the compact tree in
+ *          preorder, after the declarations already there, and
+ *          releases the parser's tree of it
+ * ARGUMENTS: . The compilation context (CompilerContext *)
+ *            . The declaration (TreeNode *)
+ * RETURNS: The index of the declaration (int)
+ *********************************************************************/
+int addDeclaration(CompilerContext *ctx, TreeNode *dec);
+
+
+/*********************************************************************
+ * FUNCTION NAME: printAST
+ * PURPOSE: Prints a syntax tree to stdout
+ * ARGUMENTS: . The compilation context (CompilerContext *)
+ *            . The index of the root of the tree to print, or
+ *              NO_NODE (int)
+ *            . The size of the indents in number of spaces (int)
+ *********************************************************************/
+void printAST(CompilerContext *ctx, int root, int indent);
+
+
+/*********************************************************************
+ * FUNCTION NAME: addTable
+ * PURPOSE: Adds a symbol table to those the compact tree refers to
+ * ARGUMENTS: . The compilation context (CompilerContext *)
+ *            . The table (SymbolTable *)
+ * RETURNS: The index of the table, for a COMPOUND_AST payload (int)
+ *********************************************************************/
+int addTable(CompilerContext *ctx, SymbolTable *table);
+
+
+/*********************************************************************
+ * FUNCTION NAME: resetCompactTree
+ * PURPOSE: Empties a compact tree, keeping its arrays for reuse
+ * ARGUMENTS: The tree (CompactTree *)
+ *********************************************************************/
+void resetCompactTree(CompactTree *tree);
+
+
+/*********************************************************************
+ * FUNCTION NAME: freeCompactTree
+ * PURPOSE: Frees the arrays of a compact tree
+ * ARGUMENTS: The tree (CompactTree *)
+ *********************************************************************/
+void freeCompactTree(CompactTree *tree);
+
+
+#endif
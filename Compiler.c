@@ -0,0 +1,534 @@
+/*********************************************************************
+ * FILE NAME: Compiler.c
+ * AUTHOR: Andrew O'Donohue
+ * PURPOSE: Functions to create and run a compilation context.
+ *********************************************************************/
+#include <unistd.h>
+#include <limits.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "globals.h"
+#include "parse.h"
+#include "SymbolTable.h"
+#include "SyntaxTree.h"
+#include "CodeGeneration.h"
+#include "CompactTree.h"
+#include "SemanticAnalysis.h"
+#include "Timer.h"
+#include "Memory.h"
+#include "Cache.h"
+#include "Atom.h"
+#include "Tokens.h"
+#include "Location.h"
+#include "Constant.h"
+#include "Compiler.h"
+
+int yylex_init_extra(CompilerContext *ctx, void **scanner);
+int yylex_destroy(void *scanner);
+void yyset_out(FILE *out_str, void *scanner);
+struct yy_buffer_state *yy_scan_bytes(const char *bytes, int len, void *scanner);
+struct yy_buffer_state *yy_scan_buffer(char *base, size_t size, void *scanner);
+void yy_delete_buffer(struct yy_buffer_state *buffer, void *scanner);
+
+
+CompilerContext *newCompilerContext(FILE *listing) {
+
+    CompilerContext *ctx = (CompilerContext *)calloc(1, sizeof(CompilerContext));
+    ASSERT(ctx != NULL) {
+        fprintf(stderr, "Failed to malloc for CompilerContext.\n");
+    }
+    ASSERT(yylex_init_extra(ctx, &ctx->scanner) == 0) {
+        fprintf(stderr, "Failed to create scanner.\n");
+    }
+    ctx->listing = listing;
+    yyset_out(listing, ctx->scanner);
+    ctx->diagnostics = stderr;
+    ctx->useMmap = TRUE;
+    ctx->checkSemantics = TRUE;
+    ctx->analyze = TRUE;
+    pthread_mutex_init(&ctx->internLock, NULL);
+    ctx->current_scope = GLOBAL;
+    ctx->visibleGlobals = INT_MAX;
+    ctx->visibleFuns = INT_MAX;
+    ctx->getValue = 1;
+    ctx->isRecursive = 1;
+    initTable(ctx);
+
+    return ctx;
+}
+
+
+void freeCompilerContext(CompilerContext *ctx) {
+
+    if(ctx == NULL)
+        return;
+    yylex_destroy(ctx->scanner);
+    free(ctx->instructions);
+    free(ctx->comments);
+    freeTokens(&ctx->tokens);
+    free(ctx->strayOffsets);
+    freeLines(ctx);
+    freeArena(&ctx->treeArena);
+    freeArena(&ctx->scopeArena);
+    freeCompactTree(&ctx->compact);
+    freeArena(&ctx->symbolArena);
+    freeAtoms(ctx);
+    freeConstants(ctx);
+    pthread_mutex_destroy(&ctx->internLock);
+    free(ctx);
+}
+
+
+void applyOptions(CompilerContext *ctx, const CompileOptions *options) {
+
+    ctx->AST = options->AST;
+    ctx->Table = options->Table;
+    ctx->Assembly = options->Assembly;
+    ctx->streaming = options->stream && options->Assembly;
+    ctx->useMmap = !options->noMmap;
+    ctx->checkSemantics = !options->noSemanticCheck;
+    ctx->tokenMode = options->tokens;
+    ctx->lexThreads = options->lexThreads;
+    ctx->semanticThreads = options->semanticThreads;
+    ctx->timer.enabled = options->timeReport != REPORT_NONE;
+    ctx->cache = options->cache;
+}
+
+
+/*********************************************************************
+ * FUNCTION NAME: runParser
+ * PURPOSE: Parses the scanner's current input. With -ftokens=array
+ *          the whole input is tokenized first and the parser reads
+ *          the stored tokens; -ftokens=parallel tokenizes pieces of
+ *          it on several threads, and an incremental session scans
+ *          only what was edited. With -ftokens=pipeline it is
+ *          scanned on another thread while it is parsed
+ * ARGUMENTS: . The compilation context (CompilerContext *)
+ *            . The text of the input (const char *)
+ *            . The length of the text (size_t)
+ * RETURNS: 0 if parsing succeeded, nonzero otherwise
+ *********************************************************************/
+static int runParser(CompilerContext *ctx, const char *source, size_t len) {
+
+    int status;
+
+    ctx->scanOffset = 0;
+    ctx->strays = ctx->straysShown = 0;
+    setSource(ctx, source, len);
+    if(ctx->tokenMode == TOKENS_ARRAY) {
+        timerStart(ctx, PHASE_SCAN);
+        tokenizeAll(ctx);
+        timerStop(ctx);
+    } else if(ctx->tokenMode == TOKENS_PARALLEL) {
+        timerStart(ctx, PHASE_SCAN);
+        tokenizeChunks(ctx, source, len);
+        timerStop(ctx);
+    } else if(ctx->tokenMode == TOKENS_INCREMENTAL) {
+        timerStart(ctx, PHASE_SCAN);
+        relexTokens(ctx, len);
+        timerStop(ctx);
+    } else if(ctx->tokenMode == TOKENS_PIPELINE)
+        startPipeline(ctx);
+    timerStart(ctx, PHASE_PARSE);
+    status = yyparse(ctx->scanner, ctx);
+    timerStop(ctx);
+    stopPipeline(ctx);
+    return status;
+}
+
+
+int parseFile(CompilerContext *ctx, FILE *source) {
+
+    char chunk[BUFSIZ], *src;
+    size_t len, n;
+    int status;
+
+    /* Tokens and nodes keep offsets into the source, which diagnostics
+     * turn into lines, so it must be in memory as a whole. */
+    FILE *buffer = open_memstream(&src, &len);
+    while((n = fread(chunk, 1, sizeof(chunk), source)) > 0)
+        fwrite(chunk, 1, n, buffer);
+    fclose(buffer);
+    status = parseBytes(ctx, src, len);
+    free(src);
+    return status;
+}
+
+
+/*********************************************************************
+ * FUNCTION NAME: parseScannerBuffer
+ * PURPOSE: Parses the in-memory buffer the scanner was just switched
+ *          to, and deletes the buffer afterwards
+ * ARGUMENTS: . The compilation context (CompilerContext *)
+ *            . The scanner buffer (struct yy_buffer_state *)
+ *            . The text of the buffer (const char *)
+ *            . The length of the text (size_t)
+ * RETURNS: 0 if parsing succeeded, nonzero otherwise
+ *********************************************************************/
+static int parseScannerBuffer(CompilerContext *ctx, struct yy_buffer_state *buffer,
+                              const char *source, size_t len) {
+
+    int depth = ctx->timer.depth;
+    int status;
+
+    if(setjmp(ctx->bailout) != 0) {
+        timerUnwind(ctx, depth);
+        stopPipeline(ctx);
+        yy_delete_buffer(buffer, ctx->scanner);
+        return 1;
+    }
+    status = runParser(ctx, source, len);
+    /* Semantic errors bail out here too, while the source they point
+     * into is still held. */
+    if(status == 0 && ctx->analyze && !ctx->streaming)
+        analyzeProgram(ctx);
+    yy_delete_buffer(buffer, ctx->scanner);
+    return status;
+}
+
+
+int parseBytes(CompilerContext *ctx, const char *src, size_t len) {
+
+    struct yy_buffer_state *buffer = yy_scan_bytes(src, (int)len, ctx->scanner);
+    ASSERT(buffer != NULL) {
+        fprintf(stderr, "Failed to create scanner buffer.\n");
+    }
+    return parseScannerBuffer(ctx, buffer, src, len);
+}
+
+
+int parseBuffer(CompilerContext *ctx, char *base, size_t size) {
+
+    struct yy_buffer_state *buffer = yy_scan_buffer(base, size, ctx->scanner);
+    if(buffer == NULL) {
+        fprintf(ctx->diagnostics, "Source buffer is not terminated by two NULs.\n");
+        return 1;
+    }
+    return parseScannerBuffer(ctx, buffer, base, size - 2);
+}
+
+
+char *mapSource(FILE *source, size_t *len, size_t *mapLen) {
+
+    struct stat st;
+    if(fstat(fileno(source), &st) != 0 || !S_ISREG(st.st_mode) || st.st_size == 0)
+        return NULL;
+
+    /* Reserve zeroed pages for the file plus the two NULs, then map
+     * the file over the front of them. The tail of the file's last
+     * page reads as zeros too, so the NULs are there however the size
+     * falls against a page boundary. */
+    size_t page = (size_t)sysconf(_SC_PAGESIZE);
+    size_t size = (size_t)st.st_size;
+    size_t total = (size + 2 + page - 1) / page * page;
+    char *base = (char *)mmap(NULL, total, PROT_READ | PROT_WRITE,
+                              MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if(base == MAP_FAILED)
+        return NULL;
+    if(mmap(base, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_FIXED,
+            fileno(source), 0) == MAP_FAILED) {
+        munmap(base, total);
+        return NULL;
+    }
+    *len = size;
+    *mapLen = total;
+    return base;
+}
+
+
+void unmapSource(char *base, size_t mapLen) {
+
+    munmap(base, mapLen);
+}
+
+
+/*********************************************************************
+ * FUNCTION NAME: checkMain
+ * PURPOSE: Reports a program without a main function
+ * ARGUMENTS: The compilation context (CompilerContext *)
+ * RETURNS: 0 if main is defined, nonzero otherwise
+ *********************************************************************/
+static int checkMain(CompilerContext *ctx) {
+
+    if(getFunction(ctx, internName(ctx, "main")) == NULL) {
+        fprintf(ctx->diagnostics, "Error: function main is not defined.\n");
+        return 1;
+    }
+    return 0;
+}
+
+
+int generateAssembly(CompilerContext *ctx, FILE *code) {
+
+    if(checkMain(ctx) != 0)
+        return 1;
+    ctx->code = code;
+    timerStart(ctx, PHASE_CODEGEN);
+    generateCode(ctx);
+    timerStop(ctx);
+    ctx->code = NULL;
+    return 0;
+}
+
+
+/*********************************************************************
+ * FUNCTION NAME: startStreaming
+ * PURPOSE: In streaming mode, points code generation at its output
+ *          before parsing starts, so each function can be generated
+ *          as soon as it is parsed
+ * ARGUMENTS: . The compilation context (CompilerContext *)
+ *            . The stream the assembly is written to (FILE *)
+ *********************************************************************/
+static void startStreaming(CompilerContext *ctx, FILE *code) {
+
+    if(!ctx->streaming)
+        return;
+    ctx->code = code;
+    timerStart(ctx, PHASE_CODEGEN);
+    beginStreamingCode(ctx);
+    timerStop(ctx);
+}
+
+
+/*********************************************************************
+ * FUNCTION NAME: finishCompile
+ * PURPOSE: Prints the syntax tree and generates or, in streaming
+ *          mode, completes the assembly of a parsed program
+ * ARGUMENTS: . The compilation context (CompilerContext *)
+ *            . The stream the assembly is written to (FILE *)
+ * RETURNS: 0 on success, nonzero if main is missing
+ *********************************************************************/
+static int finishCompile(CompilerContext *ctx, FILE *code) {
+
+    int status = 0;
+
+    if(!ctx->streaming && ctx->AST == TRUE) {
+        timerStart(ctx, PHASE_OUTPUT);
+        printAST(ctx, TREE_ROOT(ctx), 0);
+        timerStop(ctx);
+    }
+    if(ctx->streaming) {
+        status = checkMain(ctx);
+        if(status == 0) {
+            timerStart(ctx, PHASE_CODEGEN);
+            finishStreamingCode(ctx);
+            timerStop(ctx);
+        }
+        ctx->code = NULL;
+    }
+    else if(ctx->Assembly)
+        status = generateAssembly(ctx, code);
+    return status;
+}
+
+
+/*********************************************************************
+ * FUNCTION NAME: codeFileName
+ * PURPOSE: Builds the name of the assembly file for a source file
+ * ARGUMENTS: The name of the source file (const char *)
+ * RETURNS: <sourcefile>.tm, which the caller frees (char *)
+ *********************************************************************/
+static char *codeFileName(const char *sourcefile) {
+
+    char *codefile = (char *)malloc(strlen(sourcefile) + strlen(".tm") + 1);
+    ASSERT(codefile != NULL) {
+        fprintf(stderr, "Failed to malloc for file name.\n");
+    }
+    strcpy(codefile, sourcefile);
+    strcat(codefile, ".tm");
+    return codefile;
+}
+
+
+/*********************************************************************
+ * FUNCTION NAME: openCodeFile
+ * PURPOSE: Opens an assembly file for writing, reporting failure
+ * ARGUMENTS: . The compilation context (CompilerContext *)
+ *            . The name of the assembly file (const char *)
+ * RETURNS: The opened file, NULL on failure (FILE *)
+ *********************************************************************/
+static FILE *openCodeFile(CompilerContext *ctx, const char *codefile) {
+
+    FILE *code = fopen(codefile, "w");
+    if(code == NULL)
+        fprintf(ctx->diagnostics, "Unable to open %s for output.\n", codefile);
+    return code;
+}
+
+
+/*********************************************************************
+ * FUNCTION NAME: writeCodeFile
+ * PURPOSE: Writes generated code to <sourcefile>.tm
+ * ARGUMENTS: . The compilation context (CompilerContext *)
+ *            . The name of the source file (const char *)
+ *            . The code (const char *)
+ *            . The length of the code (size_t)
+ * RETURNS: 0 on success, nonzero if the file cannot be written
+ *********************************************************************/
+static int writeCodeFile(CompilerContext *ctx, const char *sourcefile, const char *code, size_t len) {
+
+    char *codefile = codeFileName(sourcefile);
+    FILE *out = openCodeFile(ctx, codefile);
+    if(out == NULL) {
+        free(codefile);
+        return 1;
+    }
+    timerStart(ctx, PHASE_OUTPUT);
+    fwrite(code, 1, len, out);
+    fclose(out);
+    timerStop(ctx);
+    free(codefile);
+    return 0;
+}
+
+
+/*********************************************************************
+ * FUNCTION NAME: compileCached
+ * PURPOSE: compileFile through ctx->cache. On a hit the cached listing
+ *          and code are copied out without scanning or parsing; on a
+ *          miss the output is captured and stored if the compilation
+ *          succeeded without diagnostics
+ * ARGUMENTS: . The compilation context (CompilerContext *)
+ *            . The name of the source file (const char *)
+ * RETURNS: 0 if compilation succeeded, nonzero otherwise
+ *********************************************************************/
+static int compileCached(CompilerContext *ctx, const char *sourcefile) {
+
+    char key[CACHE_KEY_LEN];
+    char *src = NULL, *listing = NULL, *diagnostics = NULL, *code = NULL;
+    size_t len = 0, listingLen = 0, diagnosticsLen = 0, codeLen = 0;
+    char chunk[BUFSIZ];
+    size_t n;
+    int status;
+
+    size_t mapLen = 0;
+    char *mapped = NULL;
+
+    FILE *source = fopen(sourcefile, "r");
+    if(source == NULL) {
+        fprintf(ctx->diagnostics, "File %s not found.\n", sourcefile);
+        return 1;
+    }
+    if(ctx->useMmap)
+        mapped = mapSource(source, &len, &mapLen);
+    if(mapped != NULL)
+        src = mapped;
+    else {
+        FILE *buffer = open_memstream(&src, &len);
+        while((n = fread(chunk, 1, sizeof(chunk), source)) > 0)
+            fwrite(chunk, 1, n, buffer);
+        fclose(buffer);
+    }
+    fclose(source);
+
+    fprintf(ctx->listing, "\nC minus compilation: %s\n", sourcefile);
+    cacheKey(ctx, src, len, key);
+    if(cacheLookup(ctx->cache, key, &listing, &listingLen, &code, &codeLen) == 0) {
+        if(mapped != NULL)
+            unmapSource(mapped, mapLen);
+        else
+            free(src);
+        fwrite(listing, 1, listingLen, ctx->listing);
+        status = ctx->Assembly ? writeCodeFile(ctx, sourcefile, code, codeLen) : 0;
+        free(listing);
+        free(code);
+        return status;
+    }
+
+    FILE *realListing = ctx->listing;
+    FILE *realDiagnostics = ctx->diagnostics;
+    ctx->listing = open_memstream(&listing, &listingLen);
+    ctx->diagnostics = open_memstream(&diagnostics, &diagnosticsLen);
+    FILE *codeBuffer = open_memstream(&code, &codeLen);
+    ASSERT(ctx->listing != NULL && ctx->diagnostics != NULL && codeBuffer != NULL) {
+        fprintf(stderr, "Failed to open output buffers for %s.\n", sourcefile);
+    }
+    yyset_out(ctx->listing, ctx->scanner);
+
+    startStreaming(ctx, codeBuffer);
+    status = mapped != NULL ? parseBuffer(ctx, mapped, len + 2) : parseBytes(ctx, src, len);
+    if(status == 0)
+        status = finishCompile(ctx, codeBuffer);
+    ctx->code = NULL;
+    if(mapped != NULL)
+        unmapSource(mapped, mapLen);
+    else
+        free(src);
+
+    fclose(ctx->listing);
+    fclose(ctx->diagnostics);
+    fclose(codeBuffer);
+    ctx->listing = realListing;
+    ctx->diagnostics = realDiagnostics;
+    yyset_out(realListing, ctx->scanner);
+    fwrite(listing, 1, listingLen, ctx->listing);
+    fwrite(diagnostics, 1, diagnosticsLen, ctx->diagnostics);
+
+    if(status == 0 && ctx->Assembly)
+        status = writeCodeFile(ctx, sourcefile, code, codeLen);
+    if(status == 0 && diagnosticsLen == 0)
+        cacheStore(ctx->cache, key, listing, listingLen, code, codeLen);
+    free(listing);
+    free(diagnostics);
+    free(code);
+    return status;
+}
+
+
+int compileFile(CompilerContext *ctx, const char *sourcefile) {
+
+    if(ctx->cache != NULL)
+        return compileCached(ctx, sourcefile);
+
+    FILE *source = fopen(sourcefile, "r");
+    if(source == NULL) {
+        fprintf(ctx->diagnostics, "File %s not found.\n", sourcefile);
+        return 1;
+    }
+
+    fprintf(ctx->listing, "\nC minus compilation: %s\n", sourcefile);
+    char *codefile = ctx->Assembly ? codeFileName(sourcefile) : NULL;
+    FILE *code = NULL;
+    int status = 0;
+
+    /* Streaming writes code while parsing, so the file must be open
+     * first; otherwise it is only created for a program that parsed. */
+    if(ctx->streaming && (code = openCodeFile(ctx, codefile)) == NULL) {
+        fclose(source);
+        free(codefile);
+        return 1;
+    }
+    /* Regular files are scanned straight from a private mapping; pipes
+     * and terminals go through stdio. */
+    size_t len = 0, mapLen = 0;
+    char *mapped = ctx->useMmap ? mapSource(source, &len, &mapLen) : NULL;
+    startStreaming(ctx, code);
+    if(mapped != NULL) {
+        status = parseBuffer(ctx, mapped, len + 2);
+        unmapSource(mapped, mapLen);
+    }
+    else
+        status = parseFile(ctx, source);
+    fclose(source);
+    if(status == 0 && ctx->Assembly && code == NULL && (code = openCodeFile(ctx, codefile)) == NULL)
+        status = 1;
+    if(status == 0)
+        status = finishCompile(ctx, code);
+    ctx->code = NULL;
+
+    if(code != NULL) {
+        timerStart(ctx, PHASE_OUTPUT);
+        fclose(code);
+        timerStop(ctx);
+        if(status != 0 && ctx->streaming)
+            remove(codefile);
+    }
+    free(codefile);
+    return status;
+}
+
+
+void compileError(CompilerContext *ctx) {
+
+    longjmp(ctx->bailout, 1);
+}
@@ -0,0 +1,135 @@
+/*********************************************************************
+ * FILE NAME: Compiler.h
+ * AUTHOR: Andrew O'Donohue
+ * PURPOSE: Compiler.c public interface.
+ *********************************************************************/
+#ifndef COMPILER_H
+#define COMPILER_H
+
+#include "globals.h"
+
+#define CHECK(ctx, x) for(;!(x);compileError(ctx))
+
+
+/*********************************************************************
+ * FUNCTION NAME: newCompilerContext
+ * PURPOSE: Creates the state for one compilation, with its own
+ *          scanner and symbol tables holding the builtin functions.
+ *          Diagnostics go to stderr until ctx->diagnostics is changed
+ * ARGUMENTS: The stream listings are printed to (FILE *)
+ * RETURNS: The newly created context (CompilerContext *)
+ *********************************************************************/
+CompilerContext *newCompilerContext(FILE *listing);
+
+
+/*********************************************************************
+ * FUNCTION NAME: freeCompilerContext
+ * PURPOSE: Releases a compilation context and its scanner
+ * ARGUMENTS: The context to be released (CompilerContext *)
+ *********************************************************************/
+void freeCompilerContext(CompilerContext *ctx);
+
+
+/*********************************************************************
+ * FUNCTION NAME: applyOptions
+ * PURPOSE: Copies the command line options into a context
+ * ARGUMENTS: . The compilation context (CompilerContext *)
+ *            . The options to apply (const CompileOptions *)
+ *********************************************************************/
+void applyOptions(CompilerContext *ctx, const CompileOptions *options);
+
+
+/*********************************************************************
+ * FUNCTION NAME: parseFile
+ * PURPOSE: Scans and parses a source file into ctx->compact, then
+ *          runs the semantic pass over it unless ctx->streaming has
+ *          done so declaration by declaration or ctx->analyze is off
+ * ARGUMENTS: . The compilation context (CompilerContext *)
+ *            . The source file to parse (FILE *)
+ * RETURNS: 0 if parsing and analysis succeeded, nonzero otherwise
+ *********************************************************************/
+int parseFile(CompilerContext *ctx, FILE *source);
+
+
+/*********************************************************************
+ * FUNCTION NAME: parseBytes
+ * PURPOSE: Scans and parses source text held in memory into
+ *          ctx->compact and analyzes it, as parseFile does. The text
+ *          is copied, so it need not be null terminated and may be
+ *          freed afterwards
+ * ARGUMENTS: . The compilation context (CompilerContext *)
+ *            . The source text (const char *)
+ *            . The length of the source text in bytes (size_t)
+ * RETURNS: 0 if parsing and analysis succeeded, nonzero otherwise
+ *********************************************************************/
+int parseBytes(CompilerContext *ctx, const char *src, size_t len);
+
+
+/*********************************************************************
+ * FUNCTION NAME: parseBuffer
+ * PURPOSE: Scans, parses and analyzes source text as parseBytes does,
+ *          but in place, without copying it. The scanner writes into
+ *          the text while it works
+ * ARGUMENTS: . The compilation context (CompilerContext *)
+ *            . The source text followed by two NULs (char *)
+ *            . The length of the text including the NULs (size_t)
+ * RETURNS: 0 if parsing and analysis succeeded, nonzero otherwise
+ *********************************************************************/
+int parseBuffer(CompilerContext *ctx, char *base, size_t size);
+
+
+/*********************************************************************
+ * FUNCTION NAME: mapSource
+ * PURPOSE: Maps a regular source file into memory, privately and
+ *          followed by the two NULs parseBuffer needs
+ * ARGUMENTS: . The opened source file (FILE *)
+ *            . Receives the length of the source (size_t *)
+ *            . Receives the length of the mapping (size_t *)
+ * RETURNS: The mapped text, NULL for pipes, terminals, empty files or
+ *          if mapping failed (char *)
+ *********************************************************************/
+char *mapSource(FILE *source, size_t *len, size_t *mapLen);
+
+
+/*********************************************************************
+ * FUNCTION NAME: unmapSource
+ * PURPOSE: Releases a mapping made by mapSource
+ * ARGUMENTS: . The mapped text (char *)
+ *            . The length of the mapping (size_t)
+ *********************************************************************/
+void unmapSource(char *base, size_t mapLen);
+
+
+/*********************************************************************
+ * FUNCTION NAME: generateAssembly
+ * PURPOSE: Generates TM assembly for a parsed program
+ * ARGUMENTS: . The compilation context (CompilerContext *)
+ *            . The stream the assembly is written to (FILE *)
+ * RETURNS: 0 if code was generated, nonzero if main is missing
+ *********************************************************************/
+int generateAssembly(CompilerContext *ctx, FILE *code);
+
+
+/*********************************************************************
+ * FUNCTION NAME: compileFile
+ * PURPOSE: Compiles one source file, printing the listings selected
+ *          by ctx->AST and ctx->Table and writing <sourcefile>.tm
+ *          when ctx->Assembly is set. Goes through ctx->cache when
+ *          one is set
+ * ARGUMENTS: . The compilation context (CompilerContext *)
+ *            . The name of the source file (const char *)
+ * RETURNS: 0 if compilation succeeded, nonzero otherwise
+ *********************************************************************/
+int compileFile(CompilerContext *ctx, const char *sourcefile);
+
+
+/*********************************************************************
+ * FUNCTION NAME: compileError
+ * PURPOSE: Abandons the compilation after a semantic error has been
+ *          reported, returning control to parseFile
+ * ARGUMENTS: The compilation context (CompilerContext *)
+ *********************************************************************/
+void compileError(CompilerContext *ctx);
+
+
+#endif
@@ -0,0 +1,130 @@
+/*********************************************************************
+ * FILE NAME: Constant.c
+ * AUTHOR: Andrew O'Donohue
+ * PURPOSE: The constant pool. Each distinct integer literal of a
+ *          compilation is stored once, and tokens and tree nodes refer
+ *          to it by index.
+ *********************************************************************/
+#include <limits.h>
+#include "globals.h"
+#include "Constant.h"
+
+
+/*********************************************************************
+ * FUNCTION NAME: hashValue
+ * PURPOSE: Mixes the bits of a value for the pool's hash table
+ * ARGUMENTS: The value (int)
+ * RETURNS: The hash (unsigned int)
+ *********************************************************************/
+static unsigned int hashValue(int value) {
+
+    unsigned int h = (unsigned int)value * 2654435761u;
+    return h ^ (h >> 16);
+}
+
+
+/*********************************************************************
+ * FUNCTION NAME: growConstants
+ * PURPOSE: Doubles the pool and rehashes its values
+ * ARGUMENTS: The compilation context (CompilerContext *)
+ *********************************************************************/
+static void growConstants(CompilerContext *ctx) {
+
+    int cap = ctx->constantCap == 0 ? 64 : ctx->constantCap * 2;
+    int *slots = (int *)calloc(2 * cap, sizeof(int));
+    int i;
+
+    ctx->constants = (int *)realloc(ctx->constants, cap * sizeof(int));
+    ASSERT(slots != NULL && ctx->constants != NULL) {
+        fprintf(stderr, "Failed to grow constant pool.\n");
+    }
+    /* Twice as many slots as constants keeps the probes short. */
+    for(i=0; i<ctx->constantCount; ++i) {
+        unsigned int h = hashValue(ctx->constants[i]) & (2 * cap - 1);
+        while(slots[h] != 0)
+            h = (h + 1) & (2 * cap - 1);
+        slots[h] = i + 1;
+    }
+    free(ctx->constantSlots);
+    ctx->constantSlots = slots;
+    ctx->constantCap = cap;
+}
+
+
+/*********************************************************************
+ * FUNCTION NAME: addValue
+ * PURPOSE: internValue without the lock
+ * ARGUMENTS: . The compilation context (CompilerContext *)
+ *            . The value (int)
+ * RETURNS: The value's index in the pool (int)
+ *********************************************************************/
+static int addValue(CompilerContext *ctx, int value) {
+
+    unsigned int h;
+
+    if(ctx->constantCount >= ctx->constantCap)
+        growConstants(ctx);
+    h = hashValue(value) & (2 * ctx->constantCap - 1);
+    while(ctx->constantSlots[h] != 0) {
+        if(ctx->constants[ctx->constantSlots[h] - 1] == value)
+            return ctx->constantSlots[h] - 1;
+        h = (h + 1) & (2 * ctx->constantCap - 1);
+    }
+    ctx->constants[ctx->constantCount] = value;
+    ctx->constantSlots[h] = ++ctx->constantCount;
+    return ctx->constantCount - 1;
+}
+
+
+int internConstant(CompilerContext *ctx, const char *digits, size_t len) {
+
+    int value = 0;
+    size_t i;
+
+    /* The scanner has matched only digits, so each one is added in
+     * the same pass that checks the value still fits. */
+    for(i=0; i<len; ++i) {
+        int d = digits[i] - '0';
+        if(value > (INT_MAX - d) / 10)
+            return CONSTANT_OVERFLOW;
+        value = value * 10 + d;
+    }
+    return internValue(ctx, value);
+}
+
+
+int internValue(CompilerContext *ctx, int value) {
+
+    int index;
+
+    if(ctx->tokenMode != TOKENS_PIPELINE)
+        return addValue(ctx, value);
+    pthread_mutex_lock(&ctx->internLock);
+    index = addValue(ctx, value);
+    pthread_mutex_unlock(&ctx->internLock);
+    return index;
+}
+
+
+int constantValue(CompilerContext *ctx, int index) {
+
+    int value;
+
+    if(ctx->tokenMode != TOKENS_PIPELINE)
+        return ctx->constants[index];
+    pthread_mutex_lock(&ctx->internLock);
+    value = ctx->constants[index];
+    pthread_mutex_unlock(&ctx->internLock);
+    return value;
+}
+
+
+void freeConstants(CompilerContext *ctx) {
+
+    free(ctx->constants);
+    free(ctx->constantSlots);
+    ctx->constants = NULL;
+    ctx->constantSlots = NULL;
+    ctx->constantCount = 0;
+    ctx->constantCap = 0;
+}
@@ -0,0 +1,57 @@
+/*********************************************************************
+ * FILE NAME: Constant.h
+ * AUTHOR: Andrew O'Donohue
+ * PURPOSE: Constant.c public interface.
+ *********************************************************************/
+#ifndef CONSTANT_H
+#define CONSTANT_H
+
+#include "globals.h"
+
+/* The pool index given to an integer literal too large for an int. */
+#define CONSTANT_OVERFLOW (-1)
+
+
+/*********************************************************************
+ * FUNCTION NAME: internConstant
+ * PURPOSE: Converts the digits of an integer literal to its value,
+ *          checking for overflow, and finds or adds the value in the
+ *          constant pool
+ * ARGUMENTS: . The compilation context (CompilerContext *)
+ *            . The digits, not necessarily NUL terminated (const char *)
+ *            . The number of digits (size_t)
+ * RETURNS: The value's index in the pool, CONSTANT_OVERFLOW if it is
+ *          larger than INT_MAX (int)
+ *********************************************************************/
+int internConstant(CompilerContext *ctx, const char *digits, size_t len);
+
+
+/*********************************************************************
+ * FUNCTION NAME: internValue
+ * PURPOSE: Finds or adds a value in the constant pool
+ * ARGUMENTS: . The compilation context (CompilerContext *)
+ *            . The value (int)
+ * RETURNS: The value's index in the pool (int)
+ *********************************************************************/
+int internValue(CompilerContext *ctx, int value);
+
+
+/*********************************************************************
+ * FUNCTION NAME: constantValue
+ * PURPOSE: Gives the value of a constant in the pool
+ * ARGUMENTS: . The compilation context (CompilerContext *)
+ *            . The constant's index (int)
+ * RETURNS: The value (int)
+ *********************************************************************/
+int constantValue(CompilerContext *ctx, int index);
+
+
+/*********************************************************************
+ * FUNCTION NAME: freeConstants
+ * PURPOSE: Releases the constant pool
+ * ARGUMENTS: The compilation context (CompilerContext *)
+ *********************************************************************/
+void freeConstants(CompilerContext *ctx);
+
+
+#endif
@@ -0,0 +1,356 @@
+/*********************************************************************
+ * FILE NAME: HandScanner.c
+ * AUTHOR: Andrew O'Donohue
+ * PURPOSE: A direct-coded scanner for C minus. It returns the same
+ *          tokens, values and offsets as scan.l and provides the
+ *          part of the flex interface the compiler uses, so either
+ *          one can be linked in (make SCANNER=hand).
+ *********************************************************************/
+#include "globals.h"
+#include "parse.h"
+#include "Atom.h"
+#include "Constant.h"
+#include "Tokens.h"
+
+#define IS_LETTER(c) ((unsigned int)(((c) | 0x20) - 'a') < 26)
+#define IS_DIGIT(c)  ((unsigned int)((c) - '0') < 10)
+
+/* The input text is always followed by two NULs, as flex expects of
+ * yy_scan_buffer, so the scanner can look one character ahead without
+ * checking for the end. */
+struct yy_buffer_state {
+    char *base;
+    size_t len;
+    int owned;
+};
+
+typedef struct hand_scanner HandScanner;
+struct hand_scanner {
+    CompilerContext *ctx;
+    FILE *in;
+    FILE *out;
+    struct yy_buffer_state *buffer;
+    struct yy_buffer_state *fileBuffer;
+    const char *p;
+    const char *end;
+    const char *token;
+    int tokenLen;
+    char *text;
+    int textCap;
+};
+
+typedef struct keyword Keyword;
+struct keyword {
+    const char *name;
+    int len;
+    int token;
+};
+
+/* Indexed by keywordHash(), which hashes the first letter and the
+ * length and has no collisions among these six. */
+static const Keyword keywords[8] = {
+    {"void", 4, VOID}, {NULL, 0, 0}, {"return", 6, RETURN}, {"while", 5, WHILE},
+    {"if", 2, IF}, {"int", 3, INT}, {"else", 4, ELSE}, {NULL, 0, 0}
+};
+
+#define keywordHash(s, len) ((((s)[0] << 1) + (len)) & 7)
+
+void yy_delete_buffer(struct yy_buffer_state *buffer, void *scanner);
+
+
+/*********************************************************************
+ * FUNCTION NAME: setBuffer
+ * PURPOSE: Starts scanning a buffer from its beginning
+ * ARGUMENTS: . The scanner (HandScanner *)
+ *            . The buffer (struct yy_buffer_state *)
+ *********************************************************************/
+static void setBuffer(HandScanner *s, struct yy_buffer_state *buffer) {
+
+    s->buffer = buffer;
+    s->p = buffer->base;
+    s->end = buffer->base + buffer->len;
+    s->token = s->p;
+    s->tokenLen = 0;
+}
+
+
+/*********************************************************************
+ * FUNCTION NAME: newBuffer
+ * PURPOSE: Wraps text followed by two NULs in a buffer
+ * ARGUMENTS: . The text (char *)
+ *            . The length of the text without the NULs (size_t)
+ *            . Whether the buffer frees the text (int)
+ * RETURNS: The buffer (struct yy_buffer_state *)
+ *********************************************************************/
+static struct yy_buffer_state *newBuffer(char *base, size_t len, int owned) {
+
+    struct yy_buffer_state *buffer = (struct yy_buffer_state *)malloc(sizeof(struct yy_buffer_state));
+    ASSERT(buffer != NULL) {
+        fprintf(stderr, "Failed to malloc for scanner buffer.\n");
+    }
+    buffer->base = base;
+    buffer->len = len;
+    buffer->owned = owned;
+    return buffer;
+}
+
+
+/*********************************************************************
+ * FUNCTION NAME: readInput
+ * PURPOSE: Reads the whole input file given to yyrestart into a
+ *          buffer
+ * ARGUMENTS: The scanner (HandScanner *)
+ *********************************************************************/
+static void readInput(HandScanner *s) {
+
+    size_t cap = BUFSIZ, len = 0, n;
+    char *base = (char *)malloc(cap);
+
+    ASSERT(base != NULL) {
+        fprintf(stderr, "Failed to malloc for scanner input.\n");
+    }
+    while((n = fread(base + len, 1, cap - len - 2, s->in)) > 0) {
+        len += n;
+        if(cap - len - 2 == 0) {
+            cap *= 2;
+            base = (char *)realloc(base, cap);
+            ASSERT(base != NULL) {
+                fprintf(stderr, "Failed to malloc for scanner input.\n");
+            }
+        }
+    }
+    base[len] = base[len + 1] = '\0';
+    s->fileBuffer = newBuffer(base, len, TRUE);
+    s->in = NULL;
+    setBuffer(s, s->fileBuffer);
+}
+
+
+/*********************************************************************
+ * FUNCTION NAME: skipComment
+ * PURPOSE: Skips the body of a comment. An unclosed comment runs to
+ *          the end of the input
+ * ARGUMENTS: . The scanner (HandScanner *)
+ *            . The character after the opening slash and star
+ *              (const char *)
+ * RETURNS: The character after the closing star and slash
+ *          (const char *)
+ *********************************************************************/
+static const char *skipComment(HandScanner *s, const char *p) {
+
+    const char *star = p;
+
+    while((star = (const char *)memchr(star, '*', s->end - star)) != NULL) {
+        if(star[1] == '/')
+            return star + 2;
+        ++star;
+    }
+    return s->end;
+}
+
+
+int yylex(YYSTYPE *yylval, void *yyscanner) {
+
+    HandScanner *s = (HandScanner *)yyscanner;
+    const char *p, *start;
+    int token;
+
+    if(s->buffer == NULL) {
+        if(s->in == NULL)
+            return 0;
+        readInput(s);
+    }
+    p = s->p;
+    for(;;) {
+        start = p;
+        switch(*p) {
+        case '\n':
+        case ' ':
+        case '\t':
+            ++p;
+            continue;
+        case '/':
+            if(p[1] == '*') {
+                p = skipComment(s, p + 2);
+                continue;
+            }
+            token = DIV;
+            ++p;
+            break;
+        case '=':
+            token = p[1] == '=' ? EQ : ASSIGN;
+            p += p[1] == '=' ? 2 : 1;
+            break;
+        case '<':
+            token = p[1] == '=' ? LE : LT;
+            p += p[1] == '=' ? 2 : 1;
+            break;
+        case '>':
+            token = p[1] == '=' ? GE : GT;
+            p += p[1] == '=' ? 2 : 1;
+            break;
+        case '!':
+            if(p[1] == '=') {
+                token = NE;
+                p += 2;
+                break;
+            }
+            noteStray(s->ctx, p - s->buffer->base, *p);
+            ++p;
+            continue;
+        case '(': token = LBracket; ++p; break;
+        case ')': token = RBracket; ++p; break;
+        case '{': token = LBrace; ++p; break;
+        case '}': token = RBrace; ++p; break;
+        case '[': token = LSB; ++p; break;
+        case ']': token = RSB; ++p; break;
+        case ',': token = COMMA; ++p; break;
+        case ';': token = SEMI; ++p; break;
+        case '"': token = Quote; ++p; break;
+        case '+': token = PLUS; ++p; break;
+        case '-': token = MINUS; ++p; break;
+        case '*': token = MULTI; ++p; break;
+        case '\0':
+            if(p == s->end) {
+                s->p = s->token = p;
+                s->tokenLen = 0;
+                s->ctx->tokenOffset = p - s->buffer->base;
+                return 0;
+            }
+            /* A NUL inside the text is unmatched, as any other
+             * character no rule starts with. */
+            /* fall through */
+        default:
+            if(IS_LETTER(*p)) {
+                while(IS_LETTER(*p))
+                    ++p;
+                int len = p - start;
+                const Keyword *k = &keywords[keywordHash(start, len)];
+                if(k->len == len && memcmp(k->name, start, len) == 0) {
+                    token = k->token;
+                    break;
+                }
+                yylval->name = internAtom(s->ctx, start, len);
+                token = ID;
+                break;
+            }
+            if(IS_DIGIT(*p)) {
+                while(IS_DIGIT(*p))
+                    ++p;
+                yylval->value = internConstant(s->ctx, start, p - start);
+                token = NUMBER;
+                break;
+            }
+            noteStray(s->ctx, p - s->buffer->base, *p);
+            ++p;
+            continue;
+        }
+        s->p = p;
+        s->token = start;
+        s->tokenLen = p - start;
+        s->ctx->tokenOffset = start - s->buffer->base;
+        return token;
+    }
+}
+
+
+int yylex_init_extra(CompilerContext *ctx, void **scanner) {
+
+    HandScanner *s = (HandScanner *)calloc(1, sizeof(HandScanner));
+    if(s == NULL)
+        return 1;
+    s->ctx = ctx;
+    s->out = stdout;
+    *scanner = s;
+    return 0;
+}
+
+
+int yylex_destroy(void *scanner) {
+
+    HandScanner *s = (HandScanner *)scanner;
+    if(s->fileBuffer != NULL)
+        yy_delete_buffer(s->fileBuffer, s);
+    free(s->text);
+    free(s);
+    return 0;
+}
+
+
+void yyrestart(FILE *input_file, void *scanner) {
+
+    HandScanner *s = (HandScanner *)scanner;
+    if(s->fileBuffer != NULL)
+        yy_delete_buffer(s->fileBuffer, s);
+    s->in = input_file;
+    s->buffer = NULL;
+}
+
+
+struct yy_buffer_state *yy_scan_bytes(const char *bytes, int len, void *scanner) {
+
+    char *base = (char *)malloc(len + 2);
+    if(base == NULL)
+        return NULL;
+    memcpy(base, bytes, len);
+    base[len] = base[len + 1] = '\0';
+    struct yy_buffer_state *buffer = newBuffer(base, len, TRUE);
+    setBuffer((HandScanner *)scanner, buffer);
+    return buffer;
+}
+
+
+struct yy_buffer_state *yy_scan_buffer(char *base, size_t size, void *scanner) {
+
+    if(size < 2 || base[size - 2] != '\0' || base[size - 1] != '\0')
+        return NULL;
+    struct yy_buffer_state *buffer = newBuffer(base, size - 2, FALSE);
+    setBuffer((HandScanner *)scanner, buffer);
+    return buffer;
+}
+
+
+void yy_delete_buffer(struct yy_buffer_state *buffer, void *scanner) {
+
+    HandScanner *s = (HandScanner *)scanner;
+    if(buffer == NULL)
+        return;
+    if(buffer == s->buffer)
+        s->buffer = NULL;
+    if(buffer == s->fileBuffer)
+        s->fileBuffer = NULL;
+    if(buffer->owned)
+        free(buffer->base);
+    free(buffer);
+}
+
+
+void scanFrom(void *scanner, int offset) {
+
+    HandScanner *s = (HandScanner *)scanner;
+    s->p = s->token = s->buffer->base + offset;
+    s->tokenLen = 0;
+    s->ctx->scanOffset = offset;
+}
+
+
+void yyset_out(FILE *out_str, void *scanner) {
+
+    ((HandScanner *)scanner)->out = out_str;
+}
+
+
+char *yyget_text(void *scanner) {
+
+    HandScanner *s = (HandScanner *)scanner;
+    if(s->tokenLen >= s->textCap) {
+        s->textCap = s->tokenLen + 16;
+        s->text = (char *)realloc(s->text, s->textCap);
+        ASSERT(s->text != NULL) {
+            fprintf(stderr, "Failed to malloc for token text.\n");
+        }
+    }
+    memcpy(s->text, s->token, s->tokenLen);
+    s->text[s->tokenLen] = '\0';
+    return s->text;
+}
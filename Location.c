@@ -0,0 +1,70 @@
+/*********************************************************************
+ * FILE NAME: Location.c
+ * AUTHOR: Andrew O'Donohue
+ * PURPOSE: Turns the byte offsets kept in tokens and tree nodes into
+ *          lines and columns. The scanner does not count lines; the
+ *          table of line starts is built from the source only when a
+ *          diagnostic first asks for a position.
+ *********************************************************************/
+#include "globals.h"
+#include "Location.h"
+
+
+void setSource(CompilerContext *ctx, const char *source, size_t len) {
+
+    freeLines(ctx);
+    ctx->source = source;
+    ctx->sourceLen = (int)len;
+}
+
+
+void buildLines(CompilerContext *ctx) {
+
+    const char *p = ctx->source, *end = ctx->source + ctx->sourceLen;
+    int cap = 1024;
+
+    ctx->lineStarts = (int *)malloc(cap * sizeof(int));
+    ASSERT(ctx->lineStarts != NULL) {
+        fprintf(stderr, "Failed to malloc for line table.\n");
+    }
+    ctx->lineStarts[0] = 0;
+    ctx->lineCount = 1;
+    while(p != NULL && (p = (const char *)memchr(p, '\n', end - p)) != NULL) {
+        if(ctx->lineCount == cap) {
+            cap *= 2;
+            ctx->lineStarts = (int *)realloc(ctx->lineStarts, cap * sizeof(int));
+            ASSERT(ctx->lineStarts != NULL) {
+                fprintf(stderr, "Failed to malloc for line table.\n");
+            }
+        }
+        ctx->lineStarts[ctx->lineCount++] = (int)(++p - ctx->source);
+    }
+}
+
+
+char *sourcePosition(CompilerContext *ctx, int offset) {
+
+    int low = 0, high, mid;
+
+    if(ctx->lineStarts == NULL)
+        buildLines(ctx);
+    /* The last line starting at or before offset. */
+    high = ctx->lineCount - 1;
+    while(low < high) {
+        mid = (low + high + 1) / 2;
+        if(ctx->lineStarts[mid] <= offset)
+            low = mid;
+        else
+            high = mid - 1;
+    }
+    snprintf(ctx->position, sizeof(ctx->position), "%d:%d", low + 1, offset - ctx->lineStarts[low] + 1);
+    return ctx->position;
+}
+
+
+void freeLines(CompilerContext *ctx) {
+
+    free(ctx->lineStarts);
+    ctx->lineStarts = NULL;
+    ctx->lineCount = 0;
+}
@@ -0,0 +1,51 @@
+/*********************************************************************
+ * FILE NAME: Location.h
+ * AUTHOR: Andrew O'Donohue
+ * PURPOSE: Location.c public interface.
+ *********************************************************************/
+#ifndef LOCATION_H
+#define LOCATION_H
+
+#include "globals.h"
+
+
+/*********************************************************************
+ * FUNCTION NAME: setSource
+ * PURPOSE: Sets the source that offsets refer to, discarding the line
+ *          table of the one before
+ * ARGUMENTS: . The compilation context (CompilerContext *)
+ *            . The source text (const char *)
+ *            . The length of the text (size_t)
+ *********************************************************************/
+void setSource(CompilerContext *ctx, const char *source, size_t len);
+
+
+/*********************************************************************
+ * FUNCTION NAME: buildLines
+ * PURPOSE: Records the offset at which each line of the source starts.
+ *          sourcePosition does this the first time it is called
+ * ARGUMENTS: The compilation context (CompilerContext *)
+ *********************************************************************/
+void buildLines(CompilerContext *ctx);
+
+
+/*********************************************************************
+ * FUNCTION NAME: sourcePosition
+ * PURPOSE: Turns a byte offset in the source into "line:column", both
+ *          counted from 1
+ * ARGUMENTS: . The compilation context (CompilerContext *)
+ *            . The offset (int)
+ * RETURNS: The position, valid until the next call (char *)
+ *********************************************************************/
+char *sourcePosition(CompilerContext *ctx, int offset);
+
+
+/*********************************************************************
+ * FUNCTION NAME: freeLines
+ * PURPOSE: Releases the line table
+ * ARGUMENTS: The compilation context (CompilerContext *)
+ *********************************************************************/
+void freeLines(CompilerContext *ctx);
+
+
+#endif
@@ -0,0 +1,178 @@
+/*********************************************************************
+ * FILE NAME: Memory.c
+ * AUTHOR: Andrew O'Donohue
+ * PURPOSE: Arena allocation of the syntax tree, symbol tables and
+ *          identifiers, and allocation accounting for -fmem-report.
+ *********************************************************************/
+#include <sys/resource.h>
+#include "globals.h"
+#include "Memory.h"
+
+static const char *categoryNames[MEM_COUNT] = {
+    "TreeNode", "CompactNode", "SymbolTable", "VarSymbol", "FunSymbol", "identifiers"
+};
+
+static const char *categoryKeys[MEM_COUNT] = {
+    "tree_node", "compact_node", "symbol_table", "var_symbol", "fun_symbol", "identifier"
+};
+
+/* Nothing allocated from an arena needs more than pointer alignment. */
+#define ARENA_ALIGN sizeof(void *)
+#define ARENA_BLOCK (64 * 1024)
+
+struct arena_block {
+    ArenaBlock *next;
+    size_t size;
+    char data[];
+};
+
+
+/*********************************************************************
+ * FUNCTION NAME: newBlock
+ * PURPOSE: Allocates a block for an arena
+ * ARGUMENTS: The number of bytes the block holds (size_t)
+ * RETURNS: The block (ArenaBlock *)
+ *********************************************************************/
+static ArenaBlock *newBlock(size_t size) {
+
+    ArenaBlock *block = (ArenaBlock *)malloc(sizeof(ArenaBlock) + size);
+    ASSERT(block != NULL) {
+        fprintf(stderr, "Failed to malloc for arena block.\n");
+    }
+    block->size = size;
+    return block;
+}
+
+
+void *arenaAlloc(CompilerContext *ctx, Arena *arena, MemCategory category, size_t size) {
+
+    ArenaBlock *block;
+    char *p;
+
+    ctx->memory.count[category]++;
+    ctx->memory.bytes[category] += size;
+    size = (size + ARENA_ALIGN - 1) & ~(ARENA_ALIGN - 1);
+
+    /* A large request gets a block of its own behind the current one,
+     * so the space left in the current one is not wasted. */
+    if(size > ARENA_BLOCK / 4) {
+        block = newBlock(size);
+        if(arena->blocks == NULL) {
+            block->next = NULL;
+            arena->blocks = block;
+        } else {
+            block->next = arena->blocks->next;
+            arena->blocks->next = block;
+        }
+        return block->data;
+    }
+    if((size_t)(arena->end - arena->next) < size) {
+        block = newBlock(ARENA_BLOCK);
+        block->next = arena->blocks;
+        arena->blocks = block;
+        arena->next = block->data;
+        arena->end = block->data + ARENA_BLOCK;
+    }
+    p = arena->next;
+    arena->next += size;
+    return p;
+}
+
+
+void resetArena(Arena *arena) {
+
+    ArenaBlock *block, *next;
+
+    if(arena->blocks == NULL)
+        return;
+    for(block = arena->blocks->next; block != NULL; block = next) {
+        next = block->next;
+        free(block);
+    }
+    block = arena->blocks;
+    block->next = NULL;
+    arena->next = block->data;
+    arena->end = block->data + block->size;
+}
+
+
+void freeArena(Arena *arena) {
+
+    ArenaBlock *block, *next;
+
+    for(block = arena->blocks; block != NULL; block = next) {
+        next = block->next;
+        free(block);
+    }
+    arena->blocks = NULL;
+    arena->next = NULL;
+    arena->end = NULL;
+}
+
+
+void mergeArena(Arena *arena, Arena *from) {
+
+    ArenaBlock *last;
+
+    if(from->blocks == NULL)
+        return;
+    if(arena->blocks == NULL) {
+        *arena = *from;
+    } else {
+        /* Behind the current block, which is still allocated from. */
+        for(last = from->blocks; last->next != NULL; last = last->next)
+            ;
+        last->next = arena->blocks->next;
+        arena->blocks->next = from->blocks;
+    }
+    from->blocks = NULL;
+    from->next = NULL;
+    from->end = NULL;
+}
+
+
+void memAdd(MemStats *total, const MemStats *stats) {
+
+    int i;
+    for(i=0; i<MEM_COUNT; ++i) {
+        total->count[i] += stats->count[i];
+        total->bytes[i] += stats->bytes[i];
+    }
+}
+
+
+void printMemReport(FILE *out, const MemStats *stats, int files, ReportFormat format) {
+
+    struct rusage usage;
+    long count = 0, bytes = 0;
+    int i;
+
+    getrusage(RUSAGE_SELF, &usage);
+    for(i=0; i<MEM_COUNT; ++i) {
+        count += stats->count[i];
+        bytes += stats->bytes[i];
+    }
+
+    if(format == REPORT_JSON) {
+        fprintf(out, "{\"files\": %d, \"categories\": {", files);
+        for(i=0; i<MEM_COUNT; ++i) {
+            fprintf(out, "%s\"%s\": {\"allocations\": %ld, \"bytes\": %ld}",
+                    i ? ", " : "", categoryKeys[i], stats->count[i], stats->bytes[i]);
+        }
+        fprintf(out, "}, \"total\": {\"allocations\": %ld, \"bytes\": %ld}, "
+                "\"peak_rss_kb\": %ld}\n", count, bytes, usage.ru_maxrss);
+        return;
+    }
+
+    fprintf(out, "\nMemory report (%d file%s)\n", files, files == 1 ? "" : "s");
+    fprintf(out, "Category        Allocations        Bytes   Bytes %%\n");
+    fprintf(out, "-------------  ------------  -----------  --------\n");
+    for(i=0; i<MEM_COUNT; ++i) {
+        fprintf(out, "%-13s  %12ld  %11ld  %7.1f%%\n", categoryNames[i],
+                stats->count[i], stats->bytes[i],
+                bytes > 0 ? 100.0 * stats->bytes[i] / bytes : 0.0);
+    }
+    fprintf(out, "-------------  ------------  -----------  --------\n");
+    fprintf(out, "%-13s  %12ld  %11ld  %7.1f%%\n", "total", count, bytes, 100.0);
+    fprintf(out, "Peak RSS: %ld KB\n", usage.ru_maxrss);
+}
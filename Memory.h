@@ -0,0 +1,73 @@
+/*********************************************************************
+ * FILE NAME: Memory.h
+ * AUTHOR: Andrew O'Donohue
+ * PURPOSE: Memory.c public interface.
+ *********************************************************************/
+#ifndef MEMORY_H
+#define MEMORY_H
+
+#include "globals.h"
+
+
+/*********************************************************************
+ * FUNCTION NAME: arenaAlloc
+ * PURPOSE: Allocates memory from an arena of the compilation and
+ *          counts it against a category of its memory report
+ * ARGUMENTS: . The compilation context (CompilerContext *)
+ *            . The arena (Arena *)
+ *            . What the memory is for (MemCategory)
+ *            . The number of bytes (size_t)
+ * RETURNS: The allocated memory, aligned for any pointer (void *)
+ *********************************************************************/
+void *arenaAlloc(CompilerContext *ctx, Arena *arena, MemCategory category, size_t size);
+
+
+/*********************************************************************
+ * FUNCTION NAME: resetArena
+ * PURPOSE: Releases everything allocated from an arena, keeping one
+ *          block to allocate from next
+ * ARGUMENTS: The arena (Arena *)
+ *********************************************************************/
+void resetArena(Arena *arena);
+
+
+/*********************************************************************
+ * FUNCTION NAME: freeArena
+ * PURPOSE: Releases everything allocated from an arena and its blocks
+ * ARGUMENTS: The arena (Arena *)
+ *********************************************************************/
+void freeArena(Arena *arena);
+
+
+/*********************************************************************
+ * FUNCTION NAME: mergeArena
+ * PURPOSE: Moves the blocks of one arena into another, so what was
+ *          allocated from the first is released with the second
+ * ARGUMENTS: . The arena to keep (Arena *)
+ *            . The arena to empty (Arena *)
+ *********************************************************************/
+void mergeArena(Arena *arena, Arena *from);
+
+
+/*********************************************************************
+ * FUNCTION NAME: memAdd
+ * PURPOSE: Adds the allocations of one compilation to a running total
+ * ARGUMENTS: . The total (MemStats *)
+ *            . The allocations to add (const MemStats *)
+ *********************************************************************/
+void memAdd(MemStats *total, const MemStats *stats);
+
+
+/*********************************************************************
+ * FUNCTION NAME: printMemReport
+ * PURPOSE: Prints the allocations and bytes of each category and the
+ *          peak resident set size of the process
+ * ARGUMENTS: . The stream to print to (FILE *)
+ *            . The allocations to print (const MemStats *)
+ *            . The number of files compiled (int)
+ *            . REPORT_TEXT for a table or REPORT_JSON (ReportFormat)
+ *********************************************************************/
+void printMemReport(FILE *out, const MemStats *stats, int files, ReportFormat format);
+
+
+#endif
@@ -0,0 +1,676 @@
+/*********************************************************************
+ * FILE NAME: SemanticAnalysis.c
+ * AUTHOR: Andrew O'Donohue
+ * PURPOSE: The semantic pass over the compact tree. It fills the
+ *          symbol tables, resolves variables and calls, gives each
+ *          expression its type and reports the first error found.
+ *          Declarations are analyzed in source order, each one after
+ *          it has been parsed in full; with -fsemantic-threads the
+ *          function bodies are checked on a pool of threads once
+ *          every declaration has been.
+ *********************************************************************/
+#include <stdatomic.h>
+#include "globals.h"
+#include "parse.h"
+#include "SymbolTable.h"
+#include "CompactTree.h"
+#include "SemanticAnalysis.h"
+#include "Compiler.h"
+#include "Timer.h"
+#include "Location.h"
+#include "Constant.h"
+#include "Memory.h"
+
+/* The type of a node, and of its kth child. */
+#define TYPE(ctx, i) ((ExpType)NODE(ctx, i)->type)
+#define CHILD_TYPE(ctx, i, k) TYPE(ctx, CHILD(ctx, i, k))
+
+/* A function body for -fsemantic-threads, with the scope its head
+ * opened: the table of its parameters, the table its locals go in, and
+ * the size of the global scope when it was declared. */
+typedef struct body_unit BodyUnit;
+struct body_unit {
+    int body;
+    FunSymbol *fun;
+    SymbolTable *params;
+    SymbolTable *locals;
+    int globals;
+};
+
+/* The bodies of a program and the next one to take. firstError is the
+ * first body found to hold an error, or count; no body after it needs
+ * to be checked. The message of an error in the global declarations
+ * and function heads is kept in headError. */
+typedef struct body_pool BodyPool;
+struct body_pool {
+    BodyUnit *units;
+    int count;
+    int cap;
+    atomic_int next;
+    atomic_int firstError;
+    int headFailed;
+    char *headError;
+    size_t headErrorLen;
+};
+
+/* A thread of -fsemantic-threads. Its context shares the compact tree,
+ * with its names, the constants and the global tables and functions
+ * with the compilation, which it only reads, and writes only the nodes
+ * of the bodies it takes. Its locals, messages and allocation counts
+ * are its own, and are merged once every thread is done. */
+typedef struct body_checker BodyChecker;
+struct body_checker {
+    CompilerContext ctx;
+    BodyPool *pool;
+    char *diagnostics;
+    size_t diagnosticsLen;
+    int error;
+    char *message;
+    pthread_t thread;
+};
+
+static void analyzeNode(CompilerContext *ctx, int node);
+
+
+/*********************************************************************
+ * FUNCTION NAME: analyzeList
+ * PURPOSE: Analyzes a node and the siblings after it
+ * ARGUMENTS: . The compilation context (CompilerContext *)
+ *            . The first node, or NO_NODE (int)
+ *********************************************************************/
+static void analyzeList(CompilerContext *ctx, int node) {
+
+    for(; node != NO_NODE; node = NODE(ctx, node)->sibling)
+        analyzeNode(ctx, node);
+}
+
+
+/*********************************************************************
+ * FUNCTION NAME: analyzeVarDec
+ * PURPOSE: Declares a global or local variable or array, allocating
+ *          its space in the table of its scope
+ * ARGUMENTS: . The compilation context (CompilerContext *)
+ *            . The VARDEC_AST or ARRAYDEC_AST node (int)
+ *********************************************************************/
+static void analyzeVarDec(CompilerContext *ctx, int node) {
+
+    char *name = NODE_NAME(ctx, node);
+    int offset = NODE(ctx, node)->offset;
+    int isArray = NODE(ctx, node)->astType == ARRAYDEC_AST;
+    int size = 1;
+
+    if(ctx->checkSemantics) {
+        CHECK(ctx, CHILD_TYPE(ctx, node, 0) == TYPE_INTEGER) {
+            fprintf(ctx->diagnostics, "Error: @line %s, type specifier of variable %s must be int.\n", sourcePosition(ctx, offset), name);
+        }
+    }
+    if(isArray) {
+        size = CHILD(ctx, node, 1);
+        CHECK(ctx, size != CONSTANT_OVERFLOW) {
+            fprintf(ctx->diagnostics, "Error: @line %s, size of array %s out of range.\n", sourcePosition(ctx, offset), name);
+        }
+        size = constantValue(ctx, size);
+    }
+    if(ctx->current_scope == LOCAL)
+        pushTable(ctx, ctx->CompoundST);
+    if(ctx->checkSemantics) {
+        CHECK(ctx, getTopVar(ctx, name) == NULL) {
+            fprintf(ctx->diagnostics, "Error: @line %s, duplicate declarations of variable %s.\n", sourcePosition(ctx, offset), name);
+        }
+    }
+    putVariable(ctx, name, ctx->current_scope, ctx->tables->size, isArray ? TYPE_ARRAY : TYPE_INTEGER);
+    ctx->tables->size += size;
+    if(ctx->current_scope == LOCAL)
+        popTable(ctx);
+}
+
+
+/*********************************************************************
+ * FUNCTION NAME: analyzeParam
+ * PURPOSE: Declares a parameter of the function being declared
+ * ARGUMENTS: . The compilation context (CompilerContext *)
+ *            . The PARAMID_AST or PARAMARRAY_AST node (int)
+ *********************************************************************/
+static void analyzeParam(CompilerContext *ctx, int node) {
+
+    char *name = NODE_NAME(ctx, node);
+    int offset = NODE(ctx, node)->offset;
+
+    if(ctx->checkSemantics) {
+        CHECK(ctx, CHILD_TYPE(ctx, node, 0) == TYPE_INTEGER) {
+            fprintf(ctx->diagnostics, "Error: @line %s, type specifier of param %s must be int.\n", sourcePosition(ctx, offset), name);
+        }
+    }
+    pushTable(ctx, ctx->ParamST);
+    if(ctx->checkSemantics) {
+        CHECK(ctx, getTopVar(ctx, name) == NULL) {
+            fprintf(ctx->diagnostics, "Error: @line %s, duplicate declarations of variable %s.\n", sourcePosition(ctx, offset), name);
+        }
+    }
+    putVariable(ctx, name, PARAM, ctx->ParamST->size++, TYPE(ctx, node));
+    popTable(ctx);
+}
+
+
+/*********************************************************************
+ * FUNCTION NAME: analyzeFunHead
+ * PURPOSE: Declares a function and its parameters, and opens the
+ *          scope of its body
+ * ARGUMENTS: . The compilation context (CompilerContext *)
+ *            . The FUNHEAD_AST node (int)
+ *********************************************************************/
+static void analyzeFunHead(CompilerContext *ctx, int node) {
+
+    char *name = NODE_NAME(ctx, node);
+
+    analyzeList(ctx, CHILD(ctx, node, 1));
+    if(ctx->checkSemantics) {
+        CHECK(ctx, getFunction(ctx, name) == NULL) {
+            fprintf(ctx->diagnostics, "Error: @line %s, duplicate declarations of function %s.\n", sourcePosition(ctx, NODE(ctx, node)->offset), name);
+        }
+    }
+    if (ctx->Table)
+    	fprintf(ctx->listing, "Symbol table of function: %s\n", name);
+
+    putFunction(ctx, name, ctx->ParamST, ctx->ParamST->size, TYPE(ctx, node));
+    pushTable(ctx, ctx->ParamST);
+    ctx->current_scope = LOCAL;
+    ctx->current_fun = getFunction(ctx, name);
+    ctx->ParamST = newSymbolTable(ctx, PARAM);
+    ctx->CompoundST = newSymbolTable(ctx, LOCAL);
+}
+
+
+/*********************************************************************
+ * FUNCTION NAME: closeFunction
+ * PURPOSE: Closes the scope of the function being declared
+ * ARGUMENTS: The compilation context (CompilerContext *)
+ *********************************************************************/
+static void closeFunction(CompilerContext *ctx) {
+
+    ctx->CompoundST = NULL;
+    popTable(ctx);
+    ctx->current_scope = GLOBAL;
+    ctx->current_fun = NULL;
+}
+
+
+/*********************************************************************
+ * FUNCTION NAME: analyzeFunDec
+ * PURPOSE: Analyzes a function declaration and gives its body the
+ *          table of its local variables
+ * ARGUMENTS: . The compilation context (CompilerContext *)
+ *            . The FUNDEC_AST node (int)
+ *********************************************************************/
+static void analyzeFunDec(CompilerContext *ctx, int node) {
+
+    int body = CHILD(ctx, node, 1);
+
+    analyzeFunHead(ctx, CHILD(ctx, node, 0));
+    analyzeNode(ctx, body);
+    NODE(ctx, body)->payload = addTable(ctx, ctx->CompoundST);
+    closeFunction(ctx);
+}
+
+
+/*********************************************************************
+ * FUNCTION NAME: analyzeVar
+ * PURPOSE: Resolves a variable or array element
+ * ARGUMENTS: . The compilation context (CompilerContext *)
+ *            . The VAR_AST or ARRAYVAR_AST node (int)
+ *********************************************************************/
+static void analyzeVar(CompilerContext *ctx, int node) {
+
+    char *name = NODE_NAME(ctx, node);
+    int offset = NODE(ctx, node)->offset;
+    int isElement = NODE(ctx, node)->astType == ARRAYVAR_AST;
+    VarSymbol *vs;
+
+    if(isElement) {
+        analyzeNode(ctx, CHILD(ctx, node, 0));
+        CHECK(ctx, CHILD_TYPE(ctx, node, 0) == TYPE_INTEGER) {
+            fprintf(ctx->diagnostics, "Error: @line %s, array %s: index is not integer.\n", sourcePosition(ctx, offset), name);
+        }
+    }
+    pushTable(ctx, ctx->CompoundST);
+    vs = getVariable(ctx, name);
+    if(vs != NULL && vs->scope == GLOBAL && vs->offset >= ctx->visibleGlobals)
+        vs = NULL;
+    CHECK(ctx, vs != NULL) {
+        fprintf(ctx->diagnostics, "Error: @line %s, variable %s not defined before.\n", sourcePosition(ctx, offset), name);
+    }
+    popTable(ctx);
+    if(isElement) {
+        CHECK(ctx, vs->type == TYPE_ARRAY) {
+            fprintf(ctx->diagnostics, "Error: @line %s, variable %s is not an array.\n", sourcePosition(ctx, offset), name);
+        }
+        NODE(ctx, node)->type = TYPE_INTEGER;
+    } else {
+        NODE(ctx, node)->type = vs->type;
+    }
+}
+
+
+/*********************************************************************
+ * FUNCTION NAME: analyzeCall
+ * PURPOSE: Checks the arguments of a call against the parameters of
+ *          the function called
+ * ARGUMENTS: . The compilation context (CompilerContext *)
+ *            . The CALL_AST node (int)
+ *********************************************************************/
+static void analyzeCall(CompilerContext *ctx, int node) {
+
+    char *name = NODE_NAME(ctx, node);
+    int offset = NODE(ctx, node)->offset;
+    FunSymbol *fun;
+    VarSymbol *var;
+    int arg;
+
+    analyzeList(ctx, CHILD(ctx, node, 0));
+    fun = getFunction(ctx, name);
+    if(fun != NULL && fun->index > ctx->visibleFuns)
+        fun = NULL;
+    CHECK(ctx, fun != NULL) {
+        fprintf(ctx->diagnostics, "Error: @line %s, call function %s which is not defined.\n", sourcePosition(ctx, offset), name);
+    }
+    var = fun->symbolTable->varList;
+    arg = CHILD(ctx, node, 0);
+    while(var && arg != NO_NODE) {
+        CHECK(ctx, var->type == TYPE(ctx, arg)) {
+            fprintf(ctx->diagnostics, "Error: @line %s, call function %s : parameter type mis-match.\n", sourcePosition(ctx, offset), name);
+        }
+        var = var->next_FIFO;
+        arg = NODE(ctx, arg)->sibling;
+    }
+    CHECK(ctx, !var && arg == NO_NODE) {
+        fprintf(ctx->diagnostics, "Error: @line %s, call function %s : parameter number mis-match.\n", sourcePosition(ctx, offset), name);
+    }
+    NODE(ctx, node)->type = fun->type;
+}
+
+
+/*********************************************************************
+ * FUNCTION NAME: analyzeExp
+ * PURPOSE: Checks that both operands of an operator are integers
+ * ARGUMENTS: . The compilation context (CompilerContext *)
+ *            . The EXP_AST node (int)
+ *********************************************************************/
+static void analyzeExp(CompilerContext *ctx, int node) {
+
+    int offset = NODE(ctx, node)->offset;
+
+    analyzeNode(ctx, CHILD(ctx, node, 0));
+    analyzeNode(ctx, CHILD(ctx, node, 1));
+    switch(NODE(ctx, node)->payload) {
+    case GT: case LT: case GE: case LE: case EQ: case NE:
+        CHECK(ctx, CHILD_TYPE(ctx, node, 0) == TYPE_INTEGER && CHILD_TYPE(ctx, node, 1) == TYPE_INTEGER) {
+            fprintf(ctx->diagnostics, "Error: @line %s, only can compare integers.\n", sourcePosition(ctx, offset));
+        }
+        break;
+    default:
+        CHECK(ctx, CHILD_TYPE(ctx, node, 0) == TYPE_INTEGER && CHILD_TYPE(ctx, node, 1) == TYPE_INTEGER) {
+            fprintf(ctx->diagnostics, "Error: @line %s, only can calculate integers.\n", sourcePosition(ctx, offset));
+        }
+        break;
+    }
+    NODE(ctx, node)->type = TYPE_INTEGER;
+}
+
+
+/*********************************************************************
+ * FUNCTION NAME: analyzeNode
+ * PURPOSE: Analyzes a node and its subtree. Children are analyzed
+ *          before the node itself, the order in which the parser
+ *          completes them, so the first error is the one nearest the
+ *          start of the source. Without checking, only declarations
+ *          and the statements that can hold them are visited
+ * ARGUMENTS: . The compilation context (CompilerContext *)
+ *            . The node (int)
+ *********************************************************************/
+static void analyzeNode(CompilerContext *ctx, int node) {
+
+    CompactNode *n = NODE(ctx, node);
+    int offset = n->offset;
+    int stmt;
+
+    switch(n->astType) {
+    case VARDEC_AST:
+    case ARRAYDEC_AST:
+        analyzeVarDec(ctx, node);
+        break;
+
+    case FUNDEC_AST:
+        analyzeFunDec(ctx, node);
+        break;
+
+    case PARAMID_AST:
+    case PARAMARRAY_AST:
+        analyzeParam(ctx, node);
+        break;
+
+    case COMPOUND_AST:
+        analyzeList(ctx, CHILD(ctx, node, 0));
+        analyzeList(ctx, CHILD(ctx, node, 1));
+        stmt = CHILD(ctx, node, 1);
+        if(stmt != NO_NODE && TYPE(ctx, stmt) != TYPE_UNDEFINED) {
+            n->type = TYPE(ctx, stmt);
+        } else {
+            n->type = TYPE_VOID;
+        }
+        break;
+
+    case SELESTMT_AST:
+    case ITERSTMT_AST:
+        if(ctx->checkSemantics)
+            analyzeNode(ctx, CHILD(ctx, node, 0));
+        analyzeList(ctx, CHILD(ctx, node, 1));
+        if(n->astType == SELESTMT_AST)
+            analyzeList(ctx, CHILD(ctx, node, 2));
+        if(ctx->checkSemantics) {
+            CHECK(ctx, CHILD_TYPE(ctx, node, 0) == TYPE_INTEGER) {
+                fprintf(ctx->diagnostics, "Error: @line %s, test condition expression not integer.\n", sourcePosition(ctx, offset));
+            }
+        }
+        break;
+
+    case RETSTMT_AST:
+        if(!ctx->checkSemantics) {
+            /* Code generation reads this type, which a valid return
+             * shares with its function. */
+            n->type = ctx->current_fun->type;
+        } else {
+            if(CHILD(ctx, node, 0) != NO_NODE) {
+                analyzeNode(ctx, CHILD(ctx, node, 0));
+                n->type = CHILD_TYPE(ctx, node, 0);
+            } else {
+                n->type = TYPE_VOID;
+            }
+            CHECK(ctx, n->type == ctx->current_fun->type) {
+                fprintf(ctx->diagnostics, "Error: @line %s, return type mis-match.\n", sourcePosition(ctx, offset));
+            }
+        }
+        if (ctx->Table)
+        	printSymTab(ctx, ctx->CompoundST);
+        break;
+
+    case ASSIGN_AST:
+        if(!ctx->checkSemantics)
+            break;
+        analyzeNode(ctx, CHILD(ctx, node, 0));
+        analyzeNode(ctx, CHILD(ctx, node, 1));
+        CHECK(ctx, CHILD_TYPE(ctx, node, 0) == TYPE_INTEGER && CHILD_TYPE(ctx, node, 1) == TYPE_INTEGER) {
+            fprintf(ctx->diagnostics, "Error: @line %s, only can assign int to int.\n", sourcePosition(ctx, offset));
+        }
+        n->type = TYPE_INTEGER;
+        break;
+
+    case VAR_AST:
+    case ARRAYVAR_AST:
+        if(ctx->checkSemantics)
+            analyzeVar(ctx, node);
+        break;
+
+    case EXP_AST:
+        if(ctx->checkSemantics)
+            analyzeExp(ctx, node);
+        break;
+
+    case CALL_AST:
+        if(ctx->checkSemantics)
+            analyzeCall(ctx, node);
+        break;
+
+    case NUM_AST:
+        if(!ctx->checkSemantics)
+            break;
+        CHECK(ctx, n->payload != CONSTANT_OVERFLOW) {
+            fprintf(ctx->diagnostics, "Error: @line %s, integer constant out of range.\n", sourcePosition(ctx, offset));
+        }
+        n->type = TYPE_INTEGER;
+        break;
+
+    default:
+        break;
+    }
+}
+
+
+void analyzeDeclaration(CompilerContext *ctx, int dec) {
+
+    timerStart(ctx, PHASE_SEMANTIC);
+    analyzeNode(ctx, dec);
+    timerStop(ctx);
+}
+
+
+/*********************************************************************
+ * FUNCTION NAME: declareAll
+ * PURPOSE: Analyzes the global declarations and function heads of the
+ *          program in order, leaving each function body to be checked
+ *          later with the scope its head opened
+ * ARGUMENTS: . The compilation context (CompilerContext *)
+ *            . The bodies to check (BodyPool *)
+ *********************************************************************/
+static void declareAll(CompilerContext *ctx, BodyPool *pool) {
+
+    BodyUnit *unit;
+    int dec;
+
+    for(dec = TREE_ROOT(ctx); dec != NO_NODE; dec = NODE(ctx, dec)->sibling) {
+        if(NODE(ctx, dec)->astType != FUNDEC_AST) {
+            analyzeNode(ctx, dec);
+            continue;
+        }
+        analyzeFunHead(ctx, CHILD(ctx, dec, 0));
+        if(pool->count == pool->cap) {
+            pool->cap = pool->cap * 2 + 64;
+            pool->units = (BodyUnit *)realloc(pool->units, pool->cap * sizeof(BodyUnit));
+            ASSERT(pool->units != NULL) {
+                fprintf(stderr, "Failed to malloc for function bodies.\n");
+            }
+        }
+        unit = &pool->units[pool->count++];
+        unit->body = CHILD(ctx, dec, 1);
+        unit->fun = ctx->current_fun;
+        unit->params = ctx->tables;
+        unit->locals = ctx->CompoundST;
+        unit->globals = ctx->tables->next->size;
+        closeFunction(ctx);
+    }
+}
+
+
+/*********************************************************************
+ * FUNCTION NAME: checkBody
+ * PURPOSE: Checks one function body on a thread of -fsemantic-threads.
+ *          If it holds an error, the message is kept when the body
+ *          comes before any other the thread found one in
+ * ARGUMENTS: . The thread (BodyChecker *)
+ *            . The index of the body in the pool (int)
+ *********************************************************************/
+static void checkBody(BodyChecker *checker, int index) {
+
+    CompilerContext *ctx = &checker->ctx;
+    BodyPool *pool = checker->pool;
+    BodyUnit *unit = &pool->units[index];
+    size_t start;
+    int first;
+
+    fflush(ctx->diagnostics);
+    start = checker->diagnosticsLen;
+    if(setjmp(ctx->bailout) != 0) {
+        fflush(ctx->diagnostics);
+        if(index < checker->error) {
+            free(checker->message);
+            checker->message = strndup(checker->diagnostics + start, checker->diagnosticsLen - start);
+            checker->error = index;
+        }
+        first = atomic_load(&pool->firstError);
+        while(index < first && !atomic_compare_exchange_weak(&pool->firstError, &first, index))
+            ;
+        return;
+    }
+    ctx->tables = unit->params;
+    ctx->CompoundST = unit->locals;
+    ctx->current_fun = unit->fun;
+    ctx->visibleGlobals = unit->globals;
+    ctx->visibleFuns = unit->fun->index;
+    analyzeNode(ctx, unit->body);
+}
+
+
+/*********************************************************************
+ * FUNCTION NAME: checkBodies
+ * PURPOSE: A thread of -fsemantic-threads. Takes bodies from the pool
+ *          in source order until none is left, or the rest all come
+ *          after one found to hold an error
+ * ARGUMENTS: The thread (BodyChecker *)
+ * RETURNS: NULL
+ *********************************************************************/
+static void *checkBodies(void *arg) {
+
+    BodyChecker *checker = (BodyChecker *)arg;
+    BodyPool *pool = checker->pool;
+    int index;
+
+    while((index = atomic_fetch_add(&pool->next, 1)) < pool->count) {
+        if(index > atomic_load(&pool->firstError))
+            break;
+        checkBody(checker, index);
+    }
+    return NULL;
+}
+
+
+/*********************************************************************
+ * FUNCTION NAME: declareHeads
+ * PURPOSE: Analyzes the global declarations and function heads for
+ *          analyzeParallel. An error in a head is only reported if no
+ *          body before it holds one, so its message is kept in the
+ *          pool, and pool->headFailed set, instead of ending the
+ *          compilation. The setjmp is kept out of analyzeParallel so
+ *          that none of its locals live across it
+ * ARGUMENTS: . The compilation context (CompilerContext *)
+ *            . The pool the bodies are added to (BodyPool *)
+ *********************************************************************/
+static void declareHeads(CompilerContext *ctx, BodyPool *pool) {
+
+    FILE *diagnostics = ctx->diagnostics;
+    jmp_buf bailout;
+
+    memcpy(bailout, ctx->bailout, sizeof(jmp_buf));
+    ctx->diagnostics = open_memstream(&pool->headError, &pool->headErrorLen);
+    ASSERT(ctx->diagnostics != NULL) {
+        fprintf(stderr, "Failed to open diagnostics stream.\n");
+    }
+    if(setjmp(ctx->bailout) == 0)
+        declareAll(ctx, pool);
+    else
+        pool->headFailed = TRUE;
+    fclose(ctx->diagnostics);
+    ctx->diagnostics = diagnostics;
+    memcpy(ctx->bailout, bailout, sizeof(jmp_buf));
+}
+
+
+/*********************************************************************
+ * FUNCTION NAME: analyzeParallel
+ * PURPOSE: Analyzes the program with its function bodies checked on
+ *          ctx->semanticThreads threads. The global declarations and
+ *          function heads are analyzed first, in order; each body then
+ *          sees the globals and functions declared before it, as it
+ *          would in order. Of the errors found, the one that comes
+ *          first in the source is reported
+ * ARGUMENTS: The compilation context (CompilerContext *)
+ *********************************************************************/
+static void analyzeParallel(CompilerContext *ctx) {
+
+    BodyPool *pool = (BodyPool *)calloc(1, sizeof(BodyPool));
+    BodyChecker *checkers = NULL;
+    char *message = NULL;
+    int count = 0;
+    int failed;
+    int k;
+
+    ASSERT(pool != NULL) {
+        fprintf(stderr, "Failed to malloc for function bodies.\n");
+    }
+    declareHeads(ctx, pool);
+
+    atomic_init(&pool->next, 0);
+    atomic_init(&pool->firstError, pool->count);
+    if(pool->count > 0) {
+        count = ctx->semanticThreads < pool->count ? ctx->semanticThreads : pool->count;
+        checkers = (BodyChecker *)calloc(count, sizeof(BodyChecker));
+        ASSERT(checkers != NULL) {
+            fprintf(stderr, "Failed to malloc for semantic threads.\n");
+        }
+    }
+    for(k = 0; k < count; ++k) {
+        BodyChecker *checker = &checkers[k];
+        CompilerContext *worker = &checker->ctx;
+        checker->pool = pool;
+        checker->error = pool->count;
+        worker->diagnostics = open_memstream(&checker->diagnostics, &checker->diagnosticsLen);
+        ASSERT(worker->diagnostics != NULL) {
+            fprintf(stderr, "Failed to open diagnostics stream.\n");
+        }
+        worker->source = ctx->source;
+        worker->sourceLen = ctx->sourceLen;
+        worker->compact = ctx->compact;
+        worker->constants = ctx->constants;
+        worker->constantCount = ctx->constantCount;
+        worker->funs = ctx->funs;
+        worker->checkSemantics = ctx->checkSemantics;
+        worker->current_scope = LOCAL;
+        ASSERT(pthread_create(&checker->thread, NULL, checkBodies, checker) == 0) {
+            fprintf(stderr, "Failed to start semantic thread.\n");
+        }
+    }
+    for(k = 0; k < count; ++k) {
+        BodyChecker *checker = &checkers[k];
+        pthread_join(checker->thread, NULL);
+        fclose(checker->ctx.diagnostics);
+        free(checker->diagnostics);
+        freeLines(&checker->ctx);
+        mergeArena(&ctx->scopeArena, &checker->ctx.scopeArena);
+        memAdd(&ctx->memory, &checker->ctx.memory);
+        if(checker->message != NULL && checker->error == atomic_load(&pool->firstError))
+            message = checker->message;
+        else
+            free(checker->message);
+    }
+    free(checkers);
+
+    if(message != NULL) {
+        fputs(message, ctx->diagnostics);
+        free(message);
+    } else if(pool->headFailed) {
+        fwrite(pool->headError, 1, pool->headErrorLen, ctx->diagnostics);
+    } else {
+        for(k = 0; k < pool->count; ++k)
+            NODE(ctx, pool->units[k].body)->payload = addTable(ctx, pool->units[k].locals);
+    }
+    failed = message != NULL || pool->headFailed;
+    free(pool->headError);
+    free(pool->units);
+    free(pool);
+    if(failed)
+        compileError(ctx);
+}
+
+
+void analyzeProgram(CompilerContext *ctx) {
+
+    int dec;
+
+    timerStart(ctx, PHASE_SEMANTIC);
+    /* The symbol tables are listed as they are filled, in order. */
+    if(ctx->semanticThreads > 1 && !ctx->Table) {
+        analyzeParallel(ctx);
+    } else {
+        for(dec = TREE_ROOT(ctx); dec != NO_NODE; dec = NODE(ctx, dec)->sibling)
+            analyzeNode(ctx, dec);
+    }
+    timerStop(ctx);
+}
@@ -0,0 +1,34 @@
+/*********************************************************************
+ * FILE NAME: SemanticAnalysis.h
+ * AUTHOR: Andrew O'Donohue
+ * PURPOSE: SemanticAnalysis.c public interface.
+ *********************************************************************/
+#ifndef SEMANTICANALYSIS_H
+#define SEMANTICANALYSIS_H
+
+#include "globals.h"
+
+
+/*********************************************************************
+ * FUNCTION NAME: analyzeDeclaration
+ * PURPOSE: Analyzes one top level declaration of the compact tree,
+ *          after those before it. With ctx->checkSemantics off only
+ *          the symbol tables are filled, and the declaration must be
+ *          valid. The first error found ends the compilation
+ * ARGUMENTS: . The compilation context (CompilerContext *)
+ *            . The index of the declaration (int)
+ *********************************************************************/
+void analyzeDeclaration(CompilerContext *ctx, int dec);
+
+
+/*********************************************************************
+ * FUNCTION NAME: analyzeProgram
+ * PURPOSE: Analyzes every declaration of the compact tree in order.
+ *          With ctx->semanticThreads above one, the function bodies
+ *          are checked on that many threads, with the same result
+ * ARGUMENTS: The compilation context (CompilerContext *)
+ *********************************************************************/
+void analyzeProgram(CompilerContext *ctx);
+
+
+#endif
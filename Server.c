@@ -0,0 +1,319 @@
+/*********************************************************************
+ * FILE NAME: Server.c
+ * AUTHOR: Andrew O'Donohue
+ * PURPOSE: Resident compile server and its client.
+ *********************************************************************/
+#include <pthread.h>
+#include <stdint.h>
+#include <signal.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include "globals.h"
+#include "cminus.h"
+#include "Server.h"
+
+#define HEADER_LEN 64
+#define MAX_REQUEST_LEN (64 * 1024 * 1024)
+
+
+/*********************************************************************
+ * FUNCTION NAME: writeAll
+ * PURPOSE: Writes a whole buffer to a socket
+ * ARGUMENTS: . The socket (int)
+ *            . The bytes to write (const char *)
+ *            . The number of bytes (size_t)
+ * RETURNS: 0 on success, -1 if the connection failed
+ *********************************************************************/
+static int writeAll(int fd, const char *buf, size_t len) {
+
+    while(len > 0) {
+        ssize_t n = write(fd, buf, len);
+        if(n <= 0)
+            return -1;
+        buf += n;
+        len -= n;
+    }
+    return 0;
+}
+
+
+/*********************************************************************
+ * FUNCTION NAME: readAll
+ * PURPOSE: Reads exactly len bytes from a socket
+ * ARGUMENTS: . The socket (int)
+ *            . The buffer to fill (char *)
+ *            . The number of bytes (size_t)
+ * RETURNS: 0 on success, -1 if the connection ended first
+ *********************************************************************/
+static int readAll(int fd, char *buf, size_t len) {
+
+    while(len > 0) {
+        ssize_t n = read(fd, buf, len);
+        if(n <= 0)
+            return -1;
+        buf += n;
+        len -= n;
+    }
+    return 0;
+}
+
+
+/*********************************************************************
+ * FUNCTION NAME: readHeader
+ * PURPOSE: Reads one header line, without its newline
+ * ARGUMENTS: . The socket (int)
+ *            . The buffer to fill, HEADER_LEN bytes (char *)
+ * RETURNS: 0 on success, -1 if the connection ended or the line was
+ *          too long
+ *********************************************************************/
+static int readHeader(int fd, char *line) {
+
+    int i;
+    for(i=0; i<HEADER_LEN-1; ++i) {
+        if(read(fd, &line[i], 1) != 1)
+            return -1;
+        if(line[i] == '\n') {
+            line[i] = '\0';
+            return 0;
+        }
+    }
+    return -1;
+}
+
+
+/*********************************************************************
+ * FUNCTION NAME: writeFrame
+ * PURPOSE: Writes a named, length-prefixed block of the reply
+ * ARGUMENTS: . The socket (int)
+ *            . The name of the frame (const char *)
+ *            . The contents (const char *)
+ *            . The length of the contents (size_t)
+ * RETURNS: 0 on success, -1 if the connection failed
+ *********************************************************************/
+static int writeFrame(int fd, const char *name, const char *buf, size_t len) {
+
+    char header[HEADER_LEN];
+    int n = snprintf(header, sizeof(header), "%s %zu\n", name, len);
+    if(writeAll(fd, header, n) != 0)
+        return -1;
+    return writeAll(fd, buf, len);
+}
+
+
+/*********************************************************************
+ * FUNCTION NAME: serveConnection
+ * PURPOSE: Answers compile requests on one connection until the
+ *          client closes it
+ * ARGUMENTS: The connected socket (int, passed as intptr_t)
+ * RETURNS: NULL
+ *********************************************************************/
+static void *serveConnection(void *arg) {
+
+    int fd = (int)(intptr_t)arg;
+    char header[HEADER_LEN];
+    char letters[HEADER_LEN];
+    size_t len;
+
+    while(readHeader(fd, header) == 0) {
+        if(sscanf(header, "%63s %zu", letters, &len) != 2 || len > MAX_REQUEST_LEN)
+            break;
+        char *src = (char *)malloc(len + 1);
+        if(src == NULL || readAll(fd, src, len) != 0) {
+            free(src);
+            break;
+        }
+
+        int flags = CM_PARSE_ONLY;
+        if(strchr(letters, 'a'))
+            flags |= CM_AST;
+        if(strchr(letters, 's'))
+            flags |= CM_TABLE;
+        if(strchr(letters, 'c'))
+            flags &= ~CM_PARSE_ONLY;
+
+        CmResult result;
+        cm_compile(src, len, flags, &result);
+        free(src);
+
+        char *diagnostics = NULL;
+        size_t diagnosticsLen = 0;
+        FILE *diag = open_memstream(&diagnostics, &diagnosticsLen);
+        int i;
+        for(i=0; i<result.diagnosticCount; ++i)
+            fprintf(diag, "%s\n", result.diagnostics[i]);
+        fclose(diag);
+
+        char status[HEADER_LEN];
+        int n = snprintf(status, sizeof(status), "status %d\n", result.status);
+        int failed = writeFrame(fd, "listing", result.listing, result.listingLen) != 0
+                  || writeFrame(fd, "diagnostics", diagnostics, diagnosticsLen) != 0
+                  || writeFrame(fd, "code", result.code, result.codeLen) != 0
+                  || writeAll(fd, status, n) != 0;
+        free(diagnostics);
+        cm_free_result(&result);
+        if(failed)
+            break;
+    }
+    close(fd);
+    return NULL;
+}
+
+
+/*********************************************************************
+ * FUNCTION NAME: socketAddress
+ * PURPOSE: Fills in the address of a Unix domain socket
+ * ARGUMENTS: . The address to fill (struct sockaddr_un *)
+ *            . The path of the socket (const char *)
+ * RETURNS: 0 on success, -1 if the path is too long
+ *********************************************************************/
+static int socketAddress(struct sockaddr_un *addr, const char *path) {
+
+    memset(addr, 0, sizeof(*addr));
+    addr->sun_family = AF_UNIX;
+    if(strlen(path) >= sizeof(addr->sun_path)) {
+        fprintf(stderr, "Socket path %s is too long.\n", path);
+        return -1;
+    }
+    strcpy(addr->sun_path, path);
+    return 0;
+}
+
+
+int runServer(const char *path) {
+
+    struct sockaddr_un addr;
+    int listener;
+
+    if(socketAddress(&addr, path) != 0)
+        return 1;
+    signal(SIGPIPE, SIG_IGN);
+    listener = socket(AF_UNIX, SOCK_STREAM, 0);
+    unlink(path);
+    if(listener < 0 || bind(listener, (struct sockaddr *)&addr, sizeof(addr)) != 0
+            || listen(listener, SOMAXCONN) != 0) {
+        perror(path);
+        return 1;
+    }
+    fprintf(stderr, "cm: serving on %s\n", path);
+
+    for(;;) {
+        int fd = accept(listener, NULL, NULL);
+        if(fd < 0)
+            continue;
+        pthread_t thread;
+        if(pthread_create(&thread, NULL, serveConnection, (void *)(intptr_t)fd) != 0) {
+            close(fd);
+            continue;
+        }
+        pthread_detach(thread);
+    }
+    return 0;
+}
+
+
+/*********************************************************************
+ * FUNCTION NAME: readFrame
+ * PURPOSE: Reads a named, length-prefixed block of the reply
+ * ARGUMENTS: . The socket (int)
+ *            . The expected name of the frame (const char *)
+ *            . Receives the contents, which the caller frees (char **)
+ *            . Receives the length of the contents (size_t *)
+ * RETURNS: 0 on success, -1 on a protocol or connection error
+ *********************************************************************/
+static int readFrame(int fd, const char *name, char **buf, size_t *len) {
+
+    char header[HEADER_LEN];
+    char found[HEADER_LEN];
+
+    if(readHeader(fd, header) != 0 || sscanf(header, "%63s %zu", found, len) != 2
+            || strcmp(found, name) != 0)
+        return -1;
+    *buf = (char *)malloc(*len + 1);
+    if(*buf == NULL || readAll(fd, *buf, *len) != 0)
+        return -1;
+    return 0;
+}
+
+
+int runClient(const char *path, char **files, int count, const CompileOptions *options) {
+
+    struct sockaddr_un addr;
+    int failed = 0;
+    int fd, i;
+
+    if(socketAddress(&addr, path) != 0)
+        return count;
+    fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if(fd < 0 || connect(fd, (struct sockaddr *)&addr, sizeof(addr)) != 0) {
+        perror(path);
+        return count;
+    }
+
+    for(i=0; i<count; ++i) {
+        FILE *source = fopen(files[i], "r");
+        if(source == NULL) {
+            fprintf(stderr, "File %s not found.\n", files[i]);
+            failed++;
+            continue;
+        }
+        char *src = NULL;
+        size_t len = 0;
+        FILE *buf = open_memstream(&src, &len);
+        char chunk[BUFSIZ];
+        size_t n;
+        while((n = fread(chunk, 1, sizeof(chunk), source)) > 0)
+            fwrite(chunk, 1, n, buf);
+        fclose(buf);
+        fclose(source);
+
+        char header[HEADER_LEN];
+        int headerLen = snprintf(header, sizeof(header), "%s%s%s- %zu\n",
+                                 options->AST ? "a" : "", options->Table ? "s" : "",
+                                 options->Assembly ? "c" : "", len);
+        int sent = writeAll(fd, header, headerLen) == 0 && writeAll(fd, src, len) == 0;
+        free(src);
+
+        char *listing = NULL, *diagnostics = NULL, *code = NULL;
+        size_t listingLen, diagnosticsLen, codeLen;
+        int status = 1;
+        if(!sent || readFrame(fd, "listing", &listing, &listingLen) != 0
+                || readFrame(fd, "diagnostics", &diagnostics, &diagnosticsLen) != 0
+                || readFrame(fd, "code", &code, &codeLen) != 0
+                || readHeader(fd, header) != 0 || sscanf(header, "status %d", &status) != 1) {
+            fprintf(stderr, "Lost connection to server on %s.\n", path);
+            free(listing);
+            free(diagnostics);
+            free(code);
+            close(fd);
+            return failed + count - i;
+        }
+
+        printf("\nC minus compilation: %s\n", files[i]);
+        fwrite(listing, 1, listingLen, stdout);
+        fflush(stdout);
+        fwrite(diagnostics, 1, diagnosticsLen, stderr);
+        if(status == 0 && options->Assembly) {
+            char *codefile = (char *)malloc(strlen(files[i]) + strlen(".tm") + 1);
+            strcpy(codefile, files[i]);
+            strcat(codefile, ".tm");
+            FILE *out = fopen(codefile, "w");
+            if(out == NULL) {
+                fprintf(stderr, "Unable to open %s for output.\n", codefile);
+                status = 1;
+            }
+            else {
+                fwrite(code, 1, codeLen, out);
+                fclose(out);
+            }
+            free(codefile);
+        }
+        if(status != 0)
+            failed++;
+        free(listing);
+        free(diagnostics);
+        free(code);
+    }
+    close(fd);
+    return failed;
+}
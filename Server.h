@@ -0,0 +1,45 @@
+/*********************************************************************
+ * FILE NAME: Server.h
+ * AUTHOR: Andrew O'Donohue
+ * PURPOSE: Server.c public interface.
+ *
+ * A request is the header "<flags> <length>\n" followed by <length>
+ * bytes of source, where flags holds the letters a, s and c or is
+ * "-". The reply is the frames "listing <n>\n", "diagnostics <n>\n"
+ * and "code <n>\n", each followed by n bytes, then "status <n>\n".
+ * A connection may carry any number of requests.
+ *********************************************************************/
+#ifndef SERVER_H
+#define SERVER_H
+
+#include "globals.h"
+
+
+/*********************************************************************
+ * FUNCTION NAME: runServer
+ * PURPOSE: Listens on a Unix domain socket and compiles requests
+ *          until killed. Each request gets a fresh context, so a bad
+ *          program cannot affect the ones after it
+ * ARGUMENTS: The path of the socket (const char *)
+ * RETURNS: Nonzero if the socket could not be set up
+ *********************************************************************/
+int runServer(const char *path);
+
+
+/*********************************************************************
+ * FUNCTION NAME: runClient
+ * PURPOSE: Sends source files to a running server, printing listings
+ *          and diagnostics and writing <sourcefile>.tm like a local
+ *          compilation would
+ * ARGUMENTS: . The path of the socket (const char *)
+ *            . The names of the source files (char **)
+ *            . The number of source files (int)
+ *            . The options each file is compiled with; the time and
+ *              memory reports are not available remotely
+ *              (const CompileOptions *)
+ * RETURNS: The number of files that failed to compile
+ *********************************************************************/
+int runClient(const char *path, char **files, int count, const CompileOptions *options);
+
+
+#endif
@@ -5,12 +5,9 @@
  *********************************************************************/
 #include "globals.h"
 #include "SymbolTable.h"
-
-
-SymbolTable *tables = NULL;
-FunSymbol *funs = NULL;
-SymbolTable *CompoundST;
-SymbolTable *ParamST;
+#include "Timer.h"
+#include "Memory.h"
+#include "Atom.h"
 
 
 int hash (char *key) {
@@ -24,179 +21,187 @@ int hash (char *key) {
 }
 
 
-void initTable() {
-    CompoundST = newSymbolTable(LOCAL);
-    ParamST = newSymbolTable(PARAM);
-    tables = newSymbolTable(GLOBAL);
-    putFunction("input", ParamST, 0, TYPE_INTEGER);
-    ParamST = newSymbolTable(PARAM);
-    pushTable(ParamST);
-    putVariable("i", PARAM, ParamST->size++, TYPE_INTEGER);
-    popTable();
-    putFunction("output", ParamST, ParamST->size, TYPE_VOID);
-    ParamST = newSymbolTable(PARAM);
+void initTable(CompilerContext *ctx) {
+    ctx->ParamST = newSymbolTable(ctx, PARAM);
+    ctx->tables = newSymbolTable(ctx, GLOBAL);
+    putFunction(ctx, internName(ctx, "input"), ctx->ParamST, 0, TYPE_INTEGER);
+    ctx->ParamST = newSymbolTable(ctx, PARAM);
+    pushTable(ctx, ctx->ParamST);
+    putVariable(ctx, internName(ctx, "i"), PARAM, ctx->ParamST->size++, TYPE_INTEGER);
+    popTable(ctx);
+    putFunction(ctx, internName(ctx, "output"), ctx->ParamST, ctx->ParamST->size, TYPE_VOID);
+    ctx->ParamST = newSymbolTable(ctx, PARAM);
 }
 
 
-SymbolTable *newSymbolTable(Scope scope) {
+SymbolTable *newSymbolTable(CompilerContext *ctx, Scope scope) {
     int i;
 
-    SymbolTable *st = (SymbolTable *)malloc(sizeof(SymbolTable));
-    ASSERT(st != NULL) {
-        fprintf(stderr, "Failed to malloc for symbal table.\n");
-    }
+    timerStart(ctx, PHASE_SYMTAB);
+    /* Local tables are released with their function when streaming. */
+    Arena *arena = scope == LOCAL ? &ctx->scopeArena : &ctx->symbolArena;
+    SymbolTable *st = (SymbolTable *)arenaAlloc(ctx, arena, MEM_SYMBOLTABLE, sizeof(SymbolTable));
     st->scope = scope;
     st->size = 0;
     st->next = NULL;
     st->varList = NULL;
+    st->varTail = NULL;
     for(i = 0; i<SIZE; i++) {
         st->hashTable[i] = NULL;
     }
+    timerStop(ctx);
     return st;
 }
 
 
-SymbolTable *topTable() {
-    return tables;
+SymbolTable *topTable(CompilerContext *ctx) {
+    return ctx->tables;
 }
 
 
-SymbolTable *popTable() {
-    ASSERT(tables != NULL) {
+SymbolTable *popTable(CompilerContext *ctx) {
+    ASSERT(ctx->tables != NULL) {
         fprintf(stderr, "Pop an empty table list.\n");
     }
-    SymbolTable *st = tables;
-    tables = tables->next;
+    SymbolTable *st = ctx->tables;
+    ctx->tables = ctx->tables->next;
     return st;
 }
 
 
-void pushTable(SymbolTable *st) {
+void pushTable(CompilerContext *ctx, SymbolTable *st) {
     ASSERT(st != NULL) {
         fprintf(stderr, "Push an null table.\n");
     }
-    st->next = tables;
-    tables = st;
+    st->next = ctx->tables;
+    ctx->tables = st;
 }
 
 
-VarSymbol *getTopVar(char *name) {
-    if(tables == NULL)
+VarSymbol *getTopVar(CompilerContext *ctx, char *name) {
+    if(ctx->tables == NULL)
         return NULL;
 
+    timerStart(ctx, PHASE_SYMTAB);
     VarSymbol *l;
-    int h = hash(name);
-    for(l = tables->hashTable[h]; l!=NULL; l=l->next) {
-        if(strcmp(l->name, name) == 0)
+    int h = ATOM(name)->bucket;
+    for(l = ctx->tables->hashTable[h]; l!=NULL; l=l->next) {
+        if(l->name == name)
             break;
     }
+    timerStop(ctx);
     return l;
 }
 
 
-VarSymbol *getVariable(char *name) {
-    if(tables == NULL)
+VarSymbol *getVariable(CompilerContext *ctx, char *name) {
+    if(ctx->tables == NULL)
         return NULL;
 
-    int h = hash(name);
+    timerStart(ctx, PHASE_SYMTAB);
+    int h = ATOM(name)->bucket;
     SymbolTable *st;
-    VarSymbol *l;
-    for(st = tables; st!=NULL; st=st->next) {
+    VarSymbol *l = NULL;
+    for(st = ctx->tables; st!=NULL && l==NULL; st=st->next) {
         for(l = st->hashTable[h]; l!=NULL; l=l->next) {
-            if(strcmp(l->name, name)==0)
-                return l;
+            if(l->name == name)
+                break;
         }
     }
-    return NULL;
+    timerStop(ctx);
+    return l;
 }
 
 
-FunSymbol *getFunction(char *name) {
-    if(funs == NULL)
+FunSymbol *getFunction(CompilerContext *ctx, char *name) {
+    if(ctx->funs == NULL)
         return NULL;
 
-    FunSymbol *fs;
-    for(fs=funs; fs!=NULL; fs = fs->next) {
-        if(strcmp(fs->name, name)==0)
-            break;
-    }
+    timerStart(ctx, PHASE_SYMTAB);
+    FunSymbol *fs = ATOM(name)->fun;
+    timerStop(ctx);
     return fs;
 }
 
 
-int putVariable(char *name, Scope scope, int offset, ExpType type) {
-    VarSymbol *l, *tmp;
-    int h = hash(name);
+int putVariable(CompilerContext *ctx, char *name, Scope scope, int offset, ExpType type) {
+    VarSymbol *l;
+    int h = ATOM(name)->bucket;
 
-    if(tables == NULL) {
+    timerStart(ctx, PHASE_SYMTAB);
+    if(ctx->tables == NULL) {
         l = NULL;
     } else {
-        l =  tables->hashTable[h];
-        while ((l != NULL) && (strcmp(name,l->name) != 0)) {
+        l =  ctx->tables->hashTable[h];
+        while ((l != NULL) && (l->name != name)) {
             l = l->next;
         }
     }
 
     if (l != NULL) {
-        fprintf(stderr, "Duplicate declarations of variable: %s.\n", name);
+        fprintf(ctx->diagnostics, "Duplicate declarations of variable: %s.\n", name);
+        timerStop(ctx);
         return 1;
     }
 
-    l = (VarSymbol *) malloc(sizeof(VarSymbol));
-    ASSERT(l != NULL) {
-        fprintf(stderr, "Failed to malloc for VarSymbol.\n");
-    }
-    l->name = strdup(name);
+    l = (VarSymbol *)arenaAlloc(ctx, scope == LOCAL ? &ctx->scopeArena : &ctx->symbolArena,
+                                MEM_VARSYMBOL, sizeof(VarSymbol));
+    l->name = name;
     l->scope = scope;
     l->type = type;
     l->offset = offset;
-    l->next = tables->hashTable[h];
-    tables->hashTable[h] = l;
+    l->next = ctx->tables->hashTable[h];
+    ctx->tables->hashTable[h] = l;
     l->next_FIFO = NULL;
-    if(tables->varList == NULL) {
-        tables->varList = l;
+    if(ctx->tables->varList == NULL) {
+        ctx->tables->varList = l;
     } else {
-        for(tmp=tables->varList; tmp->next_FIFO != NULL; tmp = tmp->next_FIFO);
-        tmp->next_FIFO = l;
+        ctx->tables->varTail->next_FIFO = l;
     }
+    ctx->tables->varTail = l;
+    timerStop(ctx);
     return 0;
 }
 
 
-int putFunction(char *name, SymbolTable *st, int num, ExpType type) {
+int putFunction(CompilerContext *ctx, char *name, SymbolTable *st, int num, ExpType type) {
     FunSymbol *fs;
 
-    if(getFunction(name) != NULL) {
-        fprintf(stderr, "Duplicate declarations of function: %s\n", name);
+    timerStart(ctx, PHASE_SYMTAB);
+    if(getFunction(ctx, name) != NULL) {
+        fprintf(ctx->diagnostics, "Duplicate declarations of function: %s\n", name);
+        timerStop(ctx);
         return 1;
     }
-    fs = (FunSymbol *)malloc(sizeof(FunSymbol));
-    ASSERT(fs != NULL) {
-        fprintf(stderr, "Failed to malloc for FunSymbol.\n");
-    }
-    fs->name = strdup(name);
+    fs = (FunSymbol *)arenaAlloc(ctx, &ctx->symbolArena, MEM_FUNSYMBOL, sizeof(FunSymbol));
+    fs->name = name;
     fs->type = type;
     fs->paramNum = num;
+    fs->index = ctx->funs != NULL ? ctx->funs->index + 1 : 0;
     fs->symbolTable = st;
-    fs->next = funs;
-    funs = fs;
+    fs->next = ctx->funs;
+    ctx->funs = fs;
+    ATOM(name)->fun = fs;
+    timerStop(ctx);
 
     return 0;
 }
 
 
-void printSymTab(SymbolTable *st) {
+void printSymTab(CompilerContext *ctx, SymbolTable *st) {
     int i;
 
-    fprintf(listing,"Variable Name  Offset\n");
-    fprintf(listing,"-------------  ------\n");
+    timerStart(ctx, PHASE_OUTPUT);
+    fprintf(ctx->listing,"Variable Name  Offset\n");
+    fprintf(ctx->listing,"-------------  ------\n");
     VarSymbol *vs = NULL;
     for (i=0; i<SIZE; ++i) {
         for(vs = st->hashTable[i]; vs != NULL; vs=vs->next) {
-            fprintf(listing, "%-14s", vs->name);
-            fprintf(listing, "%-8d", vs->offset);
-            fprintf(listing, "\n");
+            fprintf(ctx->listing, "%-14s", vs->name);
+            fprintf(ctx->listing, "%-8d", vs->offset);
+            fprintf(ctx->listing, "\n");
         }
     }
-    fprintf(listing, "\n");
+    fprintf(ctx->listing, "\n");
+    timerStop(ctx);
 }
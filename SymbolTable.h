@@ -21,87 +21,97 @@ int hash(char *key);
 /*********************************************************************
  * FUNCTION NAME: initTable
  * PURPOSE: Initializes all values in the symbol table.
+ * ARGUMENTS: The compilation context (CompilerContext *)
  *********************************************************************/
-void initTable();
+void initTable(CompilerContext *ctx);
 
 
 /*********************************************************************
  * FUNCTION NAME: newSymbolTable
  * PURPOSE: Creates a new symbol table
- * ARGUMENTS: The scope of the new table (scope)
+ * ARGUMENTS: . The compilation context (CompilerContext *)
+ *            . The scope of the new table (scope)
  * RETURNS: The newly created table (SymbolTable *)
  *********************************************************************/
-SymbolTable *newSymbolTable(Scope scope);
+SymbolTable *newSymbolTable(CompilerContext *ctx, Scope scope);
 
 
 /*********************************************************************
  * FUNCTION NAME: topTable
  * PURPOSE: Finds the table at the highest scope
+ * ARGUMENTS: The compilation context (CompilerContext *)
  * RETURNS: The symbol table (SymbolTable *)
  *********************************************************************/
-SymbolTable *topTable();
+SymbolTable *topTable(CompilerContext *ctx);
 
 
 /*********************************************************************
  * FUNCTION NAME: popTable
  * PURPOSE: Finds next table in scope
+ * ARGUMENTS: The compilation context (CompilerContext *)
  * RETURNS: The symbol table (SymbolTable *)
  *********************************************************************/
-SymbolTable *popTable();
+SymbolTable *popTable(CompilerContext *ctx);
 
 
 /*********************************************************************
  * FUNCTION NAME: pushTable
  * PURPOSE: Puts a table into the current lowest scope
- * ARGUMENTS: The table to be pushed (SymbolTable *)
+ * ARGUMENTS: . The compilation context (CompilerContext *)
+ *            . The table to be pushed (SymbolTable *)
  *********************************************************************/
-void pushTable(SymbolTable *st);
+void pushTable(CompilerContext *ctx, SymbolTable *st);
 
 
 /*********************************************************************
  * FUNCTION NAME: getTopVar
  * PURPOSE: Finds variable at highest scope
- * ARGUMENTS: The variable to be found (char *)
+ * ARGUMENTS: . The compilation context (CompilerContext *)
+ *            . The name of the variable to be found, an atom (char *)
  * RETURNS: The corresponding variable (VarSymbol *)
  *********************************************************************/
-VarSymbol *getTopVar(char *name);
+VarSymbol *getTopVar(CompilerContext *ctx, char *name);
 
 
 /*********************************************************************
  * FUNCTION NAME: getVariable
  * PURPOSE: Finds a variable
- * ARGUMENTS: The variable to be found (char *)
+ * ARGUMENTS: . The compilation context (CompilerContext *)
+ *            . The name of the variable to be found, an atom (char *)
  * RETURNS: The corresponding variable (VarSymbol *)
  *********************************************************************/
-VarSymbol *getVariable(char *name);
+VarSymbol *getVariable(CompilerContext *ctx, char *name);
 
 
 /*********************************************************************
  * FUNCTION NAME: getFuntion
  * PURPOSE: Finds a function
- * ARGUMENTS: The function to be found (char*)
+ * ARGUMENTS: . The compilation context (CompilerContext *)
+ *            . The name of the function to be found, an atom (char *)
  * RETURNS: The corresponding function (FunSymbol *)
  *********************************************************************/
-FunSymbol *getFunction(char *name);
+FunSymbol *getFunction(CompilerContext *ctx, char *name);
 
 
 /*********************************************************************
  * FUNCTION NAME: putVariable
  * PURPOSE: Places a variable into the symbol table
- * ARGUMENTS: . The name of the variable (char *) 
+ * ARGUMENTS: . The compilation context (CompilerContext *)
+ *            . The name of the variable, an atom (char *)
  *            . The scope of the variable (Scope)
  *            . The value of the variable (int)
  *            . The data type of the variable (ExpType)
  * RETURNS: True (a nonzero integer) if the variable already exists,
  *          false (0) otherwise
  *********************************************************************/
-int putVariable(char *name, Scope s, int offset, ExpType type);
+int putVariable(CompilerContext *ctx, char *name, Scope s, int offset, ExpType type);
 
 
 /*********************************************************************
  * FUNCTION NAME: putFunction
  * PURPOSE: Places a function into the symbol table
- * ARGUMENTS: . The name of the function (char *) 
+ * ARGUMENTS: . The compilation context (CompilerContext *)
+ *            . The name of the function, an atom (char *)
  *            . The symbol table to insert the function into 
  *              (SymbolTable)
  *            . The value of the function (int)
@@ -109,15 +119,16 @@ int putVariable(char *name, Scope s, int offset, ExpType type);
  * RETURNS: True (a nonzero integer) if the variable already exists,
  *          false (0) otherwise
  *********************************************************************/
-int putFunction(char *name, SymbolTable *st, int num, ExpType type);
+int putFunction(CompilerContext *ctx, char *name, SymbolTable *st, int num, ExpType type);
 
 
 /*********************************************************************
  * FUNCTION NAME: printSymTab
  * PURPOSE: Prints symbol table to stdout
- * ARGUMENTS: The table to be printed (SymbolTable *)
+ * ARGUMENTS: . The compilation context (CompilerContext *)
+ *            . The table to be printed (SymbolTable *)
  *********************************************************************/
-void printSymTab(SymbolTable *st);
+void printSymTab(CompilerContext *ctx, SymbolTable *st);
 
 
 #endif
@@ -1,224 +1,136 @@
 /*********************************************************************
  * FILE NAME: SyntaxTree.c
  * AUTHOR: Andrew O'Donohue
- * PURPOSE: Functions to create and manipulate syntax tree.
+ * PURPOSE: Functions to create and manipulate syntax tree. The parser
+ *          only builds the tree; SemanticAnalysis.c checks it.
  *********************************************************************/
 #include "globals.h"
-#include "parse.h"
-#include "SymbolTable.h"
 #include "SyntaxTree.h"
+#include "Memory.h"
 
-TreeNode *ASTRoot;
 
-static Scope current_scope = GLOBAL;
-static FunSymbol *current_fun = NULL;
-
-
-TreeNode *newDecList(TreeNode* decList, TreeNode* declaration) {
-    TreeNode* node = decList;
+/*********************************************************************
+ * FUNCTION NAME: appendNode
+ * PURPOSE: Adds a node to the end of a list of siblings. A NULL node,
+ *          such as an empty statement, leaves the list as it is
+ * ARGUMENTS: . The list (NodeList)
+ *            . The node, which has no siblings of its own (TreeNode *)
+ * RETURNS: The longer list (NodeList)
+ *********************************************************************/
+static NodeList appendNode(NodeList list, TreeNode *node) {
 
-    while(node->sibling != NULL) {
-        node = node->sibling;
-    }
-    node->sibling = declaration;
-    return decList;
+    if(node == NULL)
+        return list;
+    if(list.head == NULL)
+        list.head = node;
+    else
+        list.tail->sibling = node;
+    list.tail = node;
+    return list;
 }
 
-TreeNode *newTypeSpe(ExpType type, int lineno) {
-    TreeNode *root = newASTNode(TYPE_AST, lineno);
+
+TreeNode *newTypeSpe(CompilerContext *ctx, ExpType type, int offset) {
+    TreeNode *root = newASTNode(ctx, TYPE_AST, offset);
 
     root->type = type;
     return root;
 }
 
 
-TreeNode *newVarDec(TreeNode *typeSpecifier, char *ID, int lineno) {
-
-    ASSERT(typeSpecifier->type == TYPE_INTEGER) {
-        fprintf(stderr, "Error: @line %d, type specifier of variable %s must be int.\n", lineno, ID);
-    }
-    if(current_scope == LOCAL)
-        pushTable(CompoundST);
-    ASSERT(getTopVar(ID) == NULL) {
-        fprintf(stderr, "Error: @line %d, duplicate declarations of variable %s.\n", lineno, ID);
-    }
+TreeNode *newVarDec(CompilerContext *ctx, TreeNode *typeSpecifier, char *ID, int offset) {
 
-    TreeNode *root = newASTNode(VARDEC_AST, lineno);
+    TreeNode *root = newASTNode(ctx, VARDEC_AST, offset);
     root->child[0] = typeSpecifier;
-    root->attr.name = strdup(ID);
+    root->attr.name = ID;
     root->type = TYPE_INTEGER;
 
-    if(current_scope == LOCAL) {
-        putVariable(root->attr.name, LOCAL, tables->size++, TYPE_INTEGER);
-        popTable();
-    } else {
-        putVariable(root->attr.name, GLOBAL, tables->size++, TYPE_INTEGER);
-    }
     return root;
 }
 
 
-TreeNode *newArrayDec(TreeNode *typeSpecifier, char *ID, int size, int lineno) {
-
-    ASSERT(typeSpecifier->type == TYPE_INTEGER) {
-        fprintf(stderr, "Error: @line %d, type specifier of variable %s must be int.\n", lineno, ID);
-    }
-    if(current_scope == LOCAL)
-        pushTable(CompoundST);
-    ASSERT(getTopVar(ID) == NULL) {
-        fprintf(stderr, "Error: @line %d, duplicate declarations of variable %s.\n", lineno, ID);
-    }
+TreeNode *newArrayDec(CompilerContext *ctx, TreeNode *typeSpecifier, char *ID, int size, int offset) {
 
-    TreeNode *root = newASTNode(ARRAYDEC_AST, lineno);
+    TreeNode *root = newASTNode(ctx, ARRAYDEC_AST, offset);
     root->child[0] = typeSpecifier;
-    root->attr.name = strdup(ID);
+    root->attr.name = ID;
     root->type = TYPE_ARRAY;
     root->attr.value = size;
 
-
-    if(current_scope == LOCAL) {
-        putVariable(root->attr.name, LOCAL, tables->size, TYPE_ARRAY);
-        tables->size += size;
-        popTable();
-    } else {
-        putVariable(root->attr.name, GLOBAL, tables->size, TYPE_ARRAY);
-        tables->size += size;
-    }
     return root;
 }
 
 
-TreeNode *newFunDec(TreeNode *funHead, TreeNode *funBody, int lineno) {
+TreeNode *newFunDec(CompilerContext *ctx, TreeNode *funHead, TreeNode *funBody, int offset) {
 
-    TreeNode *root = newASTNode(FUNDEC_AST, lineno);
+    TreeNode *root = newASTNode(ctx, FUNDEC_AST, offset);
     root->child[0] = funHead;
     root->child[1] = funBody;
-    funBody->symbolTable = CompoundST;
-    CompoundST = newSymbolTable(LOCAL);
-    popTable();
-    current_scope = GLOBAL;
-    current_fun = NULL;
+
     return root;
 }
 
 
-TreeNode *newFunHead(TreeNode *typeSpecifier, char *ID, TreeNode *params, int lineno) {
+TreeNode *newFunHead(CompilerContext *ctx, TreeNode *typeSpecifier, char *ID, TreeNode *params, int offset) {
 
-    ASSERT(getFunction(ID) == NULL) {
-        fprintf(stderr, "Error: @line %d, duplicate declarations of function %s.\n", lineno, ID);
-    }
-
-    TreeNode *root = newASTNode(FUNHEAD_AST, lineno);
-    root->attr.name = strdup(ID);
+    TreeNode *root = newASTNode(ctx, FUNHEAD_AST, offset);
+    root->attr.name = ID;
     root->type = typeSpecifier->type;
     root->child[0] = typeSpecifier;
     root->child[1] = params;
 
-    if (Table)
-    	fprintf(listing, "Symbol table of function: %s\n", root->attr.name);
-
-    putFunction(ID, ParamST, ParamST->size, root->type);
-    pushTable(ParamST);
-    current_scope = LOCAL;
-    current_fun = getFunction(ID);
-    ParamST = newSymbolTable(PARAM);
     return root;
 }
 
 
-TreeNode *newParamList(TreeNode *paramList, TreeNode *param) {
+NodeList newParamList(NodeList paramList, TreeNode *param) {
 
-    TreeNode *node = paramList;
-    if(paramList != NULL) {
-        while(node->sibling != NULL) {
-            node = node->sibling;
-        }
-        node->sibling = param;
-        return paramList;
-    } else {
-        return param;
-    }
+    return appendNode(paramList, param);
 }
 
 
-TreeNode *newParam(TreeNode *typeSpecifier, char *ID, int isArray, int lineno) {
-
-    ASSERT(typeSpecifier->type == TYPE_INTEGER) {
-        fprintf(stderr, "Error: @line %d, type specifier of param %s must be int.\n", lineno, ID);
-    }
-    pushTable(ParamST);
-    ASSERT(getTopVar(ID) == NULL) {
-        fprintf(stderr, "Error: @line %d, duplicate declarations of variable %s.\n", lineno, ID);
-    }
+TreeNode *newParam(CompilerContext *ctx, TreeNode *typeSpecifier, char *ID, int isArray, int offset) {
 
     TreeNode *root;
     if(!isArray) {
-        root = newASTNode(PARAMID_AST, lineno);
-        root->child[0] = typeSpecifier;
-        root->attr.name = strdup(ID);
+        root = newASTNode(ctx, PARAMID_AST, offset);
         root->type = TYPE_INTEGER;
-        putVariable(root->attr.name, PARAM, ParamST->size++ , TYPE_INTEGER);
     } else {
-        root = newASTNode(PARAMARRAY_AST, lineno);
-        root->child[0] = typeSpecifier;
-        root->attr.name = strdup(ID);
+        root = newASTNode(ctx, PARAMARRAY_AST, offset);
         root->type = TYPE_ARRAY;
-        putVariable(root->attr.name, PARAM, ParamST->size++ , TYPE_ARRAY);
     }
-    popTable();
+    root->child[0] = typeSpecifier;
+    root->attr.name = ID;
+
     return root;
 }
 
 
-TreeNode *newCompound(TreeNode *localDecs, TreeNode *stmtList, int lineno) {
+TreeNode *newCompound(CompilerContext *ctx, TreeNode *localDecs, TreeNode *stmtList, int offset) {
 
-    TreeNode *root = newASTNode(COMPOUND_AST, lineno);
+    TreeNode *root = newASTNode(ctx, COMPOUND_AST, offset);
     root->child[0] = localDecs;
     root->child[1] = stmtList;
 
-    if(stmtList != NULL && stmtList->type != TYPE_UNDEFINED) {
-        root->type = stmtList->type;
-    } else {
-        root->type = TYPE_VOID;
-    }
     return root;
 }
 
 
-TreeNode *newLocalDecs(TreeNode *localDecs, TreeNode *varDec) {
-
-    if(localDecs == NULL)
-        return varDec;
-    TreeNode *node = localDecs;
-    while(node->sibling != NULL) {
-        node = node->sibling;
-    }
-    node->sibling = varDec;
+NodeList newLocalDecs(NodeList localDecs, TreeNode *varDec) {
 
-    return localDecs;
+    return appendNode(localDecs, varDec);
 }
 
 
-TreeNode *newStmtList(TreeNode *stmtList, TreeNode *stmt, int lineno) {
+NodeList newStmtList(NodeList stmtList, TreeNode *stmt) {
 
-    if(stmtList == NULL)
-        return stmt;
-    TreeNode *node = stmtList;
-    while(node->sibling != NULL) {
-        node = node->sibling;
-    }
-    node->sibling = stmt;
-
-    return stmtList;
+    return appendNode(stmtList, stmt);
 }
 
 
-TreeNode *newSelectStmt(TreeNode *expression, TreeNode *stmt, TreeNode *elseStmt, int lineno) {
+TreeNode *newSelectStmt(CompilerContext *ctx, TreeNode *expression, TreeNode *stmt, TreeNode *elseStmt, int offset) {
 
-    ASSERT(expression->type == TYPE_INTEGER) {
-        fprintf(stderr, "Error: @line %d, test condition expression not integer.\n", lineno);
-    }
-    TreeNode *root = newASTNode(SELESTMT_AST, lineno);
+    TreeNode *root = newASTNode(ctx, SELESTMT_AST, offset);
     root->child[0] = expression;
     root->child[1] = stmt;
     root->child[2] = elseStmt;
@@ -227,12 +139,9 @@ TreeNode *newSelectStmt(TreeNode *expression, TreeNode *stmt, TreeNode *elseStmt
 }
 
 
-TreeNode *newIterStmt(TreeNode *expression,  TreeNode *stmt, int lineno) {
+TreeNode *newIterStmt(CompilerContext *ctx, TreeNode *expression,  TreeNode *stmt, int offset) {
 
-    ASSERT(expression->type == TYPE_INTEGER) {
-        fprintf(stderr, "Error: @line %d, test condition expression not integer.\n", lineno);
-    }
-    TreeNode *root = newASTNode(ITERSTMT_AST, lineno);
+    TreeNode *root = newASTNode(ctx, ITERSTMT_AST, offset);
     root->child[0] = expression;
     root->child[1] = stmt;
 
@@ -240,273 +149,116 @@ TreeNode *newIterStmt(TreeNode *expression,  TreeNode *stmt, int lineno) {
 }
 
 
-TreeNode *newRetStmt(TreeNode *expression, int lineno) {
-    ExpType type;
+TreeNode *newRetStmt(CompilerContext *ctx, TreeNode *expression, int offset) {
 
-    if(expression!= NULL) {
-        type = expression->type;
-    } else {
-        type = TYPE_VOID;
-    }
-    ASSERT(type == current_fun->type) {
-        fprintf(stderr, "Error: @line %d, return type mis-match.\n", lineno);
-    }
-    TreeNode *root = newASTNode(RETSTMT_AST, lineno);
+    TreeNode *root = newASTNode(ctx, RETSTMT_AST, offset);
     root->child[0] = expression;
-    root->type = type;
-    if (Table)
-    	printSymTab(CompoundST);
 
     return root;
 }
 
 
-TreeNode *newAssignExp(TreeNode *var, TreeNode *expression, int lineno) {
+TreeNode *newAssignExp(CompilerContext *ctx, TreeNode *var, TreeNode *expression, int offset) {
 
-    ASSERT(var->type==TYPE_INTEGER && expression->type==TYPE_INTEGER) {
-        fprintf(stderr, "Error: @line %d, only can assign int to int.\n", lineno);
-    }
-    TreeNode *root = newASTNode(ASSIGN_AST, lineno);
+    TreeNode *root = newASTNode(ctx, ASSIGN_AST, offset);
     root->child[0] = var;
     root->child[1] = expression;
-    root->type = TYPE_INTEGER;
 
     return root;
 }
 
 
-TreeNode *newVar(char *ID, int lineno) {
+TreeNode *newVar(CompilerContext *ctx, char *ID, int offset) {
 
-    pushTable(CompoundST);
-    VarSymbol *vs = getVariable(ID);
-    ASSERT(vs != NULL) {
-        fprintf(stderr, "Error: @line %d, variable %s not defined before.\n", lineno, ID);
-    }
-    popTable();
-    TreeNode *root = newASTNode(VAR_AST, lineno);
-    root->attr.name = vs->name;
-    root->type = vs->type;
+    TreeNode *root = newASTNode(ctx, VAR_AST, offset);
+    root->attr.name = ID;
 
     return root;
 }
 
 
-TreeNode *newArrayVar(char *ID, TreeNode *expression, int lineno) {
-
-    ASSERT(expression->type == TYPE_INTEGER) {
-        fprintf(stderr, "Error: @line %d, array %s: index is not integer.\n", lineno, ID);
+TreeNode *newArrayVar(CompilerContext *ctx, char *ID, TreeNode *expression, int offset) {
 
-    }
-    pushTable(CompoundST);
-    VarSymbol *vs = getVariable(ID);
-    ASSERT(vs != NULL) {
-        fprintf(stderr, "Error: @line %d, variable %s not defined before.\n", lineno, ID);
-    }
-    popTable();
-    ASSERT(vs->type == TYPE_ARRAY) {
-        fprintf(stderr, "Error: @line %d, variable %s is not an array.\n", lineno, ID);
-    }
-    TreeNode *root = newASTNode(ARRAYVAR_AST, lineno);
+    TreeNode *root = newASTNode(ctx, ARRAYVAR_AST, offset);
     root->child[0] = expression;
-    root->attr.name = vs->name;
-    root->type = TYPE_INTEGER;
+    root->attr.name = ID;
 
     return root;
 }
 
 
-TreeNode *newSimpExp(TreeNode *addExp1, int relop, TreeNode *addExp2, int lineno) {
+TreeNode *newSimpExp(CompilerContext *ctx, TreeNode *addExp1, int relop, TreeNode *addExp2, int offset) {
 
-    ASSERT(addExp1->type == TYPE_INTEGER && addExp2->type == TYPE_INTEGER) {
-        fprintf(stderr, "Error: @line %d, only can compare integers.\n", lineno);
-    }
-    TreeNode *root = newASTNode(EXP_AST, lineno);
+    TreeNode *root = newASTNode(ctx, EXP_AST, offset);
     root->child[0] = addExp1;
     root->child[1] = addExp2;
     root->attr.op = relop;
-    root->type = TYPE_INTEGER;
 
     return root;
 }
 
 
-TreeNode *newAddExp(TreeNode *addExp, int addop, TreeNode *term, int lineno) {
+TreeNode *newAddExp(CompilerContext *ctx, TreeNode *addExp, int addop, TreeNode *term, int offset) {
 
-    ASSERT(addExp->type == TYPE_INTEGER && term->type == TYPE_INTEGER) {
-        fprintf(stderr, "Error: @line %d, only can calculate integers.\n", lineno);
-    }
-    TreeNode *root = newASTNode(EXP_AST, lineno);
+    TreeNode *root = newASTNode(ctx, EXP_AST, offset);
     root->child[0] = addExp;
     root->child[1] = term;
     root->attr.op = addop;
-    root->type = TYPE_INTEGER;
 
     return root;
 }
 
 
-TreeNode *newTerm(TreeNode *term, int mulop, TreeNode *factor, int lineno) {
-
-    ASSERT(term->type == TYPE_INTEGER && factor->type == TYPE_INTEGER) {
-        fprintf(stderr, "Error: @line %d, only can calculate integers.\n", lineno);
+TreeNode *newTerm(CompilerContext *ctx, TreeNode *term, int mulop, TreeNode *factor, int offset) {
 
-    }
-    TreeNode *root = newASTNode(EXP_AST, lineno);
+    TreeNode *root = newASTNode(ctx, EXP_AST, offset);
     root->child[0] = term;
     root->child[1] = factor;
     root->attr.op = mulop;
-    root->type = TYPE_INTEGER;
 
     return root;
 }
 
 
-TreeNode *newNumNode(int value, int lineno) {
+TreeNode *newNumNode(CompilerContext *ctx, int value, int offset) {
 
-    TreeNode *root = newASTNode(NUM_AST, lineno);
+    TreeNode *root = newASTNode(ctx, NUM_AST, offset);
     root->attr.value = value;
-    root->type = TYPE_INTEGER;
 
     return root;
 }
 
 
-TreeNode *newCall(char *ID, TreeNode *args, int lineno) {
+TreeNode *newCall(CompilerContext *ctx, char *ID, TreeNode *args, int offset) {
 
-    FunSymbol *fun = getFunction(ID);
-    ASSERT(fun != NULL) {
-        fprintf(stderr, "Error: @line %d, call function %s which is not defined.\n", lineno, ID);
-    }
-    VarSymbol *var = fun->symbolTable->varList;
-    TreeNode *tmp = args;
-    while(var && tmp) {
-        ASSERT(var->type == tmp->type) {
-            fprintf(stderr, "Error: @line %d, call function %s : parameter type mis-match.\n", lineno, ID);
-        }
-        var = var->next_FIFO;
-        tmp = tmp->sibling;
-    }
-    ASSERT(!var && !tmp) {
-        fprintf(stderr, "Error: @line %d, call function %s : parameter number mis-match.\n", lineno, ID);
-    }
-    TreeNode *root = newASTNode(CALL_AST, lineno);
+    TreeNode *root = newASTNode(ctx, CALL_AST, offset);
     root->child[0] = args;
-    root->attr.name = strdup(ID);
-    root->type = fun->type;
+    root->attr.name = ID;
 
     return root;
 }
 
 
-TreeNode *newArgList(TreeNode *argList, TreeNode *expression) {
+NodeList newArgList(NodeList argList, TreeNode *expression) {
 
-    TreeNode *node = argList;
-    while(node->sibling != NULL) {
-        node = node->sibling;
-    }
-    node->sibling = expression;
-
-    return argList;
+    return appendNode(argList, expression);
 }
 
 
-TreeNode *newASTNode(ASTType type, int lineno) {
+TreeNode *newASTNode(CompilerContext *ctx, ASTType type, int offset) {
 	int i;
 
-    TreeNode *node = (TreeNode*)malloc(sizeof(TreeNode));
-    ASSERT(node != NULL) {
-        fprintf(stderr, "Failed to malloc for TreeNode @line%d.\n", lineno);
-    }
+    TreeNode *node = (TreeNode*)arenaAlloc(ctx, &ctx->treeArena, MEM_TREENODE, sizeof(TreeNode));
     for(i=0; i<MAXCHILDREN; ++i) {
         node->child[i] = NULL;
     }
     node->sibling = NULL;
     node->astType = type;
     node->type = TYPE_UNDEFINED;
-    node->lineno = lineno;
+    node->offset = offset;
+    node->attr.op = 0;
+    node->attr.value = 0;
+    node->attr.name = NULL;
 
     return node;
 }
-
-
-void printNodeKind(TreeNode *node) {
-    if(node == NULL)
-        return;
-
-    switch(node->astType) {
-    case VARDEC_AST:
-        printf("Var declaration \n");
-        break;
-    case ARRAYDEC_AST:
-        printf("Array declaration \n");
-        break;
-    case FUNDEC_AST:
-        printf("Function declaration \n");
-        break;
-    case TYPE_AST:
-        printf("Type specifier \n");
-        break;
-    case PARAMID_AST:
-        printf("Param of ID \n");
-        break;
-    case PARAMARRAY_AST:
-        printf("Param of Array \n");
-        break;
-    case COMPOUND_AST:
-        printf("Counpound statements \n");
-        break;
-    case EXPSTMT_AST:
-        printf("Expression statement\n");
-        break;
-    case SELESTMT_AST:
-        printf("Select statement\n");
-        break;
-    case ITERSTMT_AST:
-        printf("Iteration statement\n");
-        break;
-    case RETSTMT_AST:
-        printf("Return statement\n");
-        break;
-    case ASSIGN_AST:
-        printf("Assign statement\n");
-        break;
-    case EXP_AST:
-        printf("Expression \n");
-        break;
-    case VAR_AST:
-        printf("Var \n");
-        break;
-    case ARRAYVAR_AST:
-        printf("Array var ASt\n");
-        break;
-    case FACTOR_AST:
-        printf("Factor \n");
-        break;
-    case CALL_AST:
-        printf("Call stement \n");
-        break;
-    case NUM_AST:
-        printf("Number \n");
-        break;
-    default:
-    	break;
-    }
-}
-
-
-void printAST(TreeNode *root, int indent) {
-	int i;
-
-    TreeNode *node = root;
-    while(node != NULL) {
-        for (i = 0; i<indent; ++i) {
-            printf("  ");
-        }
-        printNodeKind(node);
-        printAST(node->child[0], indent+4);
-        printAST(node->child[1], indent+4);
-        printAST(node->child[2], indent+4);
-        printAST(node->child[3], indent+4);
-        node = node->sibling;
-    }
-}
@@ -0,0 +1,135 @@
+/*********************************************************************
+ * FILE NAME: Timer.c
+ * AUTHOR: Andrew O'Donohue
+ * PURPOSE: Wall and CPU time accounting for -ftime-report.
+ *********************************************************************/
+#include <time.h>
+#include "globals.h"
+#include "Timer.h"
+
+static const char *phaseNames[PHASE_COUNT] = {
+    "scan", "parse", "semantic", "symbol tables", "code generation", "output"
+};
+
+static const char *phaseKeys[PHASE_COUNT] = {
+    "scan", "parse", "semantic", "symtab", "codegen", "output"
+};
+
+
+/*********************************************************************
+ * FUNCTION NAME: timerMark
+ * PURPOSE: Charges the wall time since the last mark to the innermost
+ *          phase. The thread CPU clock is a system call, so it is only
+ *          read when the outermost phase begins or ends; the CPU time
+ *          in between is shared out in proportion to wall time
+ * ARGUMENTS: . The timer (PhaseTimer *)
+ *            . Whether the outermost phase begins or ends here (int)
+ *********************************************************************/
+static void timerMark(PhaseTimer *timer, int outermost) {
+
+    struct timespec wall, cpu;
+    int i;
+
+    clock_gettime(CLOCK_MONOTONIC, &wall);
+    double nowWall = wall.tv_sec + wall.tv_nsec / 1e9;
+    if(timer->depth > 0) {
+        Phase phase = timer->stack[timer->depth - 1];
+        timer->wall[phase] += nowWall - timer->markWall;
+        timer->spanWall[phase] += nowWall - timer->markWall;
+    }
+    timer->markWall = nowWall;
+    if(!outermost)
+        return;
+
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &cpu);
+    double nowCpu = cpu.tv_sec + cpu.tv_nsec / 1e9;
+    double spanWall = 0;
+    for(i=0; i<PHASE_COUNT; ++i)
+        spanWall += timer->spanWall[i];
+    for(i=0; i<PHASE_COUNT; ++i) {
+        if(spanWall > 0)
+            timer->cpu[i] += (nowCpu - timer->markCpu) * timer->spanWall[i] / spanWall;
+        timer->spanWall[i] = 0;
+    }
+    timer->markCpu = nowCpu;
+}
+
+
+void timerStart(CompilerContext *ctx, Phase phase) {
+
+    PhaseTimer *timer = &ctx->timer;
+    if(!timer->enabled)
+        return;
+    timerMark(timer, timer->depth == 0);
+    ASSERT(timer->depth < PHASE_DEPTH) {
+        fprintf(stderr, "Phases nested deeper than %d.\n", PHASE_DEPTH);
+    }
+    timer->stack[timer->depth++] = phase;
+    timer->calls[phase]++;
+}
+
+
+void timerStop(CompilerContext *ctx) {
+
+    PhaseTimer *timer = &ctx->timer;
+    if(!timer->enabled || timer->depth == 0)
+        return;
+    timerMark(timer, timer->depth == 1);
+    timer->depth--;
+}
+
+
+void timerUnwind(CompilerContext *ctx, int depth) {
+
+    PhaseTimer *timer = &ctx->timer;
+    if(!timer->enabled || timer->depth <= depth)
+        return;
+    timerMark(timer, depth == 0);
+    timer->depth = depth;
+}
+
+
+void timerAdd(PhaseTimer *total, const PhaseTimer *timer) {
+
+    int i;
+    for(i=0; i<PHASE_COUNT; ++i) {
+        total->wall[i] += timer->wall[i];
+        total->cpu[i] += timer->cpu[i];
+        total->calls[i] += timer->calls[i];
+    }
+}
+
+
+void printTimeReport(FILE *out, const PhaseTimer *timer, int files, ReportFormat format) {
+
+    double wall = 0, cpu = 0;
+    int i;
+
+    for(i=0; i<PHASE_COUNT; ++i) {
+        wall += timer->wall[i];
+        cpu += timer->cpu[i];
+    }
+
+    if(format == REPORT_JSON) {
+        fprintf(out, "{\"files\": %d, \"phases\": {", files);
+        for(i=0; i<PHASE_COUNT; ++i) {
+            fprintf(out, "%s\"%s\": {\"wall_ms\": %.3f, \"cpu_ms\": %.3f, \"calls\": %ld}",
+                    i ? ", " : "", phaseKeys[i], timer->wall[i] * 1e3, timer->cpu[i] * 1e3,
+                    timer->calls[i]);
+        }
+        fprintf(out, "}, \"total\": {\"wall_ms\": %.3f, \"cpu_ms\": %.3f}}\n",
+                wall * 1e3, cpu * 1e3);
+        return;
+    }
+
+    fprintf(out, "\nTime report (%d file%s)\n", files, files == 1 ? "" : "s");
+    fprintf(out, "Phase              Wall (ms)   CPU (ms)  Wall %%      Calls\n");
+    fprintf(out, "---------------  ----------  ---------  ------  ---------\n");
+    for(i=0; i<PHASE_COUNT; ++i) {
+        fprintf(out, "%-15s  %10.3f  %9.3f  %5.1f%%  %9ld\n", phaseNames[i],
+                timer->wall[i] * 1e3, timer->cpu[i] * 1e3,
+                wall > 0 ? 100 * timer->wall[i] / wall : 0.0, timer->calls[i]);
+    }
+    fprintf(out, "---------------  ----------  ---------  ------  ---------\n");
+    fprintf(out, "%-15s  %10.3f  %9.3f  %5.1f%%\n", "total", wall * 1e3, cpu * 1e3, 100.0);
+}
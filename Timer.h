@@ -0,0 +1,61 @@
+/*********************************************************************
+ * FILE NAME: Timer.h
+ * AUTHOR: Andrew O'Donohue
+ * PURPOSE: Timer.c public interface.
+ *********************************************************************/
+#ifndef TIMER_H
+#define TIMER_H
+
+#include "globals.h"
+
+
+/*********************************************************************
+ * FUNCTION NAME: timerStart
+ * PURPOSE: Enters a phase. Time is charged to the innermost phase
+ *          only, so nested phases are not counted twice. Does nothing
+ *          unless ctx->timer.enabled is set
+ * ARGUMENTS: . The compilation context (CompilerContext *)
+ *            . The phase being entered (Phase)
+ *********************************************************************/
+void timerStart(CompilerContext *ctx, Phase phase);
+
+
+/*********************************************************************
+ * FUNCTION NAME: timerStop
+ * PURPOSE: Leaves the innermost phase
+ * ARGUMENTS: The compilation context (CompilerContext *)
+ *********************************************************************/
+void timerStop(CompilerContext *ctx);
+
+
+/*********************************************************************
+ * FUNCTION NAME: timerUnwind
+ * PURPOSE: Leaves every phase entered after the given depth, for use
+ *          after a semantic error has unwound the parser
+ * ARGUMENTS: . The compilation context (CompilerContext *)
+ *            . The depth to return to (int)
+ *********************************************************************/
+void timerUnwind(CompilerContext *ctx, int depth);
+
+
+/*********************************************************************
+ * FUNCTION NAME: timerAdd
+ * PURPOSE: Adds the times of one compilation to a running total
+ * ARGUMENTS: . The total (PhaseTimer *)
+ *            . The times to add (const PhaseTimer *)
+ *********************************************************************/
+void timerAdd(PhaseTimer *total, const PhaseTimer *timer);
+
+
+/*********************************************************************
+ * FUNCTION NAME: printTimeReport
+ * PURPOSE: Prints the wall and CPU time spent in each phase
+ * ARGUMENTS: . The stream to print to (FILE *)
+ *            . The times to print (const PhaseTimer *)
+ *            . The number of files compiled (int)
+ *            . REPORT_TEXT for a table or REPORT_JSON (ReportFormat)
+ *********************************************************************/
+void printTimeReport(FILE *out, const PhaseTimer *timer, int files, ReportFormat format);
+
+
+#endif
@@ -0,0 +1,742 @@
+/*********************************************************************
+ * FILE NAME: Tokens.c
+ * AUTHOR: Andrew O'Donohue
+ * PURPOSE: Ways of feeding the parser other than calling the scanner
+ *          for each token. -ftokens=array tokenizes a whole source up
+ *          front, so the scanner and the parser run, and are timed,
+ *          separately. -ftokens=pipeline runs the scanner on a thread
+ *          of its own, passing tokens to the parser through a ring.
+ *          -ftokens=parallel fills the token array by tokenizing
+ *          pieces of a large source on several threads. Incremental
+ *          sessions keep the token array of the last source and
+ *          scan again only the part of it an edit changed.
+ *********************************************************************/
+#define _GNU_SOURCE
+#include <stdatomic.h>
+#include <sched.h>
+#include <time.h>
+#include <unistd.h>
+#include "globals.h"
+#include "parse.h"
+#include "Atom.h"
+#include "Constant.h"
+#include "Location.h"
+#include "Tokens.h"
+
+#define IS_LETTER(c) ((unsigned int)(((c) | 0x20) - 'a') < 26)
+#define IS_DIGIT(c)  ((unsigned int)((c) - '0') < 10)
+
+/* Slots in the pipeline ring, a power of two. */
+#define PIPE_SIZE 4096
+/* Times a thread polls the ring before yielding the processor. */
+#define PIPE_SPINS 128
+
+/* Sources are not split into pieces smaller than this. */
+#define CHUNK_MIN (64 * 1024)
+
+int yylex(YYSTYPE *lvalp, void *scanner);
+int yylex_init_extra(CompilerContext *ctx, void **scanner);
+int yylex_destroy(void *scanner);
+char *yyget_text(void *scanner);
+struct yy_buffer_state *yy_scan_bytes(const char *bytes, int len, void *scanner);
+void yy_delete_buffer(struct yy_buffer_state *buffer, void *scanner);
+void scanFrom(void *scanner, int offset);
+
+typedef struct token_slot TokenSlot;
+struct token_slot {
+    int kind;
+    int offset;
+    int strays;
+    YYSTYPE value;
+};
+
+/* One piece of a source for -ftokens=parallel. Each piece has a
+ * scanner and a context of its own, so its thread shares nothing with
+ * the others: identifiers are interned in the piece's own atom table,
+ * and unmatched characters are noted in the piece's own list. */
+typedef struct lex_chunk LexChunk;
+struct lex_chunk {
+    CompilerContext ctx;
+    const char *start;
+    size_t len;
+    pthread_t thread;
+};
+
+/* head is written only by the scanner thread and tail only by the
+ * parser thread, each on a cache line of its own. Each thread keeps
+ * the last value it read of the other's index, so the shared lines
+ * are only read when the ring looks full or empty. */
+struct token_pipe {
+    TokenSlot ring[PIPE_SIZE];
+    _Alignas(64) atomic_uint head;
+    unsigned int tailSeen;
+    _Alignas(64) atomic_uint tail;
+    unsigned int headSeen;
+    atomic_int stop;
+    _Alignas(64) TokenSlot last;
+    CompilerContext *ctx;
+    pthread_t thread;
+    double scanWall;
+    double scanCpu;
+};
+
+
+/*********************************************************************
+ * FUNCTION NAME: growTokens
+ * PURPOSE: Doubles the capacity of each array of the token array
+ * ARGUMENTS: The token array (TokenArray *)
+ *********************************************************************/
+static void growTokens(TokenArray *tokens) {
+
+    tokens->cap = tokens->cap == 0 ? 4096 : tokens->cap * 2;
+    tokens->kind = (short *)realloc(tokens->kind, tokens->cap * sizeof(short));
+    tokens->payload = (int *)realloc(tokens->payload, tokens->cap * sizeof(int));
+    tokens->offset = (int *)realloc(tokens->offset, tokens->cap * sizeof(int));
+    ASSERT(tokens->kind != NULL && tokens->payload != NULL && tokens->offset != NULL) {
+        fprintf(stderr, "Failed to grow token array.\n");
+    }
+}
+
+
+/*********************************************************************
+ * FUNCTION NAME: pushToken
+ * PURPOSE: Appends a token just returned by the scanner
+ * ARGUMENTS: . The token array (TokenArray *)
+ *            . The token (int)
+ *            . Its semantic value (YYSTYPE *)
+ *            . Its offset in the source (int)
+ *********************************************************************/
+static void pushToken(TokenArray *tokens, int token, YYSTYPE *lval, int offset) {
+
+    int i;
+
+    if(tokens->count == tokens->cap)
+        growTokens(tokens);
+    i = tokens->count++;
+    tokens->kind[i] = (short)token;
+    tokens->payload[i] = token == ID ? ATOM(lval->name)->id : token == NUMBER ? lval->value : 0;
+    tokens->offset[i] = offset;
+}
+
+
+void noteStray(CompilerContext *ctx, int offset, char c) {
+
+    if(ctx->tokenMode == TOKENS_PULL) {
+        ctx->strays++;
+        fprintf(ctx->diagnostics, "MISS MATCH: %c\n", c);
+        return;
+    }
+
+    /* With -ftokens=pipeline the parser thread may be printing the
+     * offsets already noted while this one adds to them. */
+    if(ctx->tokenMode == TOKENS_PIPELINE)
+        pthread_mutex_lock(&ctx->internLock);
+    if(ctx->strays == ctx->strayCap) {
+        ctx->strayCap = ctx->strayCap == 0 ? 16 : ctx->strayCap * 2;
+        ctx->strayOffsets = (int *)realloc(ctx->strayOffsets, ctx->strayCap * sizeof(int));
+        ASSERT(ctx->strayOffsets != NULL) {
+            fprintf(stderr, "Failed to grow unmatched character list.\n");
+        }
+    }
+    ctx->strayOffsets[ctx->strays++] = offset;
+    if(ctx->tokenMode == TOKENS_PIPELINE)
+        pthread_mutex_unlock(&ctx->internLock);
+}
+
+
+/*********************************************************************
+ * FUNCTION NAME: showStrays
+ * PURPOSE: Prints the messages of the noted unmatched characters that
+ *          come before a token the parser is about to take
+ * ARGUMENTS: . The compilation context (CompilerContext *)
+ *            . The offset of the token (int)
+ *            . The number of characters noted before the token was
+ *              scanned (int)
+ *********************************************************************/
+static void showStrays(CompilerContext *ctx, int offset, int noted) {
+
+    if(ctx->tokenMode == TOKENS_PIPELINE)
+        pthread_mutex_lock(&ctx->internLock);
+    while(ctx->straysShown < noted && ctx->strayOffsets[ctx->straysShown] < offset)
+        fprintf(ctx->diagnostics, "MISS MATCH: %c\n", ctx->source[ctx->strayOffsets[ctx->straysShown++]]);
+    if(ctx->tokenMode == TOKENS_PIPELINE)
+        pthread_mutex_unlock(&ctx->internLock);
+}
+
+
+void tokenizeAll(CompilerContext *ctx) {
+
+    TokenArray *tokens = &ctx->tokens;
+    YYSTYPE lval;
+    int token;
+
+    tokens->count = 0;
+    tokens->next = 0;
+    do {
+        token = yylex(&lval, ctx->scanner);
+        pushToken(tokens, token, &lval, ctx->tokenOffset);
+    } while(token != 0);
+}
+
+
+/*********************************************************************
+ * FUNCTION NAME: splitChunks
+ * PURPOSE: Chooses where the pieces of a source start. Each piece
+ *          after the first starts after a newline near its share of
+ *          the source, or after the comment that newline is in. A
+ *          comment is the only token that spans lines, and there are
+ *          no string literals, so one pass finding the comments in
+ *          order is enough to tell whether a point is inside one
+ * ARGUMENTS: . The source text (const char *)
+ *            . The length of the text (size_t)
+ *            . The number of pieces (int)
+ *            . Set to the offset each piece starts at, followed by
+ *              len (size_t *)
+ *********************************************************************/
+static void splitChunks(const char *source, size_t len, int count, size_t *starts) {
+
+    size_t open = 0, close = 0, from = 0, at;
+    const char *p;
+    int k;
+
+    starts[0] = 0;
+    for(k = 1; k < count; ++k) {
+        at = len / count * k;
+        if(at < starts[k - 1])
+            at = starts[k - 1];
+        p = (const char *)memchr(source + at, '\n', len - at);
+        at = p != NULL ? (size_t)(p - source) + 1 : len;
+
+        /* Find the comments in order until one ends beyond at. */
+        while(close <= at && from < len) {
+            p = (const char *)memmem(source + from, len - from, "/*", 2);
+            if(p == NULL) {
+                open = close = from = len;
+                break;
+            }
+            open = p - source;
+            p = (const char *)memmem(p + 2, len - open - 2, "*/", 2);
+            close = from = p != NULL ? (size_t)(p - source) + 2 : len;
+        }
+        if(open < at && at < close)
+            at = close;
+        starts[k] = at;
+    }
+    starts[count] = len;
+}
+
+
+/*********************************************************************
+ * FUNCTION NAME: lexChunk
+ * PURPOSE: A thread of -ftokens=parallel. Tokenizes one piece into
+ *          the token array of the piece's context
+ * ARGUMENTS: The piece (LexChunk *)
+ * RETURNS: NULL
+ *********************************************************************/
+static void *lexChunk(void *arg) {
+
+    LexChunk *chunk = (LexChunk *)arg;
+    CompilerContext *ctx = &chunk->ctx;
+    struct yy_buffer_state *buffer = yy_scan_bytes(chunk->start, (int)chunk->len, ctx->scanner);
+
+    ASSERT(buffer != NULL) {
+        fprintf(stderr, "Failed to create scanner buffer.\n");
+    }
+    tokenizeAll(ctx);
+    yy_delete_buffer(buffer, ctx->scanner);
+    return NULL;
+}
+
+
+void tokenizeChunks(CompilerContext *ctx, const char *source, size_t len) {
+
+    TokenArray *tokens = &ctx->tokens;
+    int count = ctx->lexThreads > 0 ? ctx->lexThreads : (int)sysconf(_SC_NPROCESSORS_ONLN);
+    LexChunk *chunks;
+    size_t *starts;
+    int *ids, *values;
+    int total = 0;
+    int i, j, k;
+
+    if(count > (int)(len / CHUNK_MIN))
+        count = (int)(len / CHUNK_MIN);
+    if(count <= 1) {
+        tokenizeAll(ctx);
+        return;
+    }
+    chunks = (LexChunk *)calloc(count, sizeof(LexChunk));
+    starts = (size_t *)malloc((count + 1) * sizeof(size_t));
+    ASSERT(chunks != NULL && starts != NULL) {
+        fprintf(stderr, "Failed to malloc for source pieces.\n");
+    }
+    splitChunks(source, len, count, starts);
+    for(k = 0; k < count; ++k) {
+        LexChunk *chunk = &chunks[k];
+        chunk->start = source + starts[k];
+        chunk->len = starts[k + 1] - starts[k];
+        chunk->ctx.tokenMode = TOKENS_ARRAY;
+        ASSERT(yylex_init_extra(&chunk->ctx, &chunk->ctx.scanner) == 0) {
+            fprintf(stderr, "Failed to create scanner.\n");
+        }
+        ASSERT(pthread_create(&chunk->thread, NULL, lexChunk, chunk) == 0) {
+            fprintf(stderr, "Failed to start scanner thread.\n");
+        }
+    }
+    for(k = 0; k < count; ++k) {
+        pthread_join(chunks[k].thread, NULL);
+        total += chunks[k].ctx.tokens.count - 1;
+    }
+
+    /* Join the pieces, dropping the end of input of all but the last,
+     * moving offsets of tokens and unmatched characters past the
+     * pieces before, and renumbering each piece's atoms and constants
+     * as those of ctx. */
+    while(tokens->cap < total + 1)
+        growTokens(tokens);
+    tokens->count = 0;
+    tokens->next = 0;
+    for(k = 0; k < count; ++k) {
+        CompilerContext *piece = &chunks[k].ctx;
+        TokenArray *from = &piece->tokens;
+        int n = k == count - 1 ? from->count : from->count - 1;
+
+        for(j = 0; j < piece->strays; ++j)
+            noteStray(ctx, piece->strayOffsets[j] + (int)starts[k], 0);
+
+        ids = (int *)malloc((piece->atomCount + 1) * sizeof(int));
+        values = (int *)malloc((piece->constantCount + 1) * sizeof(int));
+        ASSERT(ids != NULL && values != NULL) {
+            fprintf(stderr, "Failed to malloc for source pieces.\n");
+        }
+        for(j = 0; j < piece->atomCount; ++j)
+            ids[j] = ATOM(internName(ctx, piece->atomNames[j]))->id;
+        for(j = 0; j < piece->constantCount; ++j)
+            values[j] = internValue(ctx, piece->constants[j]);
+        for(j = 0; j < n; ++j) {
+            int payload = from->payload[j];
+            i = tokens->count++;
+            tokens->kind[i] = from->kind[j];
+            if(from->kind[j] == ID)
+                payload = ids[payload];
+            else if(from->kind[j] == NUMBER && payload != CONSTANT_OVERFLOW)
+                payload = values[payload];
+            tokens->payload[i] = payload;
+            tokens->offset[i] = from->offset[j] + (int)starts[k];
+        }
+
+        free(ids);
+        free(values);
+        freeTokens(from);
+        free(piece->strayOffsets);
+        freeAtoms(piece);
+        freeConstants(piece);
+        yylex_destroy(piece->scanner);
+    }
+    free(chunks);
+    free(starts);
+}
+
+
+/*********************************************************************
+ * FUNCTION NAME: seedHistory
+ * PURPOSE: Interns the history's identifiers and constants in ctx in
+ *          the order they were first seen, so the atom ids and pool
+ *          indices its tokens carry mean the same in ctx
+ * ARGUMENTS: The compilation context (CompilerContext *)
+ *********************************************************************/
+static void seedHistory(CompilerContext *ctx) {
+
+    TokenHistory *history = ctx->history;
+    int i;
+
+    /* ctx was made the same way as the context the history was kept
+     * from, so the names it interned itself come first in both. */
+    for(i = ctx->atomCount; i < history->nameCount; ++i) {
+        ASSERT(ATOM(internName(ctx, history->names[i]))->id == i) {
+            fprintf(stderr, "Token history does not match the atom table.\n");
+        }
+    }
+    for(i = ctx->constantCount; i < history->valueCount; ++i)
+        internValue(ctx, history->values[i]);
+}
+
+
+/*********************************************************************
+ * FUNCTION NAME: lastBefore
+ * PURPOSE: Finds the last token starting before an offset
+ * ARGUMENTS: . The token array, which is not empty (TokenArray *)
+ *            . The offset (int)
+ * RETURNS: The token's index, or 0 if there is none (int)
+ *********************************************************************/
+static int lastBefore(const TokenArray *tokens, int offset) {
+
+    int low = 0, high = tokens->count - 1, middle;
+
+    while(low < high) {
+        middle = (low + high + 1) / 2;
+        if(tokens->offset[middle] < offset)
+            low = middle;
+        else
+            high = middle - 1;
+    }
+    return low;
+}
+
+
+void relexTokens(CompilerContext *ctx, size_t len) {
+
+    TokenHistory *history = ctx->history;
+    SourceEdit *edit = &ctx->edit;
+    TokenArray *tokens = &ctx->tokens;
+    TokenArray window;
+    YYSTYPE lval;
+    int first, start, k, n, tail, token, offset, delta, editEnd;
+
+    /* The characters no rule matched are only reported while they are
+     * scanned, so a source with any is scanned again in full. */
+    if(!history->valid || history->strays > 0 || edit->start < 0
+       || edit->removed < 0 || edit->inserted < 0
+       || edit->start + edit->removed > history->len
+       || (size_t)history->len - edit->removed + edit->inserted != len) {
+        history->valid = FALSE;
+        tokenizeAll(ctx);
+        return;
+    }
+    seedHistory(ctx);
+    *tokens = history->tokens;
+    memset(&history->tokens, 0, sizeof(TokenArray));
+    memset(&window, 0, sizeof(TokenArray));
+    tokens->next = 0;
+
+    /* The last token before the edit may run on into it, and the
+     * tokens before that one are unchanged. An edit before the first
+     * token may have opened a comment, so scanning starts at 0. */
+    first = lastBefore(tokens, edit->start);
+    start = tokens->offset[first] < edit->start ? tokens->offset[first] : 0;
+    delta = edit->inserted - edit->removed;
+    editEnd = edit->start + edit->inserted;
+    scanFrom(ctx->scanner, start);
+
+    /* After the edit the text is the same as before, shifted by delta.
+     * Once a token starts where one started before, the scanner is in
+     * the same state at the same text, and the rest of the old tokens
+     * stand. */
+    k = first;
+    for(;;) {
+        token = yylex(&lval, ctx->scanner);
+        offset = ctx->tokenOffset;
+        if(offset >= editEnd) {
+            while(k < tokens->count && tokens->offset[k] < offset - delta)
+                ++k;
+            if(k < tokens->count && tokens->offset[k] == offset - delta)
+                break;
+        }
+        pushToken(&window, token, &lval, offset);
+        if(token == 0) {
+            k = tokens->count;
+            break;
+        }
+    }
+
+    /* Replace tokens [first, k) by the window. */
+    tail = tokens->count - k;
+    n = first + window.count + tail;
+    while(tokens->cap < n)
+        growTokens(tokens);
+    memmove(tokens->kind + first + window.count, tokens->kind + k, tail * sizeof(short));
+    memmove(tokens->payload + first + window.count, tokens->payload + k, tail * sizeof(int));
+    memmove(tokens->offset + first + window.count, tokens->offset + k, tail * sizeof(int));
+    for(k = first + window.count; k < n; ++k)
+        tokens->offset[k] += delta;
+    if(window.count > 0) {
+        memcpy(tokens->kind + first, window.kind, window.count * sizeof(short));
+        memcpy(tokens->payload + first, window.payload, window.count * sizeof(int));
+        memcpy(tokens->offset + first, window.offset, window.count * sizeof(int));
+    }
+    tokens->count = n;
+    freeTokens(&window);
+}
+
+
+void keepTokens(CompilerContext *ctx) {
+
+    TokenHistory *history = ctx->history;
+    int i;
+
+    /* After a full scan ctx numbered its atoms and constants afresh. */
+    if(!history->valid) {
+        for(i = 0; i < history->nameCount; ++i)
+            free(history->names[i]);
+        history->nameCount = 0;
+        history->valueCount = 0;
+    }
+    freeTokens(&history->tokens);
+    history->tokens = ctx->tokens;
+    memset(&ctx->tokens, 0, sizeof(TokenArray));
+    history->len = ctx->sourceLen;
+    history->strays = ctx->strays;
+
+    if(ctx->atomCount > history->nameCap) {
+        history->nameCap = ctx->atomCap;
+        history->names = (char **)realloc(history->names, history->nameCap * sizeof(char *));
+    }
+    if(ctx->constantCount > history->valueCap) {
+        history->valueCap = ctx->constantCap;
+        history->values = (int *)realloc(history->values, history->valueCap * sizeof(int));
+    }
+    ASSERT((history->names != NULL || history->nameCap == 0) && (history->values != NULL || history->valueCap == 0)) {
+        fprintf(stderr, "Failed to grow token history.\n");
+    }
+    for(i = history->nameCount; i < ctx->atomCount; ++i) {
+        history->names[i] = strdup(ctx->atomNames[i]);
+        ASSERT(history->names[i] != NULL) {
+            fprintf(stderr, "Failed to grow token history.\n");
+        }
+    }
+    history->nameCount = ctx->atomCount;
+    for(i = history->valueCount; i < ctx->constantCount; ++i)
+        history->values[i] = ctx->constants[i];
+    history->valueCount = ctx->constantCount;
+    history->valid = TRUE;
+}
+
+
+void freeHistory(TokenHistory *history) {
+
+    int i;
+
+    for(i = 0; i < history->nameCount; ++i)
+        free(history->names[i]);
+    free(history->names);
+    free(history->values);
+    freeTokens(&history->tokens);
+    memset(history, 0, sizeof(TokenHistory));
+}
+
+
+/*********************************************************************
+ * FUNCTION NAME: waitTurn
+ * PURPOSE: Backs off while the ring is full or empty, polling first
+ *          and then yielding the processor to the other thread
+ * ARGUMENTS: The number of times the caller has waited so far (int)
+ *********************************************************************/
+static void waitTurn(int waits) {
+
+    if(waits < PIPE_SPINS) {
+#if defined(__x86_64__) || defined(__i386__)
+        __builtin_ia32_pause();
+#endif
+    } else
+        sched_yield();
+}
+
+
+/*********************************************************************
+ * FUNCTION NAME: pipeScanner
+ * PURPOSE: The scanner thread. Scans tokens into the ring until the
+ *          end of the input, or until the parser stops the pipeline
+ * ARGUMENTS: The pipeline (TokenPipe *)
+ * RETURNS: NULL
+ *********************************************************************/
+static void *pipeScanner(void *arg) {
+
+    TokenPipe *pipe = (TokenPipe *)arg;
+    CompilerContext *ctx = pipe->ctx;
+    unsigned int head = atomic_load_explicit(&pipe->head, memory_order_relaxed);
+    struct timespec wall, cpu;
+    TokenSlot *slot;
+    int waits;
+
+    clock_gettime(CLOCK_MONOTONIC, &wall);
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &cpu);
+    pipe->scanWall = -(wall.tv_sec + wall.tv_nsec / 1e9);
+    pipe->scanCpu = -(cpu.tv_sec + cpu.tv_nsec / 1e9);
+    do {
+        for(waits = 0; head - pipe->tailSeen == PIPE_SIZE; ++waits) {
+            if(atomic_load_explicit(&pipe->stop, memory_order_relaxed))
+                goto done;
+            pipe->tailSeen = atomic_load_explicit(&pipe->tail, memory_order_acquire);
+            if(head - pipe->tailSeen == PIPE_SIZE)
+                waitTurn(waits);
+        }
+        slot = &pipe->ring[head & (PIPE_SIZE - 1)];
+        slot->kind = yylex(&slot->value, ctx->scanner);
+        slot->offset = ctx->tokenOffset;
+        slot->strays = ctx->strays;
+        atomic_store_explicit(&pipe->head, ++head, memory_order_release);
+    } while(slot->kind != 0 && !atomic_load_explicit(&pipe->stop, memory_order_relaxed));
+done:
+    clock_gettime(CLOCK_MONOTONIC, &wall);
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &cpu);
+    pipe->scanWall += wall.tv_sec + wall.tv_nsec / 1e9;
+    pipe->scanCpu += cpu.tv_sec + cpu.tv_nsec / 1e9;
+    return NULL;
+}
+
+
+void startPipeline(CompilerContext *ctx) {
+
+    TokenPipe *pipe = (TokenPipe *)aligned_alloc(64, sizeof(TokenPipe));
+    ASSERT(pipe != NULL) {
+        fprintf(stderr, "Failed to malloc for token pipeline.\n");
+    }
+    memset(pipe, 0, sizeof(TokenPipe));
+    pipe->ctx = ctx;
+    pipe->last.kind = -1;
+    ctx->pipe = pipe;
+
+    /* The scanner marks the end of each match with a NUL in the
+     * source while it runs, so the lines are found before it starts,
+     * not when the parser thread first reports an error. */
+    if(ctx->lineStarts == NULL)
+        buildLines(ctx);
+    ASSERT(pthread_create(&pipe->thread, NULL, pipeScanner, pipe) == 0) {
+        fprintf(stderr, "Failed to start scanner thread.\n");
+    }
+}
+
+
+void stopPipeline(CompilerContext *ctx) {
+
+    TokenPipe *pipe = ctx->pipe;
+    if(pipe == NULL)
+        return;
+    atomic_store_explicit(&pipe->stop, 1, memory_order_relaxed);
+    pthread_join(pipe->thread, NULL);
+    if(ctx->timer.enabled) {
+        ctx->timer.wall[PHASE_SCAN] += pipe->scanWall;
+        ctx->timer.cpu[PHASE_SCAN] += pipe->scanCpu;
+        ctx->timer.calls[PHASE_SCAN]++;
+    }
+    free(pipe);
+    ctx->pipe = NULL;
+}
+
+
+/*********************************************************************
+ * FUNCTION NAME: pipeToken
+ * PURPOSE: Takes the next token out of the pipeline ring, waiting for
+ *          the scanner thread if the ring is empty
+ * ARGUMENTS: . The pipeline (TokenPipe *)
+ *            . The semantic value of the token (YYSTYPE *)
+ * RETURNS: The token, 0 at the end of the input (int)
+ *********************************************************************/
+static int pipeToken(TokenPipe *pipe, YYSTYPE *lvalp) {
+
+    unsigned int tail = atomic_load_explicit(&pipe->tail, memory_order_relaxed);
+    int waits;
+
+    /* The scanner thread has finished once it has sent the end. */
+    if(pipe->last.kind == 0) {
+        *lvalp = pipe->last.value;
+        return 0;
+    }
+    for(waits = 0; tail == pipe->headSeen; ++waits) {
+        pipe->headSeen = atomic_load_explicit(&pipe->head, memory_order_acquire);
+        if(tail == pipe->headSeen)
+            waitTurn(waits);
+    }
+    pipe->last = pipe->ring[tail & (PIPE_SIZE - 1)];
+    atomic_store_explicit(&pipe->tail, tail + 1, memory_order_release);
+    if(pipe->last.strays > pipe->ctx->straysShown)
+        showStrays(pipe->ctx, pipe->last.offset, pipe->last.strays);
+    *lvalp = pipe->last.value;
+    return pipe->last.kind;
+}
+
+
+int replayToken(CompilerContext *ctx, YYSTYPE *lvalp) {
+
+    TokenArray *tokens = &ctx->tokens;
+    int i;
+
+    if(ctx->pipe != NULL)
+        return pipeToken(ctx->pipe, lvalp);
+    i = tokens->next < tokens->count ? tokens->next++ : tokens->count - 1;
+    if(ctx->strays > ctx->straysShown)
+        showStrays(ctx, tokens->offset[i], ctx->strays);
+    switch(tokens->kind[i]) {
+    case ID:
+        lvalp->name = ctx->atomNames[tokens->payload[i]];
+        break;
+    case NUMBER:
+        lvalp->value = tokens->payload[i];
+        break;
+    }
+    return tokens->kind[i];
+}
+
+
+int tokenStart(CompilerContext *ctx) {
+
+    switch(ctx->tokenMode) {
+    case TOKENS_ARRAY:
+    case TOKENS_PARALLEL:
+    case TOKENS_INCREMENTAL:
+        if(ctx->tokens.next > 0)
+            return ctx->tokens.offset[ctx->tokens.next - 1];
+        break;
+    case TOKENS_PIPELINE:
+        if(ctx->pipe != NULL && ctx->pipe->last.kind >= 0)
+            return ctx->pipe->last.offset;
+        break;
+    default:
+        break;
+    }
+    return ctx->tokenOffset;
+}
+
+
+char *tokenText(CompilerContext *ctx) {
+
+    TokenArray *tokens = &ctx->tokens;
+    const char *text;
+    int kind, len;
+
+    if(ctx->tokenMode != TOKENS_PULL && ctx->tokenMode != TOKENS_PIPELINE && tokens->next > 0) {
+        kind = tokens->kind[tokens->next - 1];
+        text = ctx->source + tokens->offset[tokens->next - 1];
+    } else if(ctx->tokenMode == TOKENS_PIPELINE && ctx->pipe != NULL && ctx->pipe->last.kind >= 0) {
+        kind = ctx->pipe->last.kind;
+        text = ctx->source + ctx->pipe->last.offset;
+    } else
+        return yyget_text(ctx->scanner);
+    switch(kind) {
+    case 0:
+        len = 0;
+        break;
+    case EQ: case NE: case LE: case GE:
+        len = 2;
+        break;
+    default:
+        len = 1;
+        if(IS_LETTER(text[0])) {
+            while(IS_LETTER(text[len]))
+                ++len;
+        } else if(IS_DIGIT(text[0])) {
+            while(IS_DIGIT(text[len]))
+                ++len;
+        }
+        break;
+    }
+    if(len >= tokens->textCap) {
+        tokens->textCap = len + 16;
+        tokens->text = (char *)realloc(tokens->text, tokens->textCap);
+        ASSERT(tokens->text != NULL) {
+            fprintf(stderr, "Failed to malloc for token text.\n");
+        }
+    }
+    memcpy(tokens->text, text, len);
+    tokens->text[len] = '\0';
+    return tokens->text;
+}
+
+
+void freeTokens(TokenArray *tokens) {
+
+    free(tokens->kind);
+    free(tokens->payload);
+    free(tokens->offset);
+    free(tokens->text);
+    memset(tokens, 0, sizeof(TokenArray));
+}
@@ -0,0 +1,135 @@
+/*********************************************************************
+ * FILE NAME: Tokens.h
+ * AUTHOR: Andrew O'Donohue
+ * PURPOSE: Tokens.c public interface.
+ *********************************************************************/
+#ifndef TOKENS_H
+#define TOKENS_H
+
+#include "globals.h"
+#include "parse.h"
+
+
+/*********************************************************************
+ * FUNCTION NAME: noteStray
+ * PURPOSE: Reports a character no rule matched. When the parser calls
+ *          the scanner itself the message is printed at once; when it
+ *          reads tokens scanned ahead of it, the offset is noted and
+ *          the message printed as the parser takes the next token, so
+ *          messages come out in the same order either way
+ * ARGUMENTS: . The compilation context (CompilerContext *)
+ *            . The offset of the character (int)
+ *            . The character (char)
+ *********************************************************************/
+void noteStray(CompilerContext *ctx, int offset, char c);
+
+
+/*********************************************************************
+ * FUNCTION NAME: tokenizeAll
+ * PURPOSE: Runs the scanner over the whole of its current input,
+ *          storing every token in ctx->tokens for replayToken
+ * ARGUMENTS: The compilation context (CompilerContext *)
+ *********************************************************************/
+void tokenizeAll(CompilerContext *ctx);
+
+
+/*********************************************************************
+ * FUNCTION NAME: tokenizeChunks
+ * PURPOSE: tokenizeAll for large sources. Splits the source into
+ *          pieces that start outside comments, tokenizes them on
+ *          ctx->lexThreads threads and joins the results
+ * ARGUMENTS: . The compilation context (CompilerContext *)
+ *            . The source text (const char *)
+ *            . The length of the text (size_t)
+ *********************************************************************/
+void tokenizeChunks(CompilerContext *ctx, const char *source, size_t len);
+
+
+/*********************************************************************
+ * FUNCTION NAME: relexTokens
+ * PURPOSE: Fills ctx->tokens from ctx->history and ctx->edit, scanning
+ *          only from the last token before the edit until a token
+ *          starts where one did before it. Falls back to tokenizeAll
+ *          if the history is missing, had unmatched characters or
+ *          does not fit the edit
+ * ARGUMENTS: . The compilation context (CompilerContext *)
+ *            . The length of the edited source (size_t)
+ *********************************************************************/
+void relexTokens(CompilerContext *ctx, size_t len);
+
+
+/*********************************************************************
+ * FUNCTION NAME: keepTokens
+ * PURPOSE: Moves the tokens of a finished compilation into its
+ *          history, with copies of the names and values they refer to
+ * ARGUMENTS: The compilation context (CompilerContext *)
+ *********************************************************************/
+void keepTokens(CompilerContext *ctx);
+
+
+/*********************************************************************
+ * FUNCTION NAME: freeHistory
+ * PURPOSE: Releases what a token history holds
+ * ARGUMENTS: The token history (TokenHistory *)
+ *********************************************************************/
+void freeHistory(TokenHistory *history);
+
+
+/*********************************************************************
+ * FUNCTION NAME: replayToken
+ * PURPOSE: Returns the next token from the token array, or from the
+ *          pipeline if one is running, in place of yylex
+ * ARGUMENTS: . The compilation context (CompilerContext *)
+ *            . The semantic value of the token (YYSTYPE *)
+ * RETURNS: The token, 0 at the end of the input (int)
+ *********************************************************************/
+int replayToken(CompilerContext *ctx, YYSTYPE *lvalp);
+
+
+/*********************************************************************
+ * FUNCTION NAME: startPipeline
+ * PURPOSE: Starts a thread scanning the scanner's current input into
+ *          a ring that replayToken reads from
+ * ARGUMENTS: The compilation context (CompilerContext *)
+ *********************************************************************/
+void startPipeline(CompilerContext *ctx);
+
+
+/*********************************************************************
+ * FUNCTION NAME: stopPipeline
+ * PURPOSE: Stops and waits for the scanner thread, if one is running,
+ *          and adds its time to the scan phase
+ * ARGUMENTS: The compilation context (CompilerContext *)
+ *********************************************************************/
+void stopPipeline(CompilerContext *ctx);
+
+
+/*********************************************************************
+ * FUNCTION NAME: tokenStart
+ * PURPOSE: Gives the byte offset in the source of the token most
+ *          recently handed to the parser
+ * ARGUMENTS: The compilation context (CompilerContext *)
+ * RETURNS: The offset (int)
+ *********************************************************************/
+int tokenStart(CompilerContext *ctx);
+
+
+/*********************************************************************
+ * FUNCTION NAME: tokenText
+ * PURPOSE: Gives the text of the token most recently handed to the
+ *          parser, as yyget_text does for the scanner
+ * ARGUMENTS: The compilation context (CompilerContext *)
+ * RETURNS: The text, "" at the end of the input (char *)
+ *********************************************************************/
+char *tokenText(CompilerContext *ctx);
+
+
+/*********************************************************************
+ * FUNCTION NAME: freeTokens
+ * PURPOSE: Releases the token array
+ * ARGUMENTS: The token array (TokenArray *)
+ *********************************************************************/
+void freeTokens(TokenArray *tokens);
+
+
+#endif
@@ -0,0 +1,26 @@
+#!/bin/sh
+#####################################################################
+# FILE NAME: comments.sh
+# AUTHOR: Andrew O'Donohue
+# PURPOSE: Times the scanner on a comment dense program. Each
+#          function is preceded by a block comment of about 1 KB and
+#          its body is deeply indented.
+# USAGE: bench/comments.sh [functions] [runs]
+#        CM=<path> selects the compiler, ./cm by default
+#####################################################################
+CM=${CM:-./cm}
+FUNCTIONS=${1:-20000}
+RUNS=${2:-5}
+CORPUS=${TMPDIR:-/tmp}/cm-comments-$$.cm
+trap 'rm -f "$CORPUS"' EXIT
+
+"$(dirname "$0")/corpus.sh" comments "$FUNCTIONS" > "$CORPUS" || exit 1
+
+BYTES=$(wc -c < "$CORPUS")
+echo "corpus: $FUNCTIONS functions, $BYTES bytes"
+i=0
+while [ $i -lt "$RUNS" ]; do
+    "$CM" "$CORPUS" -ftime-report 2>&1 >/dev/null | awk -v bytes="$BYTES" '
+        $1 == "scan" { printf "scan %8.1f ms  %7.1f MB/s\n", $2, bytes / ($2 / 1000) / 1e6 }'
+    i=$((i + 1))
+done
@@ -0,0 +1,93 @@
+#!/bin/sh
+#####################################################################
+# FILE NAME: corpus.sh
+# AUTHOR: Andrew O'Donohue
+# PURPOSE: Writes a generated program to stdout for the benchmarks.
+#          Function names are letters only, since C minus has no
+#          digits in identifiers. The shapes are
+#            comments    N functions, each preceded by a block comment
+#                        of about 1 KB, with deeply indented bodies
+#            statements  one function of N statements
+#            functions   N functions of one line each
+#            table       N functions adding up part of a table
+# USAGE: bench/corpus.sh <shape> <N>
+#####################################################################
+case "$1" in
+comments|statements|functions|table) ;;
+*)
+    echo "usage: $0 comments|statements|functions|table <N>" >&2
+    exit 1
+    ;;
+esac
+
+awk -v shape="$1" -v n="${2:-1000}" '
+function name(i,    s, k) {
+    s = "f";
+    for(k = i; k > 0; k = int(k / 26))
+        s = s substr("abcdefghijklmnopqrstuvwxyz", k % 26 + 1, 1);
+    return s;
+}
+
+BEGIN {
+    if(shape == "statements") {
+        print "int total;";
+        print "void main(void) {";
+        print "    int x;";
+        print "    x = 0;";
+        for(i = 0; i < n; ++i)
+            print "    x = x + 1;";
+        print "    total = x;";
+        print "}";
+        exit;
+    }
+
+    if(shape == "table") {
+        print "int total;";
+        print "int table[100];";
+    }
+    for(i = 0; i < n; ++i) {
+        f = name(i);
+        if(shape == "comments") {
+            print "/*********************************************************************";
+            print " * FUNCTION NAME: " f;
+            for(j = 0; j < 12; ++j)
+                print " * Lorem ipsum dolor sit amet, consectetur adipiscing elit, sed do";
+            print " *********************************************************************/";
+            print "int " f "(int x) {";
+            print "                /* the argument is returned unchanged */";
+            print "                return x;";
+            print "}";
+            print "";
+        } else if(shape == "functions") {
+            print "int " f "(int x) { return x + 1; }";
+        } else {
+            print "/* " f " adds up part of the table */";
+            print "int " f "(int count, int step[]) {";
+            print "    int index;";
+            print "    int sum;";
+            print "    index = 0;";
+            print "    sum = 0;";
+            print "    while(index < count) {";
+            print "        if(step[index] >= 10)";
+            print "            sum = sum + step[index] * 2 - 1;";
+            print "        else";
+            print "            sum = sum - step[index] / 3;";
+            print "        index = index + 1;";
+            print "    }";
+            print "    return sum;";
+            print "}";
+        }
+    }
+
+    if(shape == "comments") {
+        print "void main(void) {";
+        print "    output(f(1));";
+        print "}";
+    } else if(shape == "functions") {
+        print "void main(void) { }";
+    } else {
+        print "void main(void) {";
+        print "    total = f(100, table);";
+        print "}";
+    }
+}'
@@ -0,0 +1,233 @@
+/*********************************************************************
+ * FILE NAME: frontend.c
+ * AUTHOR: Andrew O'Donohue
+ * PURPOSE: Measures the front end on its own. Programs of growing
+ *          size, generated by bench/corpus.sh, are scanned with
+ *          yylex() alone, then parsed with yyparse(), the AST
+ *          constructors and the flattening into the compact tree,
+ *          without the semantic pass, and the mean and standard
+ *          deviation of bytes/s, tokens/s and nodes/s over repeated
+ *          runs are reported. Built and run by make bench-frontend.
+ * USAGE: bench/frontend [max bytes] [runs]
+ *********************************************************************/
+#define _GNU_SOURCE
+#include <math.h>
+#include <time.h>
+#include "globals.h"
+#include "parse.h"
+#include "Compiler.h"
+
+#define MIN_SIZE 1000L
+#define MAX_SIZE 10000000L
+#define MAX_RUNS 100
+/* About the size of one function of the table shape of corpus.sh. */
+#define FUNCTION_BYTES 332
+
+int yylex(YYSTYPE *lvalp, void *scanner);
+struct yy_buffer_state *yy_scan_bytes(const char *bytes, int len, void *scanner);
+void yy_delete_buffer(struct yy_buffer_state *buffer, void *scanner);
+
+typedef struct stats Stats;
+struct stats {
+    double sum;
+    double squares;
+    int runs;
+};
+
+
+/*********************************************************************
+ * FUNCTION NAME: now
+ * PURPOSE: Reads the monotonic clock
+ * RETURNS: The time in seconds (double)
+ *********************************************************************/
+static double now(void) {
+
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+
+/*********************************************************************
+ * FUNCTION NAME: generate
+ * PURPOSE: Generates a program of about the given size with the table
+ *          shape of corpus.sh
+ * ARGUMENTS: . The path of corpus.sh (const char *)
+ *            . The size to reach in bytes (long)
+ *            . Receives the length of the program (size_t *)
+ * RETURNS: The program text (char *)
+ *********************************************************************/
+static char *generate(const char *corpus, long size, size_t *len) {
+
+    char command[4096], chunk[BUFSIZ];
+    char *text = NULL;
+    FILE *in, *out;
+    size_t n;
+
+    snprintf(command, sizeof(command), "'%s' table %ld", corpus, size / FUNCTION_BYTES + 1);
+    in = popen(command, "r");
+    out = open_memstream(&text, len);
+    ASSERT(in != NULL && out != NULL) {
+        fprintf(stderr, "Failed to run %s.\n", corpus);
+    }
+    while((n = fread(chunk, 1, sizeof(chunk), in)) > 0)
+        fwrite(chunk, 1, n, out);
+    fclose(out);
+    ASSERT(pclose(in) == 0 && *len > 0) {
+        fprintf(stderr, "%s failed.\n", corpus);
+    }
+    return text;
+}
+
+
+/*********************************************************************
+ * FUNCTION NAME: addSample
+ * PURPOSE: Adds one run's rate to a running mean and variance
+ * ARGUMENTS: . The statistics (Stats *)
+ *            . The rate (double)
+ *********************************************************************/
+static void addSample(Stats *stats, double rate) {
+
+    stats->sum += rate;
+    stats->squares += rate * rate;
+    stats->runs++;
+}
+
+
+/*********************************************************************
+ * FUNCTION NAME: printStats
+ * PURPOSE: Prints the mean and sample standard deviation of a rate
+ * ARGUMENTS: . The statistics (const Stats *)
+ *            . The unit the rates are divided by (double)
+ *********************************************************************/
+static void printStats(const Stats *stats, double unit) {
+
+    double mean = stats->sum / stats->runs;
+    double variance = 0;
+
+    if(stats->runs > 1)
+        variance = (stats->squares - stats->sum * mean) / (stats->runs - 1);
+    printf("  %8.2f +- %6.2f", mean / unit, sqrt(variance > 0 ? variance : 0) / unit);
+}
+
+
+/*********************************************************************
+ * FUNCTION NAME: lexRun
+ * PURPOSE: Scans a program with yylex() alone. Copying the text into
+ *          the scanner buffer is not timed
+ * ARGUMENTS: . The program text (const char *)
+ *            . The length of the text (size_t)
+ *            . Receives the number of tokens (long *)
+ *            . The stream listings and diagnostics go to (FILE *)
+ * RETURNS: The time taken in seconds (double)
+ *********************************************************************/
+static double lexRun(const char *text, size_t len, long *tokens, FILE *sink) {
+
+    CompilerContext *ctx = newCompilerContext(sink);
+    struct yy_buffer_state *buffer;
+    YYSTYPE lval;
+    double start, time;
+    long count = 0;
+
+    ctx->diagnostics = sink;
+    buffer = yy_scan_bytes(text, (int)len, ctx->scanner);
+    ASSERT(buffer != NULL) {
+        fprintf(stderr, "Failed to create scanner buffer.\n");
+    }
+    start = now();
+    while(yylex(&lval, ctx->scanner) != 0)
+        count++;
+    time = now() - start;
+    yy_delete_buffer(buffer, ctx->scanner);
+    freeCompilerContext(ctx);
+    *tokens = count;
+    return time;
+}
+
+
+/*********************************************************************
+ * FUNCTION NAME: parseRun
+ * PURPOSE: Parses a program with yyparse(), building its AST, but
+ *          does not analyze it. The text is parsed in place from a
+ *          copy made before timing starts, as lexRun does
+ * ARGUMENTS: . The program text (const char *)
+ *            . The length of the text (size_t)
+ *            . Receives the number of tree nodes (long *)
+ *            . The stream listings and diagnostics go to (FILE *)
+ * RETURNS: The time taken in seconds (double)
+ *********************************************************************/
+static double parseRun(const char *text, size_t len, long *nodes, FILE *sink) {
+
+    CompilerContext *ctx = newCompilerContext(sink);
+    char *copy = (char *)malloc(len + 2);
+    double start, time;
+    int status;
+
+    ASSERT(copy != NULL) {
+        fprintf(stderr, "Failed to malloc for program copy.\n");
+    }
+    memcpy(copy, text, len);
+    copy[len] = copy[len + 1] = '\0';
+    ctx->diagnostics = sink;
+    ctx->analyze = FALSE;
+    start = now();
+    status = parseBuffer(ctx, copy, len + 2);
+    time = now() - start;
+    ASSERT(status == 0) {
+        fprintf(stderr, "Generated program failed to parse.\n");
+    }
+    *nodes = ctx->memory.count[MEM_TREENODE];
+    freeCompilerContext(ctx);
+    free(copy);
+    return time;
+}
+
+
+int main(int argc, char *argv[]) {
+
+    long maxSize = argc > 1 ? atol(argv[1]) : MAX_SIZE;
+    int runs = argc > 2 ? atoi(argv[2]) : 5;
+    FILE *sink = fopen("/dev/null", "w");
+    const char *slash = strrchr(argv[0], '/');
+    char corpus[4096];
+    long size, tokens = 0, nodes = 0;
+    size_t len;
+    int run;
+
+    if(maxSize < MIN_SIZE || runs < 1 || runs > MAX_RUNS) {
+        fprintf(stderr, "usage: %s [max bytes >= %ld] [runs 1-%d]\n", argv[0], MIN_SIZE, MAX_RUNS);
+        return 1;
+    }
+    ASSERT(sink != NULL) {
+        fprintf(stderr, "Failed to open /dev/null.\n");
+    }
+    /* corpus.sh sits next to this program. */
+    snprintf(corpus, sizeof(corpus), "%.*s/corpus.sh",
+             slash != NULL ? (int)(slash - argv[0]) : 1, slash != NULL ? argv[0] : ".");
+
+    printf("%10s %10s %10s   %-18s%-18s%-18s%-18s\n", "bytes", "tokens", "nodes",
+           "lex MB/s", "lex Mtok/s", "parse MB/s", "parse Mnode/s");
+    for(size=MIN_SIZE; size<=maxSize; size*=10) {
+        char *text = generate(corpus, size, &len);
+        Stats lexBytes = {0}, lexTokens = {0}, parseBytesRate = {0}, parseNodes = {0};
+
+        for(run=0; run<runs; ++run) {
+            double time = lexRun(text, len, &tokens, sink);
+            addSample(&lexBytes, len / time);
+            addSample(&lexTokens, tokens / time);
+            time = parseRun(text, len, &nodes, sink);
+            addSample(&parseBytesRate, len / time);
+            addSample(&parseNodes, nodes / time);
+        }
+        printf("%10zu %10ld %10ld", len, tokens, nodes);
+        printStats(&lexBytes, 1e6);
+        printStats(&lexTokens, 1e6);
+        printStats(&parseBytesRate, 1e6);
+        printStats(&parseNodes, 1e6);
+        printf("\n");
+        fflush(stdout);
+        free(text);
+    }
+    fclose(sink);
+    return 0;
+}
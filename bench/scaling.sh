@@ -0,0 +1,36 @@
+#!/bin/sh
+#####################################################################
+# FILE NAME: scaling.sh
+# AUTHOR: Andrew O'Donohue
+# PURPOSE: Shows how parse time grows with the length of a list.
+#          Parses one function of N statements, and a program of N
+#          functions, for N from 1000 up to the given maximum, and
+#          prints the best parse and semantic analysis time of the
+#          runs and the time per statement or function, which stays
+#          flat while both are linear.
+# USAGE: bench/scaling.sh [max N] [runs]
+#        CM=<path> selects the compiler, ./cm by default
+#####################################################################
+CM=${CM:-./cm}
+MAX=${1:-1000000}
+RUNS=${2:-3}
+CORPUS=${TMPDIR:-/tmp}/cm-scaling-$$.cm
+trap 'rm -f "$CORPUS"' EXIT
+
+printf "%-10s %9s %11s %11s %9s\n" shape N bytes "parse ms" "ns/item"
+for shape in statements functions; do
+    n=1000
+    while [ $n -le "$MAX" ]; do
+        "$(dirname "$0")/corpus.sh" $shape $n > "$CORPUS" || exit 1
+        BYTES=$(wc -c < "$CORPUS")
+        i=0
+        best=
+        while [ $i -lt "$RUNS" ]; do
+            ms=$("$CM" "$CORPUS" -ftime-report 2>&1 >/dev/null | awk '$1 == "parse" || $1 == "semantic" { ms += $2 } END { print ms }')
+            best=$(echo "$ms $best" | awk '{ print ($2 == "" || $1 < $2) ? $1 : $2 }')
+            i=$((i + 1))
+        done
+        echo "$shape $n $BYTES $best" | awk '{ printf "%-10s %9d %11d %11.1f %9.1f\n", $1, $2, $3, $4, $4 * 1e6 / $2 }'
+        n=$((n * 10))
+    done
+done
@@ -0,0 +1,36 @@
+#!/bin/sh
+#####################################################################
+# FILE NAME: scanners.sh
+# AUTHOR: Andrew O'Donohue
+# PURPOSE: Compares the throughput of the flex scanner and the
+#          direct-coded scanner (make SCANNER=hand) on a generated
+#          program. Run from the top of the source tree; cm is left
+#          built with the default scanner.
+# USAGE: bench/scanners.sh [functions] [runs]
+#####################################################################
+FUNCTIONS=${1:-20000}
+RUNS=${2:-5}
+DIR=${TMPDIR:-/tmp}/cm-scanners-$$
+CORPUS=$DIR/corpus.cm
+mkdir -p "$DIR"
+trap 'rm -rf "$DIR"' EXIT
+
+for scanner in flex hand; do
+    rm -f cm
+    make -s cm SCANNER=$scanner || exit 1
+    mv cm "$DIR/cm-$scanner"
+done
+make -s cm
+
+"$(dirname "$0")/corpus.sh" table "$FUNCTIONS" > "$CORPUS" || exit 1
+
+BYTES=$(wc -c < "$CORPUS")
+echo "corpus: $FUNCTIONS functions, $BYTES bytes"
+for scanner in flex hand; do
+    i=0
+    while [ $i -lt "$RUNS" ]; do
+        "$DIR/cm-$scanner" "$CORPUS" -ftime-report 2>&1 >/dev/null | awk -v bytes="$BYTES" -v name="$scanner" '
+            $1 == "scan" { printf "%-5s scan %8.1f ms  %7.1f MB/s\n", name, $2, bytes / ($2 / 1000) / 1e6 }'
+        i=$((i + 1))
+    done
+done
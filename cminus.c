@@ -0,0 +1,151 @@
+/*********************************************************************
+ * FILE NAME: cminus.c
+ * AUTHOR: Andrew O'Donohue
+ * PURPOSE: libcminus, compiling C- programs from memory to memory.
+ *********************************************************************/
+#define _GNU_SOURCE
+#include <limits.h>
+#include "globals.h"
+#include "CompactTree.h"
+#include "Compiler.h"
+#include "Tokens.h"
+#include "cminus.h"
+
+struct cm_session {
+    TokenHistory history;
+};
+
+
+/*********************************************************************
+ * FUNCTION NAME: splitDiagnostics
+ * PURPOSE: Splits the diagnostics text into one entry per line
+ * ARGUMENTS: . The diagnostics text (char *)
+ *            . The length of the text (size_t)
+ *            . Receives the entries (CmResult *)
+ *********************************************************************/
+static void splitDiagnostics(char *text, size_t len, CmResult *result) {
+
+    int count = 0;
+    size_t i, start;
+
+    for(i=0; i<len; ++i)
+        if(text[i] == '\n')
+            count++;
+    if(len > 0 && text[len-1] != '\n')
+        count++;
+
+    result->diagnostics = (char **)calloc(count + 1, sizeof(char *));
+    ASSERT(result->diagnostics != NULL) {
+        fprintf(stderr, "Failed to malloc for diagnostics.\n");
+    }
+    result->diagnosticCount = 0;
+    for(start=0, i=0; i<=len; ++i) {
+        if(i == len || text[i] == '\n') {
+            if(i > start)
+                result->diagnostics[result->diagnosticCount++] = strndup(text + start, i - start);
+            start = i + 1;
+        }
+    }
+}
+
+
+/*********************************************************************
+ * FUNCTION NAME: compileSource
+ * PURPOSE: cm_compile, or with a token history a compilation that
+ *          re-lexes only the edited part of the source
+ * ARGUMENTS: . The source text (const char *)
+ *            . The length of the source text in bytes (size_t)
+ *            . The CM_ flags (int)
+ *            . Receives the assembly and diagnostics (CmResult *)
+ *            . The session's token history, or NULL (TokenHistory *)
+ *            . The edit since the last source, or NULL (const CmEdit *)
+ * RETURNS: 0 if compilation succeeded, nonzero otherwise
+ *********************************************************************/
+static int compileSource(const char *src, size_t len, int flags, CmResult *result,
+                         TokenHistory *history, const CmEdit *edit) {
+
+    char *diagnostics = NULL;
+    size_t diagnosticsLen = 0;
+
+    memset(result, 0, sizeof(CmResult));
+    FILE *listing = open_memstream(&result->listing, &result->listingLen);
+    FILE *diag = open_memstream(&diagnostics, &diagnosticsLen);
+    FILE *code = open_memstream(&result->code, &result->codeLen);
+    ASSERT(listing != NULL && diag != NULL && code != NULL) {
+        fprintf(stderr, "Failed to open output buffers.\n");
+    }
+
+    CompilerContext *ctx = newCompilerContext(listing);
+    ctx->diagnostics = diag;
+    ctx->AST = (flags & CM_AST) != 0;
+    ctx->Table = (flags & CM_TABLE) != 0;
+    ctx->checkSemantics = (flags & CM_NO_CHECK) == 0;
+    if(history != NULL) {
+        ctx->tokenMode = TOKENS_INCREMENTAL;
+        ctx->history = history;
+        ctx->edit.start = -1;
+        if(edit != NULL && edit->start <= INT_MAX && edit->removed <= INT_MAX && edit->inserted <= INT_MAX) {
+            ctx->edit.start = (int)edit->start;
+            ctx->edit.removed = (int)edit->removed;
+            ctx->edit.inserted = (int)edit->inserted;
+        }
+    }
+
+    result->status = parseBytes(ctx, src, len);
+    if(history != NULL)
+        keepTokens(ctx);
+    if(result->status == 0 && ctx->AST)
+        printAST(ctx, TREE_ROOT(ctx), 0);
+    if(result->status == 0 && !(flags & CM_PARSE_ONLY))
+        result->status = generateAssembly(ctx, code);
+    freeCompilerContext(ctx);
+
+    fclose(listing);
+    fclose(diag);
+    fclose(code);
+    splitDiagnostics(diagnostics, diagnosticsLen, result);
+    free(diagnostics);
+
+    return result->status;
+}
+
+
+int cm_compile(const char *src, size_t len, int flags, CmResult *result) {
+
+    return compileSource(src, len, flags, result, NULL, NULL);
+}
+
+
+CmSession *cm_open_session(void) {
+
+    return (CmSession *)calloc(1, sizeof(CmSession));
+}
+
+
+int cm_compile_edit(CmSession *session, const char *src, size_t len, const CmEdit *edit,
+                    int flags, CmResult *result) {
+
+    return compileSource(src, len, flags, result, &session->history, edit);
+}
+
+
+void cm_close_session(CmSession *session) {
+
+    if(session == NULL)
+        return;
+    freeHistory(&session->history);
+    free(session);
+}
+
+
+void cm_free_result(CmResult *result) {
+
+    int i;
+
+    for(i=0; i<result->diagnosticCount; ++i)
+        free(result->diagnostics[i]);
+    free(result->diagnostics);
+    free(result->code);
+    free(result->listing);
+    memset(result, 0, sizeof(CmResult));
+}
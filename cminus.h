@@ -0,0 +1,101 @@
+/*********************************************************************
+ * FILE NAME: cminus.h
+ * AUTHOR: Andrew O'Donohue
+ * PURPOSE: libcminus public interface, for compiling C- programs
+ *          from memory to memory without temporary files.
+ *********************************************************************/
+#ifndef CMINUS_H
+#define CMINUS_H
+
+#include <stddef.h>
+
+#define CM_AST   1
+#define CM_TABLE 2
+#define CM_PARSE_ONLY 4
+#define CM_NO_CHECK 8
+
+typedef struct cm_result CmResult;
+struct cm_result {
+    int status;             /* 0 on success */
+    char *code;             /* TM assembly, null terminated */
+    size_t codeLen;
+    char *listing;          /* syntax tree and symbol tables, if asked for */
+    size_t listingLen;
+    char **diagnostics;     /* one error message per entry */
+    int diagnosticCount;
+};
+
+/* A session keeps the tokens of the last source it compiled, so the
+ * next compilation only scans the part an edit changed. */
+typedef struct cm_session CmSession;
+
+typedef struct cm_edit CmEdit;
+struct cm_edit {
+    size_t start;           /* offset of the edit in the last source */
+    size_t removed;         /* bytes of the last source it replaced */
+    size_t inserted;        /* bytes of the new source in their place */
+};
+
+
+/*********************************************************************
+ * FUNCTION NAME: cm_compile
+ * PURPOSE: Compiles a C- program held in memory. Safe to call from
+ *          several threads at once
+ * ARGUMENTS: . The source text (const char *)
+ *            . The length of the source text in bytes (size_t)
+ *            . CM_AST and/or CM_TABLE to fill result->listing,
+ *              CM_PARSE_ONLY to stop before code generation,
+ *              CM_NO_CHECK to skip semantic checks on a source known
+ *              to be valid (int)
+ *            . Receives the assembly and diagnostics (CmResult *)
+ * RETURNS: 0 if compilation succeeded, nonzero otherwise
+ *********************************************************************/
+int cm_compile(const char *src, size_t len, int flags, CmResult *result);
+
+
+/*********************************************************************
+ * FUNCTION NAME: cm_open_session
+ * PURPOSE: Starts a session for compiling one source over and over
+ *          as it is edited. A session may only be used by one thread
+ *          at a time
+ * RETURNS: The session, or NULL if it could not be allocated
+ *********************************************************************/
+CmSession *cm_open_session(void);
+
+
+/*********************************************************************
+ * FUNCTION NAME: cm_compile_edit
+ * PURPOSE: cm_compile for a source that differs from the one the
+ *          session compiled last by a single edit. Only the tokens
+ *          around the edit are scanned again; the whole source is
+ *          scanned on the first call, when edit is NULL, or when the
+ *          edit does not fit the last source
+ * ARGUMENTS: . The session (CmSession *)
+ *            . The source text after the edit (const char *)
+ *            . The length of the source text in bytes (size_t)
+ *            . The edit since the last call, or NULL (const CmEdit *)
+ *            . The flags, as for cm_compile (int)
+ *            . Receives the assembly and diagnostics (CmResult *)
+ * RETURNS: 0 if compilation succeeded, nonzero otherwise
+ *********************************************************************/
+int cm_compile_edit(CmSession *session, const char *src, size_t len, const CmEdit *edit,
+                    int flags, CmResult *result);
+
+
+/*********************************************************************
+ * FUNCTION NAME: cm_close_session
+ * PURPOSE: Releases a session and the tokens it keeps
+ * ARGUMENTS: The session to be released (CmSession *)
+ *********************************************************************/
+void cm_close_session(CmSession *session);
+
+
+/*********************************************************************
+ * FUNCTION NAME: cm_free_result
+ * PURPOSE: Releases the buffers held by a result of cm_compile
+ * ARGUMENTS: The result to be released (CmResult *)
+ *********************************************************************/
+void cm_free_result(CmResult *result);
+
+
+#endif
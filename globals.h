@@ -11,6 +11,8 @@
 #include <ctype.h>
 #include <string.h>
 #include <assert.h>
+#include <setjmp.h>
+#include <pthread.h>
 
 #ifndef FALSE
 #define FALSE 0
@@ -22,16 +24,14 @@
 
 #define ASSERT(x) for(;!(x);assert(x))
 
+/* Part of every cache key; bump it whenever the output for a given
+ * source can change. */
+#define CM_VERSION "cm 1.3"
+
 #define SIZE 211
 #define SHIFT 4
 #define DEBUG_SYM
 
-extern FILE *source;
-extern FILE *listing;
-extern FILE *code;
-
-extern int Table;
-
 #define MAXCHILDREN 4
 
 
@@ -64,22 +64,29 @@ struct symbol_table {
     Scope scope;
     VarSymbol *hashTable[SIZE];
     VarSymbol *varList;
+    VarSymbol *varTail;
     struct symbol_table *next;
 };
 
+/* index numbers the functions in the order they are declared, from 0
+ * for the built in input. */
 typedef struct fun_symbol FunSymbol;
 struct fun_symbol {
     char *name;
     ExpType type;
     int offset;
     int paramNum;
+    int index;
     SymbolTable *symbolTable;
     struct fun_symbol *next;
 };
 
+/* attr.value of a NUM_AST node is the number's index in the
+ * constant pool; of an ARRAYDEC_AST node, the pool index of the size
+ * of the array. */
 typedef struct ASTNode TreeNode;
 struct ASTNode {
-    int lineno;
+    int offset;
     struct ASTNode *child[MAXCHILDREN];
     struct ASTNode *sibling;
     ASTType astType;
@@ -89,15 +96,321 @@ struct ASTNode {
         int value;
         char *name;
     } attr;
-    SymbolTable *symbolTable;
 };
 
+/* The syntax tree as it is kept once a declaration has been parsed:
+ * the nodes in one array in preorder, addressed by index, and the
+ * children of each node in consecutive slots of a side array, NO_NODE
+ * for a missing one. payload is the operator of an EXP_AST node, the
+ * constant pool index of a NUM_AST node, the index in tables of a
+ * COMPOUND_AST node's symbol table or NO_NODE, and the atom id of any
+ * other node with a name, indexing names. An ARRAYDEC_AST node keeps the
+ * pool index of the size of the array in the slot after its child.
+ * type is filled in by the semantic pass. names is the tree's own copy
+ * of the atom names it uses, written only by the thread that parses,
+ * since the scanner thread of -ftokens=pipeline grows ctx->atomNames
+ * while the tree is read. */
+#define NO_NODE (-1)
+
+typedef struct compact_node CompactNode;
+struct compact_node {
+    unsigned char astType;
+    unsigned char type;
+    int offset;
+    int payload;
+    int children;
+    int sibling;
+};
+
+typedef struct compact_tree CompactTree;
+struct compact_tree {
+    CompactNode *nodes;
+    int count;
+    int cap;
+    int *slots;
+    int slotCount;
+    int slotCap;
+    SymbolTable **tables;
+    int tableCount;
+    int tableCap;
+    char **names;
+    int nameCap;
+    int last;
+};
+
+/* A list of siblings being built by the parser. tail is kept so each
+ * node is appended in constant time. */
+typedef struct node_list NodeList;
+struct node_list {
+    TreeNode *head;
+    TreeNode *tail;
+};
+
+
+typedef enum { PHASE_SCAN, PHASE_PARSE, PHASE_SEMANTIC, PHASE_SYMTAB, PHASE_CODEGEN,
+               PHASE_OUTPUT, PHASE_COUNT
+             } Phase;
+
+typedef enum {REPORT_NONE, REPORT_TEXT, REPORT_JSON} ReportFormat;
+
+#define PHASE_DEPTH 16
+
+typedef struct phase_timer PhaseTimer;
+struct phase_timer {
+    int enabled;
+    int depth;
+    Phase stack[PHASE_DEPTH];
+    double markWall;
+    double markCpu;
+    double spanWall[PHASE_COUNT];
+    double wall[PHASE_COUNT];
+    double cpu[PHASE_COUNT];
+    long calls[PHASE_COUNT];
+};
+
+typedef enum { MEM_TREENODE, MEM_COMPACTNODE, MEM_SYMBOLTABLE, MEM_VARSYMBOL,
+               MEM_FUNSYMBOL, MEM_IDENTIFIER, MEM_COUNT
+             } MemCategory;
+
+/* A bump pointer allocator. What is allocated from an arena is only
+ * released all at once, by resetArena or freeArena. */
+typedef struct arena_block ArenaBlock;
+typedef struct arena Arena;
+struct arena {
+    ArenaBlock *blocks;
+    char *next;
+    char *end;
+};
+
+typedef struct mem_stats MemStats;
+struct mem_stats {
+    long count[MEM_COUNT];
+    long bytes[MEM_COUNT];
+};
+
+/* Register-only instructions come before OP_LD, register-memory ones
+ * from OP_LD on. OP_NONE marks a skipped location not yet filled. */
+typedef enum { OP_NONE, OP_HALT, OP_IN, OP_OUT, OP_ADD, OP_SUB, OP_MUL,
+               OP_DIV, OP_LD, OP_ST, OP_LDA, OP_LDC, OP_JLT, OP_JLE,
+               OP_JGT, OP_JGE, OP_JEQ, OP_JNE, OP_COUNT
+             } Opcode;
+
+typedef struct instruction Instruction;
+struct instruction {
+    Opcode op;
+    int r;
+    int s;
+    int t;
+    char *comment;
+};
+
+typedef struct code_comment CodeComment;
+struct code_comment {
+    int loc;
+    char *text;
+};
+
+/* bucket is hash() of the name, the symbol table bucket, computed
+ * once when the atom is created. fun is the function of that name,
+ * if one has been declared. id numbers the atoms of a compilation
+ * from 0, indexing ctx->atomNames. */
+typedef struct atom Atom;
+struct atom {
+    Atom *next;
+    unsigned int hash;
+    int bucket;
+    int id;
+    FunSymbol *fun;
+    size_t length;
+    char text[];
+};
+
+/* TOKENS_INCREMENTAL is used by libcminus sessions, not the command
+ * line: it re-lexes only the edited part of the last source. */
+typedef enum {TOKENS_PULL, TOKENS_ARRAY, TOKENS_PIPELINE, TOKENS_PARALLEL,
+              TOKENS_INCREMENTAL} TokenMode;
+
+/* The tokens of a whole source, one array per field. payload is the
+ * constant pool index of a NUMBER and the atom id of an ID. */
+typedef struct token_array TokenArray;
+struct token_array {
+    short *kind;
+    int *payload;
+    int *offset;
+    int count;
+    int cap;
+    int next;
+    char *text;
+    int textCap;
+};
+
+/* What an incremental session keeps of the last source it compiled:
+ * its tokens, and the identifiers and constants their payloads refer
+ * to, by atom id and pool index. */
+typedef struct token_history TokenHistory;
+struct token_history {
+    TokenArray tokens;
+    int len;
+    int strays;
+    int valid;
+    char **names;
+    int nameCount;
+    int nameCap;
+    int *values;
+    int valueCount;
+    int valueCap;
+};
+
+/* Bytes [start, start + removed) of the last source were replaced by
+ * bytes [start, start + inserted) of the new one. start is -1 when
+ * the whole source must be scanned again. */
+typedef struct source_edit SourceEdit;
+struct source_edit {
+    int start;
+    int removed;
+    int inserted;
+};
+
+/* The ring of tokens between the scanner and parser threads of
+ * -ftokens=pipeline, private to Tokens.c. */
+typedef struct token_pipe TokenPipe;
+
+typedef struct compile_cache CompileCache;
+struct compile_cache {
+    char *dir;
+    long maxBytes;
+    long hits;
+    long misses;
+    long stores;
+    long evictions;
+    pthread_mutex_t lock;
+};
+
+typedef struct compile_options CompileOptions;
+struct compile_options {
+    int AST;
+    int Table;
+    int Assembly;
+    int stream;
+    int noMmap;
+    int noSemanticCheck;
+    TokenMode tokens;
+    int lexThreads;
+    int semanticThreads;
+    ReportFormat timeReport;
+    ReportFormat memReport;
+    CompileCache *cache;
+};
+
+
+typedef struct compiler_context CompilerContext;
+struct compiler_context {
+    void *scanner;
+    FILE *listing;
+    FILE *diagnostics;
+    FILE *code;
+    int AST;
+    int Table;
+    int Assembly;
+    int streaming;
+    int useMmap;
+    int checkSemantics;
+    /* Cleared to stop after parsing, without the semantic pass. */
+    int analyze;
+    TokenMode tokenMode;
+    int lexThreads;
+    int semanticThreads;
+    jmp_buf bailout;
+    PhaseTimer timer;
+    MemStats memory;
+    CompileCache *cache;
+
+    /* treeArena holds the parser's tree of the declaration being
+     * parsed, released once it is added to compact; scopeArena the
+     * local symbol tables, which -fstream-codegen releases after each
+     * declaration; symbolArena the global and parameter tables and the
+     * functions; atomArena the identifiers, which the scanner thread
+     * allocates with -ftokens=pipeline. */
+    Arena treeArena;
+    Arena scopeArena;
+    Arena symbolArena;
+    Arena atomArena;
+
+    Atom **atoms;
+    char **atomNames;
+    int atomCap;
+    int atomCount;
 
-extern SymbolTable *tables;
-extern FunSymbol *funs;
-extern SymbolTable *CompoundST;
-extern SymbolTable *ParamST;
-extern TreeNode *ASTRoot;
+    /* The distinct integer literals of the source. A NUMBER token
+     * carries an index into constants; constantSlots hashes values to
+     * index + 1, with 0 for an empty slot. */
+    int *constants;
+    int constantCount;
+    int constantCap;
+    int *constantSlots;
+
+    TokenArray tokens;
+    TokenPipe *pipe;
+    /* Taken by internAtom and the constant pool with -ftokens=pipeline,
+     * when the scanner and the parser run on different threads. */
+    pthread_mutex_t internLock;
+    int scanOffset;
+    int tokenOffset;
+    /* Characters no rule matched, and the session's history and the
+     * edit since it with TOKENS_INCREMENTAL. */
+    int strays;
+    /* When the parser reads tokens scanned ahead of it, the offsets of
+     * those characters, whose messages are held until the parser takes
+     * the token that follows them. straysShown have been printed. */
+    int *strayOffsets;
+    int strayCap;
+    int straysShown;
+    TokenHistory *history;
+    SourceEdit edit;
+
+    /* The source being compiled, and the offset of the start of each
+     * of its lines, built the first time a diagnostic needs a line. */
+    const char *source;
+    int sourceLen;
+    int *lineStarts;
+    int lineCount;
+    char position[32];
+
+    SymbolTable *tables;
+    FunSymbol *funs;
+    SymbolTable *CompoundST;
+    SymbolTable *ParamST;
+
+    CompactTree compact;
+    Scope current_scope;
+    FunSymbol *current_fun;
+    /* A function body checked on a thread of -fsemantic-threads sees
+     * only the globals with an offset below visibleGlobals and the
+     * functions with an index up to visibleFuns, those declared before
+     * it. Both are INT_MAX otherwise. */
+    int visibleGlobals;
+    int visibleFuns;
+
+    int paramStack[SIZE];
+    int top;
+    /* With -fstream-codegen the code of each function is written as
+     * soon as it is generated. instructions then keeps only the first
+     * heldLocs locations, backpatched at the end, and the locations
+     * from codeBase on, from index heldLocs. Both are 0 otherwise. */
+    Instruction *instructions;
+    int instructionCap;
+    int heldLocs;
+    int codeBase;
+    CodeComment *comments;
+    int commentCount;
+    int commentCap;
+    int emitLoc;
+    int highEmitLoc;
+    int getValue;
+    int isRecursive;
+    int preludeLoc;
+    int mainCallLoc;
+};
 
 
 #endif
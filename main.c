@@ -4,80 +4,154 @@
  * PURPOSE: Main terminal interface.
  *********************************************************************/
 #include "globals.h"
-#include "parse.h"
-#include "SymbolTable.h"
-#include "CodeGeneration.h"
-#include "SyntaxTree.h"
+#include "Compiler.h"
+#include "Batch.h"
+#include "Server.h"
+#include "Timer.h"
+#include "Memory.h"
+#include "Cache.h"
 
-#define FILE_NAME_LEN 100
+#define CACHE_SIZE_MB 64
+
+
+/*********************************************************************
+ * FUNCTION NAME: usage
+ * PURPOSE: Prints the command line options and exits
+ * ARGUMENTS: The name of the program (char *)
+ *********************************************************************/
+static void usage(char *program) {
+
+    fprintf(stderr, "Usage: %s [-a] [-s] [-c] [-j N] [--client <socket>] <filename>...\n", program);
+    fprintf(stderr, "       %s --server <socket>\n", program);
+    fprintf(stderr, "  -a    print the syntax tree\n");
+    fprintf(stderr, "  -s    print the symbol tables\n");
+    fprintf(stderr, "  -c    write assembly to <filename>.tm\n");
+    fprintf(stderr, "  -j N  compile the files on N worker threads\n");
+    fprintf(stderr, "  -fstream-codegen      generate each function as soon as it is parsed\n");
+    fprintf(stderr, "  -fno-mmap             read sources through stdio instead of mapping them\n");
+    fprintf(stderr, "  -fno-semantic-check   only build symbol tables, for sources known to be valid\n");
+    fprintf(stderr, "  -fsemantic-threads=N  check function bodies on N threads\n");
+    fprintf(stderr, "  -ftokens=array        tokenize each source before parsing it\n");
+    fprintf(stderr, "  -ftokens=pipeline     scan each source on a thread of its own\n");
+    fprintf(stderr, "  -ftokens=parallel     tokenize pieces of large sources on several threads\n");
+    fprintf(stderr, "  -flex-threads=N       threads for -ftokens=parallel, default one per core\n");
+    fprintf(stderr, "  -ftime-report[=json]  print the time spent in each phase\n");
+    fprintf(stderr, "  -fmem-report[=json]   print allocations by kind and peak RSS\n");
+    fprintf(stderr, "  --server <socket>  stay resident, compiling requests sent to socket\n");
+    fprintf(stderr, "  --client <socket>  send the files to a server instead of compiling here\n");
+    fprintf(stderr, "  --cache <dir>      reuse results of earlier compilations ($CM_CACHE_DIR)\n");
+    fprintf(stderr, "  --cache-size <MB>  bound on the cache size, default %d\n", CACHE_SIZE_MB);
+    fprintf(stderr, "  --cache-stats      print cache hits and misses\n");
+    exit(1);
+}
 
-int AST = FALSE;
-int Table = FALSE;
-int Assembly = FALSE;
-FILE *source;
-FILE *listing;
-FILE *code;
 
 int main(int argc, char *argv[]) {
 
-    char sourcefile[FILE_NAME_LEN];
+    CompileOptions options;
+    char **files = (char **)malloc(argc * sizeof(char *));
+    int count = 0;
+    int jobs = 0;
+    char *server = NULL;
+    char *client = NULL;
+    char *cacheDir = getenv("CM_CACHE_DIR");
+    long cacheSize = CACHE_SIZE_MB;
+    int cacheStats = FALSE;
+    int status;
+    int i;
 
-    if (argc < 2) {
-		fprintf(stderr,"Usage: %s <filename>\n",argv[0]);
-    	exit(1);
+    memset(&options, 0, sizeof(options));
+    for(i=1; i<argc; ++i) {
+        if(strcmp(argv[i], "-a") == 0)
+            options.AST = TRUE;
+        else if(strcmp(argv[i], "-s") == 0)
+            options.Table = TRUE;
+        else if(strcmp(argv[i], "-c") == 0)
+            options.Assembly = TRUE;
+        else if(strcmp(argv[i], "-fstream-codegen") == 0)
+            options.stream = TRUE;
+        else if(strcmp(argv[i], "-fno-mmap") == 0)
+            options.noMmap = TRUE;
+        else if(strcmp(argv[i], "-fno-semantic-check") == 0)
+            options.noSemanticCheck = TRUE;
+        else if(strcmp(argv[i], "-ftokens=array") == 0)
+            options.tokens = TOKENS_ARRAY;
+        else if(strcmp(argv[i], "-ftokens=pipeline") == 0)
+            options.tokens = TOKENS_PIPELINE;
+        else if(strcmp(argv[i], "-ftokens=parallel") == 0)
+            options.tokens = TOKENS_PARALLEL;
+        else if(strncmp(argv[i], "-flex-threads=", 14) == 0) {
+            if((options.lexThreads = atoi(argv[i] + 14)) < 1)
+                usage(argv[0]);
+        }
+        else if(strncmp(argv[i], "-fsemantic-threads=", 19) == 0) {
+            if((options.semanticThreads = atoi(argv[i] + 19)) < 1)
+                usage(argv[0]);
+        }
+        else if(strcmp(argv[i], "-ftokens=pull") == 0)
+            options.tokens = TOKENS_PULL;
+        else if(strcmp(argv[i], "-ftime-report") == 0)
+            options.timeReport = REPORT_TEXT;
+        else if(strcmp(argv[i], "-ftime-report=json") == 0)
+            options.timeReport = REPORT_JSON;
+        else if(strcmp(argv[i], "-fmem-report") == 0)
+            options.memReport = REPORT_TEXT;
+        else if(strcmp(argv[i], "-fmem-report=json") == 0)
+            options.memReport = REPORT_JSON;
+        else if(strncmp(argv[i], "-j", 2) == 0) {
+            char *n = argv[i][2] ? argv[i] + 2 : (i+1 < argc ? argv[++i] : NULL);
+            if(n == NULL || (jobs = atoi(n)) < 1)
+                usage(argv[0]);
+        }
+        else if(strcmp(argv[i], "--server") == 0 && i+1 < argc)
+            server = argv[++i];
+        else if(strcmp(argv[i], "--client") == 0 && i+1 < argc)
+            client = argv[++i];
+        else if(strcmp(argv[i], "--cache") == 0 && i+1 < argc)
+            cacheDir = argv[++i];
+        else if(strcmp(argv[i], "--cache-size") == 0 && i+1 < argc) {
+            if((cacheSize = atol(argv[++i])) < 1)
+                usage(argv[0]);
+        }
+        else if(strcmp(argv[i], "--cache-stats") == 0)
+            cacheStats = TRUE;
+        else if(argv[i][0] == '-')
+            usage(argv[0]);
+        else
+            files[count++] = argv[i];
     }
-    if (argc == 3) {
-    	if(strcmp(argv[2], "-a") == 0)
-    		AST = TRUE;
-    	if(strcmp(argv[2], "-s") == 0)
-    		Table = TRUE;
-    	if(strcmp(argv[2], "-c") == 0)
-    		Assembly = TRUE;
-    }
-    if (argc == 4) {
-    	if(strcmp(argv[2], "-a") == 0 || strcmp(argv[3], "-a") == 0)
-    		AST = TRUE;
-    	if(strcmp(argv[2], "-s") == 0 || strcmp(argv[3], "-s") == 0)
-    		Table = TRUE;
-    	if(strcmp(argv[2], "-c") == 0 || strcmp(argv[3], "-c") == 0)
-    		Assembly = TRUE;
-    }
-    if (argc == 5) {
-    	if(strcmp(argv[2], "-a") == 0 || strcmp(argv[3], "-a") == 0 || strcmp(argv[4], "-a") == 0)
-    		AST = TRUE;
-    	if(strcmp(argv[2], "-s") == 0 || strcmp(argv[3], "-s") == 0 || strcmp(argv[4], "-s") == 0)
-    		Table = TRUE;
-    	if(strcmp(argv[2], "-c") == 0 || strcmp(argv[3], "-c") == 0  || strcmp(argv[4], "-c") == 0)
-    		Assembly = TRUE;
+    if(server != NULL) {
+        if(count != 0 || client != NULL)
+            usage(argv[0]);
+        return runServer(server) != 0;
     }
+    if(count == 0)
+        usage(argv[0]);
 
-    strcpy(sourcefile,argv[1]) ;
-    source = fopen(sourcefile,"r");
-    ASSERT(source != NULL) {
-        fprintf(stderr,"File %s not found.\n",sourcefile);
-    }
+    if(cacheDir != NULL && *cacheDir != '\0' && client == NULL)
+        options.cache = openCache(cacheDir, cacheSize * 1024 * 1024);
 
-    listing = stdout;
-    fprintf(listing,"\nC minus compilation: %s\n",sourcefile);
-    initTable();
-    yyrestart(source);
-    yyparse();
-    fclose(source);
-
-    if (AST == TRUE)
-    	printAST(ASTRoot,0);
+    if(client != NULL)
+        status = runClient(client, files, count, &options);
+    else if(count == 1 && jobs == 0) {
+        CompilerContext *ctx = newCompilerContext(stdout);
+        applyOptions(ctx, &options);
+        status = compileFile(ctx, files[0]);
+        if(options.timeReport != REPORT_NONE)
+            printTimeReport(stderr, &ctx->timer, 1, options.timeReport);
+        if(options.memReport != REPORT_NONE)
+            printMemReport(stderr, &ctx->memory, 1, options.memReport);
+        freeCompilerContext(ctx);
+    }
+    else
+        status = compileBatch(files, count, jobs, &options);
 
-    if (Assembly) {
-    	char *codefile = (char *) calloc(strlen(sourcefile), sizeof(char));
-    	strcpy(codefile,sourcefile);
-    	strcat(codefile,".tm");
-    	code = fopen(codefile,"w");
-    	ASSERT(code != NULL) {
-    		fprintf(stderr, "Unable to open %s for output.\n",codefile);
-    	}
-    	generateCode();
-    	fclose(code);
+    if(options.cache != NULL) {
+        if(cacheStats)
+            printCacheReport(stderr, options.cache);
+        closeCache(options.cache);
     }
 
-    return 0;
+    free(files);
+    return status != 0;
 }
@@ -1,8 +1,9 @@
-/* A Bison parser, made by GNU Bison 3.0.2.  */
+/* A Bison parser, made by GNU Bison 3.8.2.  */
 
 /* Bison implementation for Yacc-like parsers in C
 
-   Copyright (C) 1984, 1989-1990, 2000-2013 Free Software Foundation, Inc.
+   Copyright (C) 1984, 1989-1990, 2000-2015, 2018-2021 Free Software Foundation,
+   Inc.
 
    This program is free software: you can redistribute it and/or modify
    it under the terms of the GNU General Public License as published by
@@ -15,7 +16,7 @@
    GNU General Public License for more details.
 
    You should have received a copy of the GNU General Public License
-   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.  */
 
 /* As a special exception, you may create a larger work that contains
    part or all of the Bison parser skeleton and distribute that work
@@ -33,6 +34,10 @@
 /* C LALR(1) parser skeleton written by Richard Stallman, by
    simplifying the original so-called "semantic" parser.  */
 
+/* DO NOT RELY ON FEATURES THAT ARE NOT DOCUMENTED in the manual,
+   especially those whose name start with YY_ or yy_.  They are
+   private implementation details that can be changed or removed.  */
+
 /* All symbols defined below should begin with yy or YY, to avoid
    infringing on user name space.  This should be done even for local
    variables, as they might otherwise be expanded by user macros.
@@ -40,17 +45,17 @@
    define necessary library symbols; they are noted "INFRINGES ON
    USER NAME SPACE" below.  */
 
-/* Identify Bison output.  */
-#define YYBISON 1
+/* Identify Bison output, and Bison version.  */
+#define YYBISON 30802
 
-/* Bison version.  */
-#define YYBISON_VERSION "3.0.2"
+/* Bison version string.  */
+#define YYBISON_VERSION "3.8.2"
 
 /* Skeleton name.  */
 #define YYSKELETON_NAME "yacc.c"
 
 /* Pure parsers.  */
-#define YYPURE 0
+#define YYPURE 2
 
 /* Push parsers.  */
 #define YYPUSH 0
@@ -61,138 +66,220 @@
 
 
 
-/* Copy the first part of user declarations.  */
-#line 1 "parse.y" /* yacc.c:339  */
+/* First part of user prologue.  */
+#line 5 "parse.y"
 
 #define YYPARSER
 
 #include "globals.h"
 #include "SyntaxTree.h"
-
-extern int yylineno;
-extern char* yytext;
-
-
-#line 77 "parse.c" /* yacc.c:339  */
-
+#include "Timer.h"
+#include "CodeGeneration.h"
+#include "CompactTree.h"
+#include "Tokens.h"
+#include "Location.h"
+
+/* A location is the byte offset at which a construct starts: that of
+ * its first token, which Tokens.c gives whether the tokens come from
+ * the scanner, a token array or a pipeline. An empty rule is located
+ * where the symbol before it starts. */
+#define YYLLOC_DEFAULT(Current, Rhs, N) \
+     ((Current) = (N) > 0 ? YYRHSLOC(Rhs, 1) : YYRHSLOC(Rhs, 0))
+
+
+#line 91 "parse.c"
+
+# ifndef YY_CAST
+#  ifdef __cplusplus
+#   define YY_CAST(Type, Val) static_cast<Type> (Val)
+#   define YY_REINTERPRET_CAST(Type, Val) reinterpret_cast<Type> (Val)
+#  else
+#   define YY_CAST(Type, Val) ((Type) (Val))
+#   define YY_REINTERPRET_CAST(Type, Val) ((Type) (Val))
+#  endif
+# endif
 # ifndef YY_NULLPTR
-#  if defined __cplusplus && 201103L <= __cplusplus
-#   define YY_NULLPTR nullptr
+#  if defined __cplusplus
+#   if 201103L <= __cplusplus
+#    define YY_NULLPTR nullptr
+#   else
+#    define YY_NULLPTR 0
+#   endif
 #  else
-#   define YY_NULLPTR 0
+#   define YY_NULLPTR ((void*)0)
 #  endif
 # endif
 
-/* Enabling verbose error messages.  */
-#ifdef YYERROR_VERBOSE
-# undef YYERROR_VERBOSE
-# define YYERROR_VERBOSE 1
-#else
-# define YYERROR_VERBOSE 0
-#endif
-
-/* In a future release of Bison, this section will be replaced
-   by #include "parse.h".  */
-#ifndef YY_YY_PARSE_H_INCLUDED
-# define YY_YY_PARSE_H_INCLUDED
-/* Debug traces.  */
-#ifndef YYDEBUG
-# define YYDEBUG 0
-#endif
-#if YYDEBUG
-extern int yydebug;
-#endif
-
-/* Token type.  */
-#ifndef YYTOKENTYPE
-# define YYTOKENTYPE
-  enum yytokentype
-  {
-    IF = 258,
-    ELSE = 259,
-    RETURN = 260,
-    WHILE = 261,
-    INT = 262,
-    VOID = 263,
-    LBracket = 264,
-    RBracket = 265,
-    LBrace = 266,
-    RBrace = 267,
-    Quote = 268,
-    LSB = 269,
-    RSB = 270,
-    COMMA = 271,
-    SEMI = 272,
-    ASSIGN = 273,
-    MINUS = 274,
-    PLUS = 275,
-    MULTI = 276,
-    DIV = 277,
-    GT = 278,
-    LT = 279,
-    GE = 280,
-    LE = 281,
-    EQ = 282,
-    NE = 283,
-    NUMBER = 284,
-    ID = 285
-  };
-#endif
-
-/* Value type.  */
-#if ! defined YYSTYPE && ! defined YYSTYPE_IS_DECLARED
-typedef union YYSTYPE YYSTYPE;
-union YYSTYPE
+#include "parse.h"
+/* Symbol kind.  */
+enum yysymbol_kind_t
 {
-#line 30 "parse.y" /* yacc.c:355  */
-
-     char *name;
-     int value;
-     struct ASTNode *node;
-
-#line 154 "parse.c" /* yacc.c:355  */
+  YYSYMBOL_YYEMPTY = -2,
+  YYSYMBOL_YYEOF = 0,                      /* "end of file"  */
+  YYSYMBOL_YYerror = 1,                    /* error  */
+  YYSYMBOL_YYUNDEF = 2,                    /* "invalid token"  */
+  YYSYMBOL_IF = 3,                         /* IF  */
+  YYSYMBOL_ELSE = 4,                       /* ELSE  */
+  YYSYMBOL_RETURN = 5,                     /* RETURN  */
+  YYSYMBOL_WHILE = 6,                      /* WHILE  */
+  YYSYMBOL_INT = 7,                        /* INT  */
+  YYSYMBOL_VOID = 8,                       /* VOID  */
+  YYSYMBOL_LBracket = 9,                   /* LBracket  */
+  YYSYMBOL_RBracket = 10,                  /* RBracket  */
+  YYSYMBOL_LBrace = 11,                    /* LBrace  */
+  YYSYMBOL_RBrace = 12,                    /* RBrace  */
+  YYSYMBOL_Quote = 13,                     /* Quote  */
+  YYSYMBOL_LSB = 14,                       /* LSB  */
+  YYSYMBOL_RSB = 15,                       /* RSB  */
+  YYSYMBOL_COMMA = 16,                     /* COMMA  */
+  YYSYMBOL_SEMI = 17,                      /* SEMI  */
+  YYSYMBOL_ASSIGN = 18,                    /* ASSIGN  */
+  YYSYMBOL_MINUS = 19,                     /* MINUS  */
+  YYSYMBOL_PLUS = 20,                      /* PLUS  */
+  YYSYMBOL_MULTI = 21,                     /* MULTI  */
+  YYSYMBOL_DIV = 22,                       /* DIV  */
+  YYSYMBOL_GT = 23,                        /* GT  */
+  YYSYMBOL_LT = 24,                        /* LT  */
+  YYSYMBOL_GE = 25,                        /* GE  */
+  YYSYMBOL_LE = 26,                        /* LE  */
+  YYSYMBOL_EQ = 27,                        /* EQ  */
+  YYSYMBOL_NE = 28,                        /* NE  */
+  YYSYMBOL_NUMBER = 29,                    /* NUMBER  */
+  YYSYMBOL_ID = 30,                        /* ID  */
+  YYSYMBOL_YYACCEPT = 31,                  /* $accept  */
+  YYSYMBOL_program = 32,                   /* program  */
+  YYSYMBOL_declaration_list = 33,          /* declaration_list  */
+  YYSYMBOL_declaration = 34,               /* declaration  */
+  YYSYMBOL_type_specifier = 35,            /* type_specifier  */
+  YYSYMBOL_var_declaration = 36,           /* var_declaration  */
+  YYSYMBOL_fun_declaration = 37,           /* fun_declaration  */
+  YYSYMBOL_fun_head = 38,                  /* fun_head  */
+  YYSYMBOL_compound_stmt = 39,             /* compound_stmt  */
+  YYSYMBOL_params = 40,                    /* params  */
+  YYSYMBOL_param_list = 41,                /* param_list  */
+  YYSYMBOL_param = 42,                     /* param  */
+  YYSYMBOL_local_declarations = 43,        /* local_declarations  */
+  YYSYMBOL_statement_list = 44,            /* statement_list  */
+  YYSYMBOL_statement = 45,                 /* statement  */
+  YYSYMBOL_expression_stmt = 46,           /* expression_stmt  */
+  YYSYMBOL_selection_stmt = 47,            /* selection_stmt  */
+  YYSYMBOL_iteration_stmt = 48,            /* iteration_stmt  */
+  YYSYMBOL_return_stmt = 49,               /* return_stmt  */
+  YYSYMBOL_expression = 50,                /* expression  */
+  YYSYMBOL_var = 51,                       /* var  */
+  YYSYMBOL_simple_expression = 52,         /* simple_expression  */
+  YYSYMBOL_relop = 53,                     /* relop  */
+  YYSYMBOL_additive_expression = 54,       /* additive_expression  */
+  YYSYMBOL_addop = 55,                     /* addop  */
+  YYSYMBOL_term = 56,                      /* term  */
+  YYSYMBOL_mulop = 57,                     /* mulop  */
+  YYSYMBOL_factor = 58,                    /* factor  */
+  YYSYMBOL_call = 59,                      /* call  */
+  YYSYMBOL_args = 60,                      /* args  */
+  YYSYMBOL_arg_list = 61                   /* arg_list  */
 };
-# define YYSTYPE_IS_TRIVIAL 1
-# define YYSTYPE_IS_DECLARED 1
-#endif
+typedef enum yysymbol_kind_t yysymbol_kind_t;
 
 
-extern YYSTYPE yylval;
 
-int yyparse (void);
+/* Unqualified %code blocks.  */
+#line 56 "parse.y"
 
-#endif /* !YY_YY_PARSE_H_INCLUDED  */
+int yylex(YYSTYPE *lvalp, void *scanner);
+int yyerror(YYLTYPE *llocp, void *scanner, CompilerContext *ctx, const char *errmsg);
 
-/* Copy the second part of user declarations.  */
+/* Tokens are read through timedLex so -ftime-report can separate
+ * scanning from the parser actions, and so each is located. */
+static int timedLex(CompilerContext *ctx, YYSTYPE *lvalp, YYLTYPE *llocp, void *scanner);
+#define yylex(lvalp, llocp, scanner) timedLex(ctx, lvalp, llocp, scanner)
 
-#line 169 "parse.c" /* yacc.c:358  */
+#line 197 "parse.c"
 
 #ifdef short
 # undef short
 #endif
 
-#ifdef YYTYPE_UINT8
-typedef YYTYPE_UINT8 yytype_uint8;
-#else
-typedef unsigned char yytype_uint8;
+/* On compilers that do not define __PTRDIFF_MAX__ etc., make sure
+   <limits.h> and (if available) <stdint.h> are included
+   so that the code can choose integer types of a good width.  */
+
+#ifndef __PTRDIFF_MAX__
+# include <limits.h> /* INFRINGES ON USER NAME SPACE */
+# if defined __STDC_VERSION__ && 199901 <= __STDC_VERSION__
+#  include <stdint.h> /* INFRINGES ON USER NAME SPACE */
+#  define YY_STDINT_H
+# endif
 #endif
 
-#ifdef YYTYPE_INT8
-typedef YYTYPE_INT8 yytype_int8;
+/* Narrow types that promote to a signed type and that can represent a
+   signed or unsigned integer of at least N bits.  In tables they can
+   save space and decrease cache pressure.  Promoting to a signed type
+   helps avoid bugs in integer arithmetic.  */
+
+#ifdef __INT_LEAST8_MAX__
+typedef __INT_LEAST8_TYPE__ yytype_int8;
+#elif defined YY_STDINT_H
+typedef int_least8_t yytype_int8;
 #else
 typedef signed char yytype_int8;
 #endif
 
-#ifdef YYTYPE_UINT16
-typedef YYTYPE_UINT16 yytype_uint16;
+#ifdef __INT_LEAST16_MAX__
+typedef __INT_LEAST16_TYPE__ yytype_int16;
+#elif defined YY_STDINT_H
+typedef int_least16_t yytype_int16;
+#else
+typedef short yytype_int16;
+#endif
+
+/* Work around bug in HP-UX 11.23, which defines these macros
+   incorrectly for preprocessor constants.  This workaround can likely
+   be removed in 2023, as HPE has promised support for HP-UX 11.23
+   (aka HP-UX 11i v2) only through the end of 2022; see Table 2 of
+   <https://h20195.www2.hpe.com/V2/getpdf.aspx/4AA4-7673ENW.pdf>.  */
+#ifdef __hpux
+# undef UINT_LEAST8_MAX
+# undef UINT_LEAST16_MAX
+# define UINT_LEAST8_MAX 255
+# define UINT_LEAST16_MAX 65535
+#endif
+
+#if defined __UINT_LEAST8_MAX__ && __UINT_LEAST8_MAX__ <= __INT_MAX__
+typedef __UINT_LEAST8_TYPE__ yytype_uint8;
+#elif (!defined __UINT_LEAST8_MAX__ && defined YY_STDINT_H \
+       && UINT_LEAST8_MAX <= INT_MAX)
+typedef uint_least8_t yytype_uint8;
+#elif !defined __UINT_LEAST8_MAX__ && UCHAR_MAX <= INT_MAX
+typedef unsigned char yytype_uint8;
 #else
-typedef unsigned short int yytype_uint16;
+typedef short yytype_uint8;
 #endif
 
-#ifdef YYTYPE_INT16
-typedef YYTYPE_INT16 yytype_int16;
+#if defined __UINT_LEAST16_MAX__ && __UINT_LEAST16_MAX__ <= __INT_MAX__
+typedef __UINT_LEAST16_TYPE__ yytype_uint16;
+#elif (!defined __UINT_LEAST16_MAX__ && defined YY_STDINT_H \
+       && UINT_LEAST16_MAX <= INT_MAX)
+typedef uint_least16_t yytype_uint16;
+#elif !defined __UINT_LEAST16_MAX__ && USHRT_MAX <= INT_MAX
+typedef unsigned short yytype_uint16;
 #else
-typedef short int yytype_int16;
+typedef int yytype_uint16;
+#endif
+
+#ifndef YYPTRDIFF_T
+# if defined __PTRDIFF_TYPE__ && defined __PTRDIFF_MAX__
+#  define YYPTRDIFF_T __PTRDIFF_TYPE__
+#  define YYPTRDIFF_MAXIMUM __PTRDIFF_MAX__
+# elif defined PTRDIFF_MAX
+#  ifndef ptrdiff_t
+#   include <stddef.h> /* INFRINGES ON USER NAME SPACE */
+#  endif
+#  define YYPTRDIFF_T ptrdiff_t
+#  define YYPTRDIFF_MAXIMUM PTRDIFF_MAX
+# else
+#  define YYPTRDIFF_T long
+#  define YYPTRDIFF_MAXIMUM LONG_MAX
+# endif
 #endif
 
 #ifndef YYSIZE_T
@@ -200,15 +287,28 @@ typedef short int yytype_int16;
 #  define YYSIZE_T __SIZE_TYPE__
 # elif defined size_t
 #  define YYSIZE_T size_t
-# elif ! defined YYSIZE_T
+# elif defined __STDC_VERSION__ && 199901 <= __STDC_VERSION__
 #  include <stddef.h> /* INFRINGES ON USER NAME SPACE */
 #  define YYSIZE_T size_t
 # else
-#  define YYSIZE_T unsigned int
+#  define YYSIZE_T unsigned
 # endif
 #endif
 
-#define YYSIZE_MAXIMUM ((YYSIZE_T) -1)
+#define YYSIZE_MAXIMUM                                  \
+  YY_CAST (YYPTRDIFF_T,                                 \
+           (YYPTRDIFF_MAXIMUM < YY_CAST (YYSIZE_T, -1)  \
+            ? YYPTRDIFF_MAXIMUM                         \
+            : YY_CAST (YYSIZE_T, -1)))
+
+#define YYSIZEOF(X) YY_CAST (YYPTRDIFF_T, sizeof (X))
+
+
+/* Stored state numbers (used for stacks). */
+typedef yytype_int8 yy_state_t;
+
+/* State numbers in computations.  */
+typedef int yy_state_fast_t;
 
 #ifndef YY_
 # if defined YYENABLE_NLS && YYENABLE_NLS
@@ -222,47 +322,43 @@ typedef short int yytype_int16;
 # endif
 #endif
 
-#ifndef YY_ATTRIBUTE
-# if (defined __GNUC__                                               \
-      && (2 < __GNUC__ || (__GNUC__ == 2 && 96 <= __GNUC_MINOR__)))  \
-     || defined __SUNPRO_C && 0x5110 <= __SUNPRO_C
-#  define YY_ATTRIBUTE(Spec) __attribute__(Spec)
-# else
-#  define YY_ATTRIBUTE(Spec) /* empty */
-# endif
-#endif
 
 #ifndef YY_ATTRIBUTE_PURE
-# define YY_ATTRIBUTE_PURE   YY_ATTRIBUTE ((__pure__))
+# if defined __GNUC__ && 2 < __GNUC__ + (96 <= __GNUC_MINOR__)
+#  define YY_ATTRIBUTE_PURE __attribute__ ((__pure__))
+# else
+#  define YY_ATTRIBUTE_PURE
+# endif
 #endif
 
 #ifndef YY_ATTRIBUTE_UNUSED
-# define YY_ATTRIBUTE_UNUSED YY_ATTRIBUTE ((__unused__))
-#endif
-
-#if !defined _Noreturn \
-     && (!defined __STDC_VERSION__ || __STDC_VERSION__ < 201112)
-# if defined _MSC_VER && 1200 <= _MSC_VER
-#  define _Noreturn __declspec (noreturn)
+# if defined __GNUC__ && 2 < __GNUC__ + (7 <= __GNUC_MINOR__)
+#  define YY_ATTRIBUTE_UNUSED __attribute__ ((__unused__))
 # else
-#  define _Noreturn YY_ATTRIBUTE ((__noreturn__))
+#  define YY_ATTRIBUTE_UNUSED
 # endif
 #endif
 
 /* Suppress unused-variable warnings by "using" E.  */
 #if ! defined lint || defined __GNUC__
-# define YYUSE(E) ((void) (E))
+# define YY_USE(E) ((void) (E))
 #else
-# define YYUSE(E) /* empty */
+# define YY_USE(E) /* empty */
 #endif
 
-#if defined __GNUC__ && 407 <= __GNUC__ * 100 + __GNUC_MINOR__
 /* Suppress an incorrect diagnostic about yylval being uninitialized.  */
-# define YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN \
-    _Pragma ("GCC diagnostic push") \
-    _Pragma ("GCC diagnostic ignored \"-Wuninitialized\"")\
+#if defined __GNUC__ && ! defined __ICC && 406 <= __GNUC__ * 100 + __GNUC_MINOR__
+# if __GNUC__ * 100 + __GNUC_MINOR__ < 407
+#  define YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN                           \
+    _Pragma ("GCC diagnostic push")                                     \
+    _Pragma ("GCC diagnostic ignored \"-Wuninitialized\"")
+# else
+#  define YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN                           \
+    _Pragma ("GCC diagnostic push")                                     \
+    _Pragma ("GCC diagnostic ignored \"-Wuninitialized\"")              \
     _Pragma ("GCC diagnostic ignored \"-Wmaybe-uninitialized\"")
-# define YY_IGNORE_MAYBE_UNINITIALIZED_END \
+# endif
+# define YY_IGNORE_MAYBE_UNINITIALIZED_END      \
     _Pragma ("GCC diagnostic pop")
 #else
 # define YY_INITIAL_VALUE(Value) Value
@@ -275,8 +371,22 @@ typedef short int yytype_int16;
 # define YY_INITIAL_VALUE(Value) /* Nothing. */
 #endif
 
+#if defined __cplusplus && defined __GNUC__ && ! defined __ICC && 6 <= __GNUC__
+# define YY_IGNORE_USELESS_CAST_BEGIN                          \
+    _Pragma ("GCC diagnostic push")                            \
+    _Pragma ("GCC diagnostic ignored \"-Wuseless-cast\"")
+# define YY_IGNORE_USELESS_CAST_END            \
+    _Pragma ("GCC diagnostic pop")
+#endif
+#ifndef YY_IGNORE_USELESS_CAST_BEGIN
+# define YY_IGNORE_USELESS_CAST_BEGIN
+# define YY_IGNORE_USELESS_CAST_END
+#endif
+
 
-#if ! defined yyoverflow || YYERROR_VERBOSE
+#define YY_ASSERT(E) ((void) (0 && (E)))
+
+#if !defined yyoverflow
 
 /* The parser invokes alloca or malloc; define the necessary symbols.  */
 
@@ -341,28 +451,30 @@ void free (void *); /* INFRINGES ON USER NAME SPACE */
 #   endif
 #  endif
 # endif
-#endif /* ! defined yyoverflow || YYERROR_VERBOSE */
-
+#endif /* !defined yyoverflow */
 
 #if (! defined yyoverflow \
      && (! defined __cplusplus \
-         || (defined YYSTYPE_IS_TRIVIAL && YYSTYPE_IS_TRIVIAL)))
+         || (defined YYLTYPE_IS_TRIVIAL && YYLTYPE_IS_TRIVIAL \
+             && defined YYSTYPE_IS_TRIVIAL && YYSTYPE_IS_TRIVIAL)))
 
 /* A type that is properly aligned for any stack member.  */
 union yyalloc
 {
-  yytype_int16 yyss_alloc;
+  yy_state_t yyss_alloc;
   YYSTYPE yyvs_alloc;
+  YYLTYPE yyls_alloc;
 };
 
 /* The size of the maximum gap between one aligned stack and the next.  */
-# define YYSTACK_GAP_MAXIMUM (sizeof (union yyalloc) - 1)
+# define YYSTACK_GAP_MAXIMUM (YYSIZEOF (union yyalloc) - 1)
 
 /* The size of an array large to enough to hold all stacks, each with
    N elements.  */
 # define YYSTACK_BYTES(N) \
-     ((N) * (sizeof (yytype_int16) + sizeof (YYSTYPE)) \
-      + YYSTACK_GAP_MAXIMUM)
+     ((N) * (YYSIZEOF (yy_state_t) + YYSIZEOF (YYSTYPE) \
+             + YYSIZEOF (YYLTYPE)) \
+      + 2 * YYSTACK_GAP_MAXIMUM)
 
 # define YYCOPY_NEEDED 1
 
@@ -374,11 +486,11 @@ union yyalloc
 # define YYSTACK_RELOCATE(Stack_alloc, Stack)                           \
     do                                                                  \
       {                                                                 \
-        YYSIZE_T yynewbytes;                                            \
+        YYPTRDIFF_T yynewbytes;                                         \
         YYCOPY (&yyptr->Stack_alloc, Stack, yysize);                    \
         Stack = &yyptr->Stack_alloc;                                    \
-        yynewbytes = yystacksize * sizeof (*Stack) + YYSTACK_GAP_MAXIMUM; \
-        yyptr += yynewbytes / sizeof (*yyptr);                          \
+        yynewbytes = yystacksize * YYSIZEOF (*Stack) + YYSTACK_GAP_MAXIMUM; \
+        yyptr += yynewbytes / YYSIZEOF (*yyptr);                        \
       }                                                                 \
     while (0)
 
@@ -390,12 +502,12 @@ union yyalloc
 # ifndef YYCOPY
 #  if defined __GNUC__ && 1 < __GNUC__
 #   define YYCOPY(Dst, Src, Count) \
-      __builtin_memcpy (Dst, Src, (Count) * sizeof (*(Src)))
+      __builtin_memcpy (Dst, Src, YY_CAST (YYSIZE_T, (Count)) * sizeof (*(Src)))
 #  else
 #   define YYCOPY(Dst, Src, Count)              \
       do                                        \
         {                                       \
-          YYSIZE_T yyi;                         \
+          YYPTRDIFF_T yyi;                      \
           for (yyi = 0; yyi < (Count); yyi++)   \
             (Dst)[yyi] = (Src)[yyi];            \
         }                                       \
@@ -418,17 +530,20 @@ union yyalloc
 /* YYNSTATES -- Number of states.  */
 #define YYNSTATES  103
 
-/* YYTRANSLATE[YYX] -- Symbol number corresponding to YYX as returned
-   by yylex, with out-of-bounds checking.  */
-#define YYUNDEFTOK  2
+/* YYMAXUTOK -- Last valid token kind.  */
 #define YYMAXUTOK   285
 
-#define YYTRANSLATE(YYX)                                                \
-  ((unsigned int) (YYX) <= YYMAXUTOK ? yytranslate[YYX] : YYUNDEFTOK)
+
+/* YYTRANSLATE(TOKEN-NUM) -- Symbol number corresponding to TOKEN-NUM
+   as returned by yylex, with out-of-bounds checking.  */
+#define YYTRANSLATE(YYX)                                \
+  (0 <= (YYX) && (YYX) <= YYMAXUTOK                     \
+   ? YY_CAST (yysymbol_kind_t, yytranslate[YYX])        \
+   : YYSYMBOL_YYUNDEF)
 
 /* YYTRANSLATE[TOKEN-NUM] -- Symbol number corresponding to TOKEN-NUM
-   as returned by yylex, without out-of-bounds checking.  */
-static const yytype_uint8 yytranslate[] =
+   as returned by yylex.  */
+static const yytype_int8 yytranslate[] =
 {
        0,     2,     2,     2,     2,     2,     2,     2,     2,     2,
        2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
@@ -462,61 +577,63 @@ static const yytype_uint8 yytranslate[] =
 };
 
 #if YYDEBUG
-  /* YYRLINE[YYN] -- Source line where rule number YYN was defined.  */
+/* YYRLINE[YYN] -- Source line where rule number YYN was defined.  */
 static const yytype_uint8 yyrline[] =
 {
-       0,    39,    39,    42,    43,    46,    47,    50,    51,    54,
-      55,    58,    61,    64,    67,    68,    71,    72,    75,    76,
-      81,    82,    85,    86,    89,    90,    91,    92,    93,    96,
-      97,   100,   101,   104,   107,   108,   111,   112,   115,   116,
-     119,   120,   123,   124,   125,   126,   127,   128,   131,   132,
-     135,   136,   139,   140,   143,   144,   147,   148,   149,   150,
-     153,   156,   157,   160,   161
+       0,    69,    69,    72,    73,    76,    77,    80,    81,    84,
+      85,    88,    91,    94,    97,    98,   101,   102,   105,   106,
+     111,   112,   115,   116,   119,   120,   121,   122,   123,   126,
+     127,   130,   131,   134,   137,   138,   141,   142,   145,   146,
+     149,   150,   153,   154,   155,   156,   157,   158,   161,   162,
+     165,   166,   169,   170,   173,   174,   177,   178,   179,   180,
+     183,   186,   187,   190,   191
 };
 #endif
 
-#if YYDEBUG || YYERROR_VERBOSE || 0
+/** Accessing symbol of state STATE.  */
+#define YY_ACCESSING_SYMBOL(State) YY_CAST (yysymbol_kind_t, yystos[State])
+
+#if YYDEBUG || 0
+/* The user-facing name of the symbol whose (internal) number is
+   YYSYMBOL.  No bounds checking.  */
+static const char *yysymbol_name (yysymbol_kind_t yysymbol) YY_ATTRIBUTE_UNUSED;
+
 /* YYTNAME[SYMBOL-NUM] -- String name of the symbol SYMBOL-NUM.
    First, the terminals, then, starting at YYNTOKENS, nonterminals.  */
 static const char *const yytname[] =
 {
-  "$end", "error", "$undefined", "IF", "ELSE", "RETURN", "WHILE", "INT",
-  "VOID", "LBracket", "RBracket", "LBrace", "RBrace", "Quote", "LSB",
-  "RSB", "COMMA", "SEMI", "ASSIGN", "MINUS", "PLUS", "MULTI", "DIV", "GT",
-  "LT", "GE", "LE", "EQ", "NE", "NUMBER", "ID", "$accept", "program",
-  "declaration_list", "declaration", "type_specifier", "var_declaration",
-  "fun_declaration", "fun_head", "compound_stmt", "params", "param_list",
-  "param", "local_declarations", "statement_list", "statement",
-  "expression_stmt", "selection_stmt", "iteration_stmt", "return_stmt",
-  "expression", "var", "simple_expression", "relop", "additive_expression",
-  "addop", "term", "mulop", "factor", "call", "args", "arg_list", YY_NULLPTR
+  "\"end of file\"", "error", "\"invalid token\"", "IF", "ELSE", "RETURN",
+  "WHILE", "INT", "VOID", "LBracket", "RBracket", "LBrace", "RBrace",
+  "Quote", "LSB", "RSB", "COMMA", "SEMI", "ASSIGN", "MINUS", "PLUS",
+  "MULTI", "DIV", "GT", "LT", "GE", "LE", "EQ", "NE", "NUMBER", "ID",
+  "$accept", "program", "declaration_list", "declaration",
+  "type_specifier", "var_declaration", "fun_declaration", "fun_head",
+  "compound_stmt", "params", "param_list", "param", "local_declarations",
+  "statement_list", "statement", "expression_stmt", "selection_stmt",
+  "iteration_stmt", "return_stmt", "expression", "var",
+  "simple_expression", "relop", "additive_expression", "addop", "term",
+  "mulop", "factor", "call", "args", "arg_list", YY_NULLPTR
 };
-#endif
 
-# ifdef YYPRINT
-/* YYTOKNUM[NUM] -- (External) token number corresponding to the
-   (internal) symbol number NUM (which must be that of a token).  */
-static const yytype_uint16 yytoknum[] =
+static const char *
+yysymbol_name (yysymbol_kind_t yysymbol)
 {
-       0,   256,   257,   258,   259,   260,   261,   262,   263,   264,
-     265,   266,   267,   268,   269,   270,   271,   272,   273,   274,
-     275,   276,   277,   278,   279,   280,   281,   282,   283,   284,
-     285
-};
-# endif
+  return yytname[yysymbol];
+}
+#endif
 
-#define YYPACT_NINF -91
+#define YYPACT_NINF (-91)
 
-#define yypact_value_is_default(Yystate) \
-  (!!((Yystate) == (-91)))
+#define yypact_value_is_default(Yyn) \
+  ((Yyn) == YYPACT_NINF)
 
-#define YYTABLE_NINF -16
+#define YYTABLE_NINF (-16)
 
-#define yytable_value_is_error(Yytable_value) \
+#define yytable_value_is_error(Yyn) \
   0
 
-  /* YYPACT[STATE-NUM] -- Index in YYTABLE of the portion describing
-     STATE-NUM.  */
+/* YYPACT[STATE-NUM] -- Index in YYTABLE of the portion describing
+   STATE-NUM.  */
 static const yytype_int8 yypact[] =
 {
       38,   -91,   -91,     1,    38,   -91,   -23,   -91,   -91,    10,
@@ -532,10 +649,10 @@ static const yytype_int8 yypact[] =
      -91,    13,   -91
 };
 
-  /* YYDEFACT[STATE-NUM] -- Default reduction number in state STATE-NUM.
-     Performed when YYTABLE does not specify something else to do.  Zero
-     means the default is an error.  */
-static const yytype_uint8 yydefact[] =
+/* YYDEFACT[STATE-NUM] -- Default reduction number in state STATE-NUM.
+   Performed when YYTABLE does not specify something else to do.  Zero
+   means the default is an error.  */
+static const yytype_int8 yydefact[] =
 {
        0,     7,     8,     0,     2,     4,     0,     5,     6,     0,
        1,     3,     0,    21,    11,     0,     0,     9,    23,     8,
@@ -550,7 +667,7 @@ static const yytype_uint8 yydefact[] =
       63,     0,    32
 };
 
-  /* YYPGOTO[NTERM-NUM].  */
+/* YYPGOTO[NTERM-NUM].  */
 static const yytype_int8 yypgoto[] =
 {
      -91,   -91,   -91,    85,    21,    73,   -91,   -91,    69,   -91,
@@ -559,18 +676,18 @@ static const yytype_int8 yypgoto[] =
      -91
 };
 
-  /* YYDEFGOTO[NTERM-NUM].  */
+/* YYDEFGOTO[NTERM-NUM].  */
 static const yytype_int8 yydefgoto[] =
 {
-      -1,     3,     4,     5,     6,     7,     8,     9,    41,    21,
+       0,     3,     4,     5,     6,     7,     8,     9,    41,    21,
       22,    23,    18,    27,    42,    43,    44,    45,    46,    47,
       48,    49,    74,    50,    75,    51,    78,    52,    53,    85,
       86
 };
 
-  /* YYTABLE[YYPACT[STATE-NUM]] -- What to do in state STATE-NUM.  If
-     positive, shift that token.  If negative, reduce the rule whose
-     number is the opposite.  If YYTABLE_NINF, syntax error.  */
+/* YYTABLE[YYPACT[STATE-NUM]] -- What to do in state STATE-NUM.  If
+   positive, shift that token.  If negative, reduce the rule whose
+   number is the opposite.  If YYTABLE_NINF, syntax error.  */
 static const yytype_int8 yytable[] =
 {
       59,    10,    61,    98,    99,    15,    33,    12,    34,    35,
@@ -599,9 +716,9 @@ static const yytype_int8 yycheck[] =
       74,    18,    15,    78,    75,    -1,    -1,    30
 };
 
-  /* YYSTOS[STATE-NUM] -- The (internal number of the) accessing
-     symbol of state STATE-NUM.  */
-static const yytype_uint8 yystos[] =
+/* YYSTOS[STATE-NUM] -- The symbol kind of the accessing symbol of
+   state STATE-NUM.  */
+static const yytype_int8 yystos[] =
 {
        0,     7,     8,    32,    33,    34,    35,    36,    37,    38,
        0,    34,    30,    11,    39,     9,    14,    17,    43,     8,
@@ -616,8 +733,8 @@ static const yytype_uint8 yystos[] =
       50,     4,    45
 };
 
-  /* YYR1[YYN] -- Symbol number of symbol that rule YYN derives.  */
-static const yytype_uint8 yyr1[] =
+/* YYR1[RULE-NUM] -- Symbol kind of the left-hand side of rule RULE-NUM.  */
+static const yytype_int8 yyr1[] =
 {
        0,    31,    32,    33,    33,    34,    34,    35,    35,    36,
       36,    37,    38,    39,    40,    40,    41,    41,    42,    42,
@@ -628,8 +745,8 @@ static const yytype_uint8 yyr1[] =
       59,    60,    60,    61,    61
 };
 
-  /* YYR2[YYN] -- Number of symbols on the right hand side of rule YYN.  */
-static const yytype_uint8 yyr2[] =
+/* YYR2[RULE-NUM] -- Number of symbols on the right-hand side of rule RULE-NUM.  */
+static const yytype_int8 yyr2[] =
 {
        0,     2,     1,     2,     1,     1,     1,     1,     1,     3,
        6,     2,     5,     4,     1,     1,     3,     1,     2,     4,
@@ -641,39 +758,65 @@ static const yytype_uint8 yyr2[] =
 };
 
 
+enum { YYENOMEM = -2 };
+
 #define yyerrok         (yyerrstatus = 0)
 #define yyclearin       (yychar = YYEMPTY)
-#define YYEMPTY         (-2)
-#define YYEOF           0
 
 #define YYACCEPT        goto yyacceptlab
 #define YYABORT         goto yyabortlab
 #define YYERROR         goto yyerrorlab
+#define YYNOMEM         goto yyexhaustedlab
 
 
 #define YYRECOVERING()  (!!yyerrstatus)
 
-#define YYBACKUP(Token, Value)                                  \
-do                                                              \
-  if (yychar == YYEMPTY)                                        \
-    {                                                           \
-      yychar = (Token);                                         \
-      yylval = (Value);                                         \
-      YYPOPSTACK (yylen);                                       \
-      yystate = *yyssp;                                         \
-      goto yybackup;                                            \
-    }                                                           \
-  else                                                          \
-    {                                                           \
-      yyerror (YY_("syntax error: cannot back up")); \
-      YYERROR;                                                  \
-    }                                                           \
-while (0)
-
-/* Error token number */
-#define YYTERROR        1
-#define YYERRCODE       256
+#define YYBACKUP(Token, Value)                                    \
+  do                                                              \
+    if (yychar == YYEMPTY)                                        \
+      {                                                           \
+        yychar = (Token);                                         \
+        yylval = (Value);                                         \
+        YYPOPSTACK (yylen);                                       \
+        yystate = *yyssp;                                         \
+        goto yybackup;                                            \
+      }                                                           \
+    else                                                          \
+      {                                                           \
+        yyerror (&yylloc, scanner, ctx, YY_("syntax error: cannot back up")); \
+        YYERROR;                                                  \
+      }                                                           \
+  while (0)
+
+/* Backward compatibility with an undocumented macro.
+   Use YYerror or YYUNDEF. */
+#define YYERRCODE YYUNDEF
+
+/* YYLLOC_DEFAULT -- Set CURRENT to span from RHS[1] to RHS[N].
+   If N is 0, then set CURRENT to the empty location which ends
+   the previous symbol: RHS[0] (always defined).  */
+
+#ifndef YYLLOC_DEFAULT
+# define YYLLOC_DEFAULT(Current, Rhs, N)                                \
+    do                                                                  \
+      if (N)                                                            \
+        {                                                               \
+          (Current).first_line   = YYRHSLOC (Rhs, 1).first_line;        \
+          (Current).first_column = YYRHSLOC (Rhs, 1).first_column;      \
+          (Current).last_line    = YYRHSLOC (Rhs, N).last_line;         \
+          (Current).last_column  = YYRHSLOC (Rhs, N).last_column;       \
+        }                                                               \
+      else                                                              \
+        {                                                               \
+          (Current).first_line   = (Current).last_line   =              \
+            YYRHSLOC (Rhs, 0).last_line;                                \
+          (Current).first_column = (Current).last_column =              \
+            YYRHSLOC (Rhs, 0).last_column;                              \
+        }                                                               \
+    while (0)
+#endif
 
+#define YYRHSLOC(Rhs, K) ((Rhs)[K])
 
 
 /* Enable debugging if requested.  */
@@ -690,55 +833,114 @@ do {                                            \
     YYFPRINTF Args;                             \
 } while (0)
 
-/* This macro is provided for backward compatibility. */
-#ifndef YY_LOCATION_PRINT
-# define YY_LOCATION_PRINT(File, Loc) ((void) 0)
-#endif
 
+/* YYLOCATION_PRINT -- Print the location on the stream.
+   This macro was not mandated originally: define only if we know
+   we won't break user code: when these are the locations we know.  */
+
+# ifndef YYLOCATION_PRINT
+
+#  if defined YY_LOCATION_PRINT
+
+   /* Temporary convenience wrapper in case some people defined the
+      undocumented and private YY_LOCATION_PRINT macros.  */
+#   define YYLOCATION_PRINT(File, Loc)  YY_LOCATION_PRINT(File, *(Loc))
+
+#  elif defined YYLTYPE_IS_TRIVIAL && YYLTYPE_IS_TRIVIAL
 
-# define YY_SYMBOL_PRINT(Title, Type, Value, Location)                    \
+/* Print *YYLOCP on YYO.  Private, do not rely on its existence. */
+
+YY_ATTRIBUTE_UNUSED
+static int
+yy_location_print_ (FILE *yyo, YYLTYPE const * const yylocp)
+{
+  int res = 0;
+  int end_col = 0 != yylocp->last_column ? yylocp->last_column - 1 : 0;
+  if (0 <= yylocp->first_line)
+    {
+      res += YYFPRINTF (yyo, "%d", yylocp->first_line);
+      if (0 <= yylocp->first_column)
+        res += YYFPRINTF (yyo, ".%d", yylocp->first_column);
+    }
+  if (0 <= yylocp->last_line)
+    {
+      if (yylocp->first_line < yylocp->last_line)
+        {
+          res += YYFPRINTF (yyo, "-%d", yylocp->last_line);
+          if (0 <= end_col)
+            res += YYFPRINTF (yyo, ".%d", end_col);
+        }
+      else if (0 <= end_col && yylocp->first_column < end_col)
+        res += YYFPRINTF (yyo, "-%d", end_col);
+    }
+  return res;
+}
+
+#   define YYLOCATION_PRINT  yy_location_print_
+
+    /* Temporary convenience wrapper in case some people defined the
+       undocumented and private YY_LOCATION_PRINT macros.  */
+#   define YY_LOCATION_PRINT(File, Loc)  YYLOCATION_PRINT(File, &(Loc))
+
+#  else
+
+#   define YYLOCATION_PRINT(File, Loc) ((void) 0)
+    /* Temporary convenience wrapper in case some people defined the
+       undocumented and private YY_LOCATION_PRINT macros.  */
+#   define YY_LOCATION_PRINT  YYLOCATION_PRINT
+
+#  endif
+# endif /* !defined YYLOCATION_PRINT */
+
+
+# define YY_SYMBOL_PRINT(Title, Kind, Value, Location)                    \
 do {                                                                      \
   if (yydebug)                                                            \
     {                                                                     \
       YYFPRINTF (stderr, "%s ", Title);                                   \
       yy_symbol_print (stderr,                                            \
-                  Type, Value); \
+                  Kind, Value, Location, scanner, ctx); \
       YYFPRINTF (stderr, "\n");                                           \
     }                                                                     \
 } while (0)
 
 
-/*----------------------------------------.
-| Print this symbol's value on YYOUTPUT.  |
-`----------------------------------------*/
+/*-----------------------------------.
+| Print this symbol's value on YYO.  |
+`-----------------------------------*/
 
 static void
-yy_symbol_value_print (FILE *yyoutput, int yytype, YYSTYPE const * const yyvaluep)
+yy_symbol_value_print (FILE *yyo,
+                       yysymbol_kind_t yykind, YYSTYPE const * const yyvaluep, YYLTYPE const * const yylocationp, void *scanner, CompilerContext *ctx)
 {
-  FILE *yyo = yyoutput;
-  YYUSE (yyo);
+  FILE *yyoutput = yyo;
+  YY_USE (yyoutput);
+  YY_USE (yylocationp);
+  YY_USE (scanner);
+  YY_USE (ctx);
   if (!yyvaluep)
     return;
-# ifdef YYPRINT
-  if (yytype < YYNTOKENS)
-    YYPRINT (yyoutput, yytoknum[yytype], *yyvaluep);
-# endif
-  YYUSE (yytype);
+  YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
+  YY_USE (yykind);
+  YY_IGNORE_MAYBE_UNINITIALIZED_END
 }
 
 
-/*--------------------------------.
-| Print this symbol on YYOUTPUT.  |
-`--------------------------------*/
+/*---------------------------.
+| Print this symbol on YYO.  |
+`---------------------------*/
 
 static void
-yy_symbol_print (FILE *yyoutput, int yytype, YYSTYPE const * const yyvaluep)
+yy_symbol_print (FILE *yyo,
+                 yysymbol_kind_t yykind, YYSTYPE const * const yyvaluep, YYLTYPE const * const yylocationp, void *scanner, CompilerContext *ctx)
 {
-  YYFPRINTF (yyoutput, "%s %s (",
-             yytype < YYNTOKENS ? "token" : "nterm", yytname[yytype]);
+  YYFPRINTF (yyo, "%s %s (",
+             yykind < YYNTOKENS ? "token" : "nterm", yysymbol_name (yykind));
 
-  yy_symbol_value_print (yyoutput, yytype, yyvaluep);
-  YYFPRINTF (yyoutput, ")");
+  YYLOCATION_PRINT (yyo, yylocationp);
+  YYFPRINTF (yyo, ": ");
+  yy_symbol_value_print (yyo, yykind, yyvaluep, yylocationp, scanner, ctx);
+  YYFPRINTF (yyo, ")");
 }
 
 /*------------------------------------------------------------------.
@@ -747,7 +949,7 @@ yy_symbol_print (FILE *yyoutput, int yytype, YYSTYPE const * const yyvaluep)
 `------------------------------------------------------------------*/
 
 static void
-yy_stack_print (yytype_int16 *yybottom, yytype_int16 *yytop)
+yy_stack_print (yy_state_t *yybottom, yy_state_t *yytop)
 {
   YYFPRINTF (stderr, "Stack now");
   for (; yybottom <= yytop; yybottom++)
@@ -770,21 +972,22 @@ do {                                                            \
 `------------------------------------------------*/
 
 static void
-yy_reduce_print (yytype_int16 *yyssp, YYSTYPE *yyvsp, int yyrule)
+yy_reduce_print (yy_state_t *yyssp, YYSTYPE *yyvsp, YYLTYPE *yylsp,
+                 int yyrule, void *scanner, CompilerContext *ctx)
 {
-  unsigned long int yylno = yyrline[yyrule];
+  int yylno = yyrline[yyrule];
   int yynrhs = yyr2[yyrule];
   int yyi;
-  YYFPRINTF (stderr, "Reducing stack by rule %d (line %lu):\n",
+  YYFPRINTF (stderr, "Reducing stack by rule %d (line %d):\n",
              yyrule - 1, yylno);
   /* The symbols being reduced.  */
   for (yyi = 0; yyi < yynrhs; yyi++)
     {
       YYFPRINTF (stderr, "   $%d = ", yyi + 1);
       yy_symbol_print (stderr,
-                       yystos[yyssp[yyi + 1 - yynrhs]],
-                       &(yyvsp[(yyi + 1) - (yynrhs)])
-                                              );
+                       YY_ACCESSING_SYMBOL (+yyssp[yyi + 1 - yynrhs]),
+                       &yyvsp[(yyi + 1) - (yynrhs)],
+                       &(yylsp[(yyi + 1) - (yynrhs)]), scanner, ctx);
       YYFPRINTF (stderr, "\n");
     }
 }
@@ -792,15 +995,15 @@ yy_reduce_print (yytype_int16 *yyssp, YYSTYPE *yyvsp, int yyrule)
 # define YY_REDUCE_PRINT(Rule)          \
 do {                                    \
   if (yydebug)                          \
-    yy_reduce_print (yyssp, yyvsp, Rule); \
+    yy_reduce_print (yyssp, yyvsp, yylsp, Rule, scanner, ctx); \
 } while (0)
 
 /* Nonzero means print parse trace.  It is left uninitialized so that
    multiple parsers can coexist.  */
 int yydebug;
 #else /* !YYDEBUG */
-# define YYDPRINTF(Args)
-# define YY_SYMBOL_PRINT(Title, Type, Value, Location)
+# define YYDPRINTF(Args) ((void) 0)
+# define YY_SYMBOL_PRINT(Title, Kind, Value, Location)
 # define YY_STACK_PRINT(Bottom, Top)
 # define YY_REDUCE_PRINT(Rule)
 #endif /* !YYDEBUG */
@@ -823,255 +1026,34 @@ int yydebug;
 #endif
 
 
-#if YYERROR_VERBOSE
 
-# ifndef yystrlen
-#  if defined __GLIBC__ && defined _STRING_H
-#   define yystrlen strlen
-#  else
-/* Return the length of YYSTR.  */
-static YYSIZE_T
-yystrlen (const char *yystr)
-{
-  YYSIZE_T yylen;
-  for (yylen = 0; yystr[yylen]; yylen++)
-    continue;
-  return yylen;
-}
-#  endif
-# endif
 
-# ifndef yystpcpy
-#  if defined __GLIBC__ && defined _STRING_H && defined _GNU_SOURCE
-#   define yystpcpy stpcpy
-#  else
-/* Copy YYSRC to YYDEST, returning the address of the terminating '\0' in
-   YYDEST.  */
-static char *
-yystpcpy (char *yydest, const char *yysrc)
-{
-  char *yyd = yydest;
-  const char *yys = yysrc;
 
-  while ((*yyd++ = *yys++) != '\0')
-    continue;
-
-  return yyd - 1;
-}
-#  endif
-# endif
-
-# ifndef yytnamerr
-/* Copy to YYRES the contents of YYSTR after stripping away unnecessary
-   quotes and backslashes, so that it's suitable for yyerror.  The
-   heuristic is that double-quoting is unnecessary unless the string
-   contains an apostrophe, a comma, or backslash (other than
-   backslash-backslash).  YYSTR is taken from yytname.  If YYRES is
-   null, do not copy; instead, return the length of what the result
-   would have been.  */
-static YYSIZE_T
-yytnamerr (char *yyres, const char *yystr)
-{
-  if (*yystr == '"')
-    {
-      YYSIZE_T yyn = 0;
-      char const *yyp = yystr;
-
-      for (;;)
-        switch (*++yyp)
-          {
-          case '\'':
-          case ',':
-            goto do_not_strip_quotes;
-
-          case '\\':
-            if (*++yyp != '\\')
-              goto do_not_strip_quotes;
-            /* Fall through.  */
-          default:
-            if (yyres)
-              yyres[yyn] = *yyp;
-            yyn++;
-            break;
-
-          case '"':
-            if (yyres)
-              yyres[yyn] = '\0';
-            return yyn;
-          }
-    do_not_strip_quotes: ;
-    }
-
-  if (! yyres)
-    return yystrlen (yystr);
-
-  return yystpcpy (yyres, yystr) - yyres;
-}
-# endif
-
-/* Copy into *YYMSG, which is of size *YYMSG_ALLOC, an error message
-   about the unexpected token YYTOKEN for the state stack whose top is
-   YYSSP.
-
-   Return 0 if *YYMSG was successfully written.  Return 1 if *YYMSG is
-   not large enough to hold the message.  In that case, also set
-   *YYMSG_ALLOC to the required number of bytes.  Return 2 if the
-   required number of bytes is too large to store.  */
-static int
-yysyntax_error (YYSIZE_T *yymsg_alloc, char **yymsg,
-                yytype_int16 *yyssp, int yytoken)
-{
-  YYSIZE_T yysize0 = yytnamerr (YY_NULLPTR, yytname[yytoken]);
-  YYSIZE_T yysize = yysize0;
-  enum { YYERROR_VERBOSE_ARGS_MAXIMUM = 5 };
-  /* Internationalized format string. */
-  const char *yyformat = YY_NULLPTR;
-  /* Arguments of yyformat. */
-  char const *yyarg[YYERROR_VERBOSE_ARGS_MAXIMUM];
-  /* Number of reported tokens (one for the "unexpected", one per
-     "expected"). */
-  int yycount = 0;
-
-  /* There are many possibilities here to consider:
-     - If this state is a consistent state with a default action, then
-       the only way this function was invoked is if the default action
-       is an error action.  In that case, don't check for expected
-       tokens because there are none.
-     - The only way there can be no lookahead present (in yychar) is if
-       this state is a consistent state with a default action.  Thus,
-       detecting the absence of a lookahead is sufficient to determine
-       that there is no unexpected or expected token to report.  In that
-       case, just report a simple "syntax error".
-     - Don't assume there isn't a lookahead just because this state is a
-       consistent state with a default action.  There might have been a
-       previous inconsistent state, consistent state with a non-default
-       action, or user semantic action that manipulated yychar.
-     - Of course, the expected token list depends on states to have
-       correct lookahead information, and it depends on the parser not
-       to perform extra reductions after fetching a lookahead from the
-       scanner and before detecting a syntax error.  Thus, state merging
-       (from LALR or IELR) and default reductions corrupt the expected
-       token list.  However, the list is correct for canonical LR with
-       one exception: it will still contain any token that will not be
-       accepted due to an error action in a later state.
-  */
-  if (yytoken != YYEMPTY)
-    {
-      int yyn = yypact[*yyssp];
-      yyarg[yycount++] = yytname[yytoken];
-      if (!yypact_value_is_default (yyn))
-        {
-          /* Start YYX at -YYN if negative to avoid negative indexes in
-             YYCHECK.  In other words, skip the first -YYN actions for
-             this state because they are default actions.  */
-          int yyxbegin = yyn < 0 ? -yyn : 0;
-          /* Stay within bounds of both yycheck and yytname.  */
-          int yychecklim = YYLAST - yyn + 1;
-          int yyxend = yychecklim < YYNTOKENS ? yychecklim : YYNTOKENS;
-          int yyx;
-
-          for (yyx = yyxbegin; yyx < yyxend; ++yyx)
-            if (yycheck[yyx + yyn] == yyx && yyx != YYTERROR
-                && !yytable_value_is_error (yytable[yyx + yyn]))
-              {
-                if (yycount == YYERROR_VERBOSE_ARGS_MAXIMUM)
-                  {
-                    yycount = 1;
-                    yysize = yysize0;
-                    break;
-                  }
-                yyarg[yycount++] = yytname[yyx];
-                {
-                  YYSIZE_T yysize1 = yysize + yytnamerr (YY_NULLPTR, yytname[yyx]);
-                  if (! (yysize <= yysize1
-                         && yysize1 <= YYSTACK_ALLOC_MAXIMUM))
-                    return 2;
-                  yysize = yysize1;
-                }
-              }
-        }
-    }
-
-  switch (yycount)
-    {
-# define YYCASE_(N, S)                      \
-      case N:                               \
-        yyformat = S;                       \
-      break
-      YYCASE_(0, YY_("syntax error"));
-      YYCASE_(1, YY_("syntax error, unexpected %s"));
-      YYCASE_(2, YY_("syntax error, unexpected %s, expecting %s"));
-      YYCASE_(3, YY_("syntax error, unexpected %s, expecting %s or %s"));
-      YYCASE_(4, YY_("syntax error, unexpected %s, expecting %s or %s or %s"));
-      YYCASE_(5, YY_("syntax error, unexpected %s, expecting %s or %s or %s or %s"));
-# undef YYCASE_
-    }
-
-  {
-    YYSIZE_T yysize1 = yysize + yystrlen (yyformat);
-    if (! (yysize <= yysize1 && yysize1 <= YYSTACK_ALLOC_MAXIMUM))
-      return 2;
-    yysize = yysize1;
-  }
-
-  if (*yymsg_alloc < yysize)
-    {
-      *yymsg_alloc = 2 * yysize;
-      if (! (yysize <= *yymsg_alloc
-             && *yymsg_alloc <= YYSTACK_ALLOC_MAXIMUM))
-        *yymsg_alloc = YYSTACK_ALLOC_MAXIMUM;
-      return 1;
-    }
-
-  /* Avoid sprintf, as that infringes on the user's name space.
-     Don't have undefined behavior even if the translation
-     produced a string with the wrong number of "%s"s.  */
-  {
-    char *yyp = *yymsg;
-    int yyi = 0;
-    while ((*yyp = *yyformat) != '\0')
-      if (*yyp == '%' && yyformat[1] == 's' && yyi < yycount)
-        {
-          yyp += yytnamerr (yyp, yyarg[yyi++]);
-          yyformat += 2;
-        }
-      else
-        {
-          yyp++;
-          yyformat++;
-        }
-  }
-  return 0;
-}
-#endif /* YYERROR_VERBOSE */
 
 /*-----------------------------------------------.
 | Release the memory associated to this symbol.  |
 `-----------------------------------------------*/
 
 static void
-yydestruct (const char *yymsg, int yytype, YYSTYPE *yyvaluep)
+yydestruct (const char *yymsg,
+            yysymbol_kind_t yykind, YYSTYPE *yyvaluep, YYLTYPE *yylocationp, void *scanner, CompilerContext *ctx)
 {
-  YYUSE (yyvaluep);
+  YY_USE (yyvaluep);
+  YY_USE (yylocationp);
+  YY_USE (scanner);
+  YY_USE (ctx);
   if (!yymsg)
     yymsg = "Deleting";
-  YY_SYMBOL_PRINT (yymsg, yytype, yyvaluep, yylocationp);
+  YY_SYMBOL_PRINT (yymsg, yykind, yyvaluep, yylocationp);
 
   YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
-  YYUSE (yytype);
+  YY_USE (yykind);
   YY_IGNORE_MAYBE_UNINITIALIZED_END
 }
 
 
 
 
-/* The lookahead symbol.  */
-int yychar;
-
-/* The semantic value of the lookahead symbol.  */
-YYSTYPE yylval;
-/* Number of syntax errors so far.  */
-int yynerrs;
 
 
 /*----------.
@@ -1079,148 +1061,182 @@ int yynerrs;
 `----------*/
 
 int
-yyparse (void)
+yyparse (void *scanner, CompilerContext *ctx)
 {
-    int yystate;
-    /* Number of tokens to shift before error messages enabled.  */
-    int yyerrstatus;
+/* Lookahead token kind.  */
+int yychar;
+
+
+/* The semantic value of the lookahead symbol.  */
+/* Default value used for initialization, for pacifying older GCCs
+   or non-GCC compilers.  */
+YY_INITIAL_VALUE (static YYSTYPE yyval_default;)
+YYSTYPE yylval YY_INITIAL_VALUE (= yyval_default);
+
+/* Location data for the lookahead symbol.  */
+static YYLTYPE yyloc_default
+# if defined YYLTYPE_IS_TRIVIAL && YYLTYPE_IS_TRIVIAL
+  = { 1, 1, 1, 1 }
+# endif
+;
+YYLTYPE yylloc = yyloc_default;
 
-    /* The stacks and their tools:
-       'yyss': related to states.
-       'yyvs': related to semantic values.
+    /* Number of syntax errors so far.  */
+    int yynerrs = 0;
 
-       Refer to the stacks through separate pointers, to allow yyoverflow
+    yy_state_fast_t yystate = 0;
+    /* Number of tokens to shift before error messages enabled.  */
+    int yyerrstatus = 0;
+
+    /* Refer to the stacks through separate pointers, to allow yyoverflow
        to reallocate them elsewhere.  */
 
-    /* The state stack.  */
-    yytype_int16 yyssa[YYINITDEPTH];
-    yytype_int16 *yyss;
-    yytype_int16 *yyssp;
+    /* Their size.  */
+    YYPTRDIFF_T yystacksize = YYINITDEPTH;
+
+    /* The state stack: array, bottom, top.  */
+    yy_state_t yyssa[YYINITDEPTH];
+    yy_state_t *yyss = yyssa;
+    yy_state_t *yyssp = yyss;
 
-    /* The semantic value stack.  */
+    /* The semantic value stack: array, bottom, top.  */
     YYSTYPE yyvsa[YYINITDEPTH];
-    YYSTYPE *yyvs;
-    YYSTYPE *yyvsp;
+    YYSTYPE *yyvs = yyvsa;
+    YYSTYPE *yyvsp = yyvs;
 
-    YYSIZE_T yystacksize;
+    /* The location stack: array, bottom, top.  */
+    YYLTYPE yylsa[YYINITDEPTH];
+    YYLTYPE *yyls = yylsa;
+    YYLTYPE *yylsp = yyls;
 
   int yyn;
+  /* The return value of yyparse.  */
   int yyresult;
-  /* Lookahead token as an internal (translated) token number.  */
-  int yytoken = 0;
+  /* Lookahead symbol kind.  */
+  yysymbol_kind_t yytoken = YYSYMBOL_YYEMPTY;
   /* The variables used to return semantic value and location from the
      action routines.  */
   YYSTYPE yyval;
+  YYLTYPE yyloc;
+
+  /* The locations where the error started and ended.  */
+  YYLTYPE yyerror_range[3];
+
 
-#if YYERROR_VERBOSE
-  /* Buffer for error messages, and its allocated size.  */
-  char yymsgbuf[128];
-  char *yymsg = yymsgbuf;
-  YYSIZE_T yymsg_alloc = sizeof yymsgbuf;
-#endif
 
-#define YYPOPSTACK(N)   (yyvsp -= (N), yyssp -= (N))
+#define YYPOPSTACK(N)   (yyvsp -= (N), yyssp -= (N), yylsp -= (N))
 
   /* The number of symbols on the RHS of the reduced rule.
      Keep to zero when no symbol should be popped.  */
   int yylen = 0;
 
-  yyssp = yyss = yyssa;
-  yyvsp = yyvs = yyvsa;
-  yystacksize = YYINITDEPTH;
-
   YYDPRINTF ((stderr, "Starting parse\n"));
 
-  yystate = 0;
-  yyerrstatus = 0;
-  yynerrs = 0;
   yychar = YYEMPTY; /* Cause a token to be read.  */
+
+  yylsp[0] = yylloc;
   goto yysetstate;
 
+
 /*------------------------------------------------------------.
-| yynewstate -- Push a new state, which is found in yystate.  |
+| yynewstate -- push a new state, which is found in yystate.  |
 `------------------------------------------------------------*/
- yynewstate:
+yynewstate:
   /* In all cases, when you get here, the value and location stacks
      have just been pushed.  So pushing a state here evens the stacks.  */
   yyssp++;
 
- yysetstate:
-  *yyssp = yystate;
+
+/*--------------------------------------------------------------------.
+| yysetstate -- set current state (the top of the stack) to yystate.  |
+`--------------------------------------------------------------------*/
+yysetstate:
+  YYDPRINTF ((stderr, "Entering state %d\n", yystate));
+  YY_ASSERT (0 <= yystate && yystate < YYNSTATES);
+  YY_IGNORE_USELESS_CAST_BEGIN
+  *yyssp = YY_CAST (yy_state_t, yystate);
+  YY_IGNORE_USELESS_CAST_END
+  YY_STACK_PRINT (yyss, yyssp);
 
   if (yyss + yystacksize - 1 <= yyssp)
+#if !defined yyoverflow && !defined YYSTACK_RELOCATE
+    YYNOMEM;
+#else
     {
       /* Get the current used size of the three stacks, in elements.  */
-      YYSIZE_T yysize = yyssp - yyss + 1;
+      YYPTRDIFF_T yysize = yyssp - yyss + 1;
 
-#ifdef yyoverflow
+# if defined yyoverflow
       {
         /* Give user a chance to reallocate the stack.  Use copies of
            these so that the &'s don't force the real ones into
            memory.  */
+        yy_state_t *yyss1 = yyss;
         YYSTYPE *yyvs1 = yyvs;
-        yytype_int16 *yyss1 = yyss;
+        YYLTYPE *yyls1 = yyls;
 
         /* Each stack pointer address is followed by the size of the
            data in use in that stack, in bytes.  This used to be a
            conditional around just the two extra args, but that might
            be undefined if yyoverflow is a macro.  */
         yyoverflow (YY_("memory exhausted"),
-                    &yyss1, yysize * sizeof (*yyssp),
-                    &yyvs1, yysize * sizeof (*yyvsp),
+                    &yyss1, yysize * YYSIZEOF (*yyssp),
+                    &yyvs1, yysize * YYSIZEOF (*yyvsp),
+                    &yyls1, yysize * YYSIZEOF (*yylsp),
                     &yystacksize);
-
         yyss = yyss1;
         yyvs = yyvs1;
+        yyls = yyls1;
       }
-#else /* no yyoverflow */
-# ifndef YYSTACK_RELOCATE
-      goto yyexhaustedlab;
-# else
+# else /* defined YYSTACK_RELOCATE */
       /* Extend the stack our own way.  */
       if (YYMAXDEPTH <= yystacksize)
-        goto yyexhaustedlab;
+        YYNOMEM;
       yystacksize *= 2;
       if (YYMAXDEPTH < yystacksize)
         yystacksize = YYMAXDEPTH;
 
       {
-        yytype_int16 *yyss1 = yyss;
+        yy_state_t *yyss1 = yyss;
         union yyalloc *yyptr =
-          (union yyalloc *) YYSTACK_ALLOC (YYSTACK_BYTES (yystacksize));
+          YY_CAST (union yyalloc *,
+                   YYSTACK_ALLOC (YY_CAST (YYSIZE_T, YYSTACK_BYTES (yystacksize))));
         if (! yyptr)
-          goto yyexhaustedlab;
+          YYNOMEM;
         YYSTACK_RELOCATE (yyss_alloc, yyss);
         YYSTACK_RELOCATE (yyvs_alloc, yyvs);
+        YYSTACK_RELOCATE (yyls_alloc, yyls);
 #  undef YYSTACK_RELOCATE
         if (yyss1 != yyssa)
           YYSTACK_FREE (yyss1);
       }
 # endif
-#endif /* no yyoverflow */
 
       yyssp = yyss + yysize - 1;
       yyvsp = yyvs + yysize - 1;
+      yylsp = yyls + yysize - 1;
 
-      YYDPRINTF ((stderr, "Stack size increased to %lu\n",
-                  (unsigned long int) yystacksize));
+      YY_IGNORE_USELESS_CAST_BEGIN
+      YYDPRINTF ((stderr, "Stack size increased to %ld\n",
+                  YY_CAST (long, yystacksize)));
+      YY_IGNORE_USELESS_CAST_END
 
       if (yyss + yystacksize - 1 <= yyssp)
         YYABORT;
     }
+#endif /* !defined yyoverflow && !defined YYSTACK_RELOCATE */
 
-  YYDPRINTF ((stderr, "Entering state %d\n", yystate));
 
   if (yystate == YYFINAL)
     YYACCEPT;
 
   goto yybackup;
 
+
 /*-----------.
 | yybackup.  |
 `-----------*/
 yybackup:
-
   /* Do appropriate processing given the current state.  Read a
      lookahead token if we need one and don't already have one.  */
 
@@ -1231,18 +1247,30 @@ yybackup:
 
   /* Not known => get a lookahead token if don't already have one.  */
 
-  /* YYCHAR is either YYEMPTY or YYEOF or a valid lookahead symbol.  */
+  /* YYCHAR is either empty, or end-of-input, or a valid lookahead.  */
   if (yychar == YYEMPTY)
     {
-      YYDPRINTF ((stderr, "Reading a token: "));
-      yychar = yylex ();
+      YYDPRINTF ((stderr, "Reading a token\n"));
+      yychar = yylex (&yylval, &yylloc, scanner);
     }
 
   if (yychar <= YYEOF)
     {
-      yychar = yytoken = YYEOF;
+      yychar = YYEOF;
+      yytoken = YYSYMBOL_YYEOF;
       YYDPRINTF ((stderr, "Now at end of input.\n"));
     }
+  else if (yychar == YYerror)
+    {
+      /* The scanner already issued an error message, process directly
+         to error recovery.  But do not keep the error token as
+         lookahead, it is too special and may lead us to an endless
+         loop in error recovery. */
+      yychar = YYUNDEF;
+      yytoken = YYSYMBOL_YYerror;
+      yyerror_range[1] = yylloc;
+      goto yyerrlab1;
+    }
   else
     {
       yytoken = YYTRANSLATE (yychar);
@@ -1270,15 +1298,14 @@ yybackup:
 
   /* Shift the lookahead token.  */
   YY_SYMBOL_PRINT ("Shifting", yytoken, &yylval, &yylloc);
-
-  /* Discard the shifted token.  */
-  yychar = YYEMPTY;
-
   yystate = yyn;
   YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
   *++yyvsp = yylval;
   YY_IGNORE_MAYBE_UNINITIALIZED_END
+  *++yylsp = yylloc;
 
+  /* Discard the shifted token.  */
+  yychar = YYEMPTY;
   goto yynewstate;
 
 
@@ -1293,7 +1320,7 @@ yydefault:
 
 
 /*-----------------------------.
-| yyreduce -- Do a reduction.  |
+| yyreduce -- do a reduction.  |
 `-----------------------------*/
 yyreduce:
   /* yyn is the number of a rule to reduce with.  */
@@ -1309,390 +1336,375 @@ yyreduce:
      GCC warning that YYVAL may be used uninitialized.  */
   yyval = yyvsp[1-yylen];
 
-
+  /* Default location. */
+  YYLLOC_DEFAULT (yyloc, (yylsp - yylen), yylen);
+  yyerror_range[1] = yyloc;
   YY_REDUCE_PRINT (yyn);
   switch (yyn)
     {
-        case 2:
-#line 39 "parse.y" /* yacc.c:1646  */
-    {ASTRoot = (yyvsp[0].node);}
-#line 1320 "parse.c" /* yacc.c:1646  */
+  case 5: /* declaration: var_declaration  */
+#line 76 "parse.y"
+                                          {streamDeclaration(ctx, addDeclaration(ctx, (yyvsp[0].node)));}
+#line 1349 "parse.c"
     break;
 
-  case 3:
-#line 42 "parse.y" /* yacc.c:1646  */
-    {(yyval.node) = newDecList((yyvsp[-1].node), (yyvsp[0].node));}
-#line 1326 "parse.c" /* yacc.c:1646  */
+  case 6: /* declaration: fun_declaration  */
+#line 77 "parse.y"
+                                                          {streamDeclaration(ctx, addDeclaration(ctx, (yyvsp[0].node)));}
+#line 1355 "parse.c"
     break;
 
-  case 4:
-#line 43 "parse.y" /* yacc.c:1646  */
-    {(yyval.node) = (yyvsp[0].node);}
-#line 1332 "parse.c" /* yacc.c:1646  */
+  case 7: /* type_specifier: INT  */
+#line 80 "parse.y"
+                              {(yyval.node) = newTypeSpe(ctx, TYPE_INTEGER, (yylsp[0]));}
+#line 1361 "parse.c"
     break;
 
-  case 5:
-#line 46 "parse.y" /* yacc.c:1646  */
-    {(yyval.node) = (yyvsp[0].node);}
-#line 1338 "parse.c" /* yacc.c:1646  */
+  case 8: /* type_specifier: VOID  */
+#line 81 "parse.y"
+                                               {(yyval.node) = newTypeSpe(ctx, TYPE_VOID, (yylsp[0]));}
+#line 1367 "parse.c"
     break;
 
-  case 6:
-#line 47 "parse.y" /* yacc.c:1646  */
-    {(yyval.node) = (yyvsp[0].node);}
-#line 1344 "parse.c" /* yacc.c:1646  */
+  case 9: /* var_declaration: type_specifier ID SEMI  */
+#line 84 "parse.y"
+                                                 {(yyval.node) = newVarDec(ctx, (yyvsp[-2].node), (yyvsp[-1].name), (yylsp[-1]));}
+#line 1373 "parse.c"
     break;
 
-  case 7:
-#line 50 "parse.y" /* yacc.c:1646  */
-    {(yyval.node) = newTypeSpe(TYPE_INTEGER, yylineno);}
-#line 1350 "parse.c" /* yacc.c:1646  */
+  case 10: /* var_declaration: type_specifier ID LSB NUMBER RSB SEMI  */
+#line 85 "parse.y"
+                                                                                {(yyval.node) = newArrayDec(ctx, (yyvsp[-5].node), (yyvsp[-4].name), (yyvsp[-2].value), (yylsp[-4]));}
+#line 1379 "parse.c"
     break;
 
-  case 8:
-#line 51 "parse.y" /* yacc.c:1646  */
-    {(yyval.node) = newTypeSpe(TYPE_VOID, yylineno);}
-#line 1356 "parse.c" /* yacc.c:1646  */
+  case 11: /* fun_declaration: fun_head compound_stmt  */
+#line 88 "parse.y"
+                                                 {(yyval.node) = newFunDec(ctx, (yyvsp[-1].node), (yyvsp[0].node), (yylsp[-1]));}
+#line 1385 "parse.c"
     break;
 
-  case 9:
-#line 54 "parse.y" /* yacc.c:1646  */
-    {(yyval.node) = newVarDec((yyvsp[-2].node), (yyvsp[-1].name), yylineno);}
-#line 1362 "parse.c" /* yacc.c:1646  */
+  case 12: /* fun_head: type_specifier ID LBracket params RBracket  */
+#line 91 "parse.y"
+                                                                             {(yyval.node) = newFunHead(ctx, (yyvsp[-4].node), (yyvsp[-3].name), (yyvsp[-1].node), (yylsp[-3]));}
+#line 1391 "parse.c"
     break;
 
-  case 10:
-#line 55 "parse.y" /* yacc.c:1646  */
-    {(yyval.node) = newArrayDec((yyvsp[-5].node), (yyvsp[-4].name), (yyvsp[-2].value), yylineno);}
-#line 1368 "parse.c" /* yacc.c:1646  */
+  case 13: /* compound_stmt: LBrace local_declarations statement_list RBrace  */
+#line 94 "parse.y"
+                                                                          {(yyval.node) = newCompound(ctx, (yyvsp[-2].list).head, (yyvsp[-1].list).head, (yylsp[-3]));}
+#line 1397 "parse.c"
     break;
 
-  case 11:
-#line 58 "parse.y" /* yacc.c:1646  */
-    {(yyval.node) = newFunDec((yyvsp[-1].node), (yyvsp[0].node), yylineno);}
-#line 1374 "parse.c" /* yacc.c:1646  */
+  case 14: /* params: param_list  */
+#line 97 "parse.y"
+                                     {(yyval.node) = (yyvsp[0].list).head;}
+#line 1403 "parse.c"
     break;
 
-  case 12:
-#line 61 "parse.y" /* yacc.c:1646  */
-    {(yyval.node) = newFunHead((yyvsp[-4].node), (yyvsp[-3].name), (yyvsp[-1].node), yylineno);}
-#line 1380 "parse.c" /* yacc.c:1646  */
+  case 15: /* params: VOID  */
+#line 98 "parse.y"
+                                                {(yyval.node) = NULL;}
+#line 1409 "parse.c"
     break;
 
-  case 13:
-#line 64 "parse.y" /* yacc.c:1646  */
-    {(yyval.node) = newCompound((yyvsp[-2].node), (yyvsp[-1].node), yylineno);}
-#line 1386 "parse.c" /* yacc.c:1646  */
+  case 16: /* param_list: param_list COMMA param  */
+#line 101 "parse.y"
+                                                         {(yyval.list) = newParamList((yyvsp[-2].list), (yyvsp[0].node));}
+#line 1415 "parse.c"
     break;
 
-  case 14:
-#line 67 "parse.y" /* yacc.c:1646  */
-    {(yyval.node) = (yyvsp[0].node);}
-#line 1392 "parse.c" /* yacc.c:1646  */
+  case 17: /* param_list: param  */
+#line 102 "parse.y"
+                                                {(yyval.list) = newParamList(EMPTY_LIST, (yyvsp[0].node));}
+#line 1421 "parse.c"
     break;
 
-  case 15:
-#line 68 "parse.y" /* yacc.c:1646  */
-    {(yyval.node) = NULL;}
-#line 1398 "parse.c" /* yacc.c:1646  */
+  case 18: /* param: type_specifier ID  */
+#line 105 "parse.y"
+                                                {(yyval.node) = newParam(ctx, (yyvsp[-1].node), (yyvsp[0].name), 0, (yylsp[0]));}
+#line 1427 "parse.c"
     break;
 
-  case 16:
-#line 71 "parse.y" /* yacc.c:1646  */
-    {(yyval.node) = newParamList((yyvsp[-2].node), (yyvsp[0].node));}
-#line 1404 "parse.c" /* yacc.c:1646  */
+  case 19: /* param: type_specifier ID LSB RSB  */
+#line 106 "parse.y"
+                                                                        {(yyval.node) = newParam(ctx, (yyvsp[-3].node), (yyvsp[-2].name), 1, (yylsp[-2]));}
+#line 1433 "parse.c"
     break;
 
-  case 17:
-#line 72 "parse.y" /* yacc.c:1646  */
-    {(yyval.node) = newParamList(NULL, (yyvsp[0].node));}
-#line 1410 "parse.c" /* yacc.c:1646  */
+  case 20: /* local_declarations: local_declarations var_declaration  */
+#line 111 "parse.y"
+                                                       {(yyval.list) = newLocalDecs((yyvsp[-1].list), (yyvsp[0].node));}
+#line 1439 "parse.c"
     break;
 
-  case 18:
-#line 75 "parse.y" /* yacc.c:1646  */
-    {(yyval.node) = newParam((yyvsp[-1].node), (yyvsp[0].name), 0, yylineno);}
-#line 1416 "parse.c" /* yacc.c:1646  */
+  case 21: /* local_declarations: %empty  */
+#line 112 "parse.y"
+                                          {(yyval.list) = EMPTY_LIST;}
+#line 1445 "parse.c"
     break;
 
-  case 19:
-#line 76 "parse.y" /* yacc.c:1646  */
-    {(yyval.node) = newParam((yyvsp[-3].node), (yyvsp[-2].name), 1, yylineno);}
-#line 1422 "parse.c" /* yacc.c:1646  */
+  case 22: /* statement_list: statement_list statement  */
+#line 115 "parse.y"
+                                                   {(yyval.list) = newStmtList((yyvsp[-1].list), (yyvsp[0].node));}
+#line 1451 "parse.c"
     break;
 
-  case 20:
-#line 81 "parse.y" /* yacc.c:1646  */
-    {(yyval.node) = newLocalDecs((yyvsp[-1].node), (yyvsp[0].node));}
-#line 1428 "parse.c" /* yacc.c:1646  */
+  case 23: /* statement_list: %empty  */
+#line 116 "parse.y"
+                                          {(yyval.list) = EMPTY_LIST;}
+#line 1457 "parse.c"
     break;
 
-  case 21:
-#line 82 "parse.y" /* yacc.c:1646  */
-    {(yyval.node) = NULL;}
-#line 1434 "parse.c" /* yacc.c:1646  */
+  case 24: /* statement: expression_stmt  */
+#line 119 "parse.y"
+                                      {(yyval.node) = (yyvsp[0].node);}
+#line 1463 "parse.c"
     break;
 
-  case 22:
-#line 85 "parse.y" /* yacc.c:1646  */
-    {(yyval.node) = newStmtList((yyvsp[-1].node), (yyvsp[0].node), yylineno);}
-#line 1440 "parse.c" /* yacc.c:1646  */
+  case 25: /* statement: compound_stmt  */
+#line 120 "parse.y"
+                                                        {(yyval.node) = (yyvsp[0].node);}
+#line 1469 "parse.c"
     break;
 
-  case 23:
-#line 86 "parse.y" /* yacc.c:1646  */
-    {(yyval.node) = NULL;}
-#line 1446 "parse.c" /* yacc.c:1646  */
+  case 26: /* statement: selection_stmt  */
+#line 121 "parse.y"
+                                                         {(yyval.node) = (yyvsp[0].node);}
+#line 1475 "parse.c"
     break;
 
-  case 24:
-#line 89 "parse.y" /* yacc.c:1646  */
-    {(yyval.node) = (yyvsp[0].node);}
-#line 1452 "parse.c" /* yacc.c:1646  */
+  case 27: /* statement: iteration_stmt  */
+#line 122 "parse.y"
+                                                         {(yyval.node) = (yyvsp[0].node);}
+#line 1481 "parse.c"
     break;
 
-  case 25:
-#line 90 "parse.y" /* yacc.c:1646  */
-    {(yyval.node) = (yyvsp[0].node);}
-#line 1458 "parse.c" /* yacc.c:1646  */
+  case 28: /* statement: return_stmt  */
+#line 123 "parse.y"
+                                                      {(yyval.node) = (yyvsp[0].node);}
+#line 1487 "parse.c"
     break;
 
-  case 26:
-#line 91 "parse.y" /* yacc.c:1646  */
-    {(yyval.node) = (yyvsp[0].node);}
-#line 1464 "parse.c" /* yacc.c:1646  */
+  case 29: /* expression_stmt: expression SEMI  */
+#line 126 "parse.y"
+                                          {(yyval.node) = (yyvsp[-1].node);}
+#line 1493 "parse.c"
     break;
 
-  case 27:
-#line 92 "parse.y" /* yacc.c:1646  */
-    {(yyval.node) = (yyvsp[0].node);}
-#line 1470 "parse.c" /* yacc.c:1646  */
+  case 30: /* expression_stmt: SEMI  */
+#line 127 "parse.y"
+                                               {(yyval.node) = NULL;}
+#line 1499 "parse.c"
     break;
 
-  case 28:
-#line 93 "parse.y" /* yacc.c:1646  */
-    {(yyval.node) = (yyvsp[0].node);}
-#line 1476 "parse.c" /* yacc.c:1646  */
+  case 31: /* selection_stmt: IF LBracket expression RBracket statement  */
+#line 130 "parse.y"
+                                                                        {(yyval.node) = newSelectStmt(ctx, (yyvsp[-2].node),(yyvsp[0].node),NULL, (yylsp[-4]));}
+#line 1505 "parse.c"
     break;
 
-  case 29:
-#line 96 "parse.y" /* yacc.c:1646  */
-    {(yyval.node) = (yyvsp[-1].node);}
-#line 1482 "parse.c" /* yacc.c:1646  */
+  case 32: /* selection_stmt: IF LBracket expression RBracket statement ELSE statement  */
+#line 131 "parse.y"
+                                                                                                   {(yyval.node) = newSelectStmt(ctx, (yyvsp[-4].node),(yyvsp[-2].node),(yyvsp[0].node), (yylsp[-6]));}
+#line 1511 "parse.c"
     break;
 
-  case 30:
-#line 97 "parse.y" /* yacc.c:1646  */
-    {(yyval.node) = NULL;}
-#line 1488 "parse.c" /* yacc.c:1646  */
+  case 33: /* iteration_stmt: WHILE LBracket expression RBracket statement  */
+#line 134 "parse.y"
+                                                                       {(yyval.node) = newIterStmt(ctx, (yyvsp[-2].node), (yyvsp[0].node), (yylsp[-4]));}
+#line 1517 "parse.c"
     break;
 
-  case 31:
-#line 100 "parse.y" /* yacc.c:1646  */
-    {(yyval.node) = newSelectStmt((yyvsp[-2].node),(yyvsp[0].node),NULL, yylineno);}
-#line 1494 "parse.c" /* yacc.c:1646  */
+  case 34: /* return_stmt: RETURN SEMI  */
+#line 137 "parse.y"
+                                              {(yyval.node) = newRetStmt(ctx, NULL, (yylsp[-1]));}
+#line 1523 "parse.c"
     break;
 
-  case 32:
-#line 101 "parse.y" /* yacc.c:1646  */
-    {(yyval.node) = newSelectStmt((yyvsp[-4].node),(yyvsp[-2].node),(yyvsp[0].node), yylineno);}
-#line 1500 "parse.c" /* yacc.c:1646  */
+  case 35: /* return_stmt: RETURN expression SEMI  */
+#line 138 "parse.y"
+                                                                 {(yyval.node) = newRetStmt(ctx, (yyvsp[-1].node), (yylsp[-2]));}
+#line 1529 "parse.c"
     break;
 
-  case 33:
-#line 104 "parse.y" /* yacc.c:1646  */
-    {(yyval.node) = newIterStmt((yyvsp[-2].node), (yyvsp[0].node), yylineno);}
-#line 1506 "parse.c" /* yacc.c:1646  */
+  case 36: /* expression: var ASSIGN expression  */
+#line 141 "parse.y"
+                                            {(yyval.node) = newAssignExp(ctx, (yyvsp[-2].node), (yyvsp[0].node), (yylsp[-1]));}
+#line 1535 "parse.c"
     break;
 
-  case 34:
-#line 107 "parse.y" /* yacc.c:1646  */
-    {(yyval.node) = newRetStmt(NULL, yylineno);}
-#line 1512 "parse.c" /* yacc.c:1646  */
+  case 37: /* expression: simple_expression  */
+#line 142 "parse.y"
+                                                                {(yyval.node) = (yyvsp[0].node);}
+#line 1541 "parse.c"
     break;
 
-  case 35:
-#line 108 "parse.y" /* yacc.c:1646  */
-    {(yyval.node) = newRetStmt((yyvsp[-1].node), yylineno);}
-#line 1518 "parse.c" /* yacc.c:1646  */
+  case 38: /* var: ID  */
+#line 145 "parse.y"
+                         {(yyval.node) = newVar(ctx, (yyvsp[0].name), (yylsp[0]));}
+#line 1547 "parse.c"
     break;
 
-  case 36:
-#line 111 "parse.y" /* yacc.c:1646  */
-    {(yyval.node) = newAssignExp((yyvsp[-2].node), (yyvsp[0].node), yylineno);}
-#line 1524 "parse.c" /* yacc.c:1646  */
+  case 39: /* var: ID LSB expression RSB  */
+#line 146 "parse.y"
+                                                                {(yyval.node) = newArrayVar(ctx, (yyvsp[-3].name), (yyvsp[-1].node), (yylsp[-3]));}
+#line 1553 "parse.c"
     break;
 
-  case 37:
-#line 112 "parse.y" /* yacc.c:1646  */
-    {(yyval.node) = (yyvsp[0].node);}
-#line 1530 "parse.c" /* yacc.c:1646  */
+  case 40: /* simple_expression: additive_expression relop additive_expression  */
+#line 149 "parse.y"
+                                                                        {(yyval.node) = newSimpExp(ctx, (yyvsp[-2].node), (yyvsp[-1].value), (yyvsp[0].node), (yylsp[-1]));}
+#line 1559 "parse.c"
     break;
 
-  case 38:
-#line 115 "parse.y" /* yacc.c:1646  */
-    {(yyval.node) = newVar((yyvsp[0].name), yylineno);}
-#line 1536 "parse.c" /* yacc.c:1646  */
+  case 41: /* simple_expression: additive_expression  */
+#line 150 "parse.y"
+                                                              {(yyval.node) = (yyvsp[0].node);}
+#line 1565 "parse.c"
     break;
 
-  case 39:
-#line 116 "parse.y" /* yacc.c:1646  */
-    {(yyval.node) = newArrayVar((yyvsp[-3].name), (yyvsp[-1].node), yylineno);}
-#line 1542 "parse.c" /* yacc.c:1646  */
+  case 42: /* relop: GT  */
+#line 153 "parse.y"
+                                     {(yyval.value) = GT;}
+#line 1571 "parse.c"
     break;
 
-  case 40:
-#line 119 "parse.y" /* yacc.c:1646  */
-    {(yyval.node) = newSimpExp((yyvsp[-2].node), (yyvsp[-1].value), (yyvsp[0].node), yylineno);}
-#line 1548 "parse.c" /* yacc.c:1646  */
+  case 43: /* relop: LT  */
+#line 154 "parse.y"
+                                             {(yyval.value) = LT;}
+#line 1577 "parse.c"
     break;
 
-  case 41:
-#line 120 "parse.y" /* yacc.c:1646  */
-    {(yyval.node) = (yyvsp[0].node);}
-#line 1554 "parse.c" /* yacc.c:1646  */
+  case 44: /* relop: GE  */
+#line 155 "parse.y"
+                                             {(yyval.value) = GE;}
+#line 1583 "parse.c"
     break;
 
-  case 42:
-#line 123 "parse.y" /* yacc.c:1646  */
-    {(yyval.value) = GT;}
-#line 1560 "parse.c" /* yacc.c:1646  */
+  case 45: /* relop: LE  */
+#line 156 "parse.y"
+                                             {(yyval.value) = LE;}
+#line 1589 "parse.c"
     break;
 
-  case 43:
-#line 124 "parse.y" /* yacc.c:1646  */
-    {(yyval.value) = LT;}
-#line 1566 "parse.c" /* yacc.c:1646  */
+  case 46: /* relop: EQ  */
+#line 157 "parse.y"
+                                             {(yyval.value) = EQ;}
+#line 1595 "parse.c"
     break;
 
-  case 44:
-#line 125 "parse.y" /* yacc.c:1646  */
-    {(yyval.value) = GE;}
-#line 1572 "parse.c" /* yacc.c:1646  */
+  case 47: /* relop: NE  */
+#line 158 "parse.y"
+                                             {(yyval.value) = NE;}
+#line 1601 "parse.c"
     break;
 
-  case 45:
-#line 126 "parse.y" /* yacc.c:1646  */
-    {(yyval.value) = LE;}
-#line 1578 "parse.c" /* yacc.c:1646  */
+  case 48: /* additive_expression: additive_expression addop term  */
+#line 161 "parse.y"
+                                                         {(yyval.node) = newAddExp(ctx, (yyvsp[-2].node), (yyvsp[-1].value), (yyvsp[0].node), (yylsp[-1]));}
+#line 1607 "parse.c"
     break;
 
-  case 46:
-#line 127 "parse.y" /* yacc.c:1646  */
-    {(yyval.value) = EQ;}
-#line 1584 "parse.c" /* yacc.c:1646  */
+  case 49: /* additive_expression: term  */
+#line 162 "parse.y"
+                                               {(yyval.node) = (yyvsp[0].node);}
+#line 1613 "parse.c"
     break;
 
-  case 47:
-#line 128 "parse.y" /* yacc.c:1646  */
-    {(yyval.value) = NE;}
-#line 1590 "parse.c" /* yacc.c:1646  */
+  case 50: /* addop: PLUS  */
+#line 165 "parse.y"
+                           {(yyval.value) = PLUS;}
+#line 1619 "parse.c"
     break;
 
-  case 48:
-#line 131 "parse.y" /* yacc.c:1646  */
-    {(yyval.node) = newAddExp((yyvsp[-2].node), (yyvsp[-1].value), (yyvsp[0].node), yylineno);}
-#line 1596 "parse.c" /* yacc.c:1646  */
+  case 51: /* addop: MINUS  */
+#line 166 "parse.y"
+                                                {(yyval.value) = MINUS;}
+#line 1625 "parse.c"
     break;
 
-  case 49:
-#line 132 "parse.y" /* yacc.c:1646  */
-    {(yyval.node) = (yyvsp[0].node);}
-#line 1602 "parse.c" /* yacc.c:1646  */
+  case 52: /* term: term mulop factor  */
+#line 169 "parse.y"
+                                        {(yyval.node) = newTerm(ctx, (yyvsp[-2].node), (yyvsp[-1].value), (yyvsp[0].node), (yylsp[-1]));}
+#line 1631 "parse.c"
     break;
 
-  case 50:
-#line 135 "parse.y" /* yacc.c:1646  */
-    {(yyval.value) = PLUS;}
-#line 1608 "parse.c" /* yacc.c:1646  */
+  case 53: /* term: factor  */
+#line 170 "parse.y"
+                                                 {(yyval.node) = (yyvsp[0].node);}
+#line 1637 "parse.c"
     break;
 
-  case 51:
-#line 136 "parse.y" /* yacc.c:1646  */
-    {(yyval.value) = MINUS;}
-#line 1614 "parse.c" /* yacc.c:1646  */
+  case 54: /* mulop: MULTI  */
+#line 173 "parse.y"
+                                {(yyval.value) = MULTI;}
+#line 1643 "parse.c"
     break;
 
-  case 52:
-#line 139 "parse.y" /* yacc.c:1646  */
-    {(yyval.node) = newTerm((yyvsp[-2].node), (yyvsp[-1].value), (yyvsp[0].node), yylineno);}
-#line 1620 "parse.c" /* yacc.c:1646  */
+  case 55: /* mulop: DIV  */
+#line 174 "parse.y"
+                                              {(yyval.value) = DIV;}
+#line 1649 "parse.c"
     break;
 
-  case 53:
-#line 140 "parse.y" /* yacc.c:1646  */
-    {(yyval.node) = (yyvsp[0].node);}
-#line 1626 "parse.c" /* yacc.c:1646  */
+  case 56: /* factor: LBracket expression RBracket  */
+#line 177 "parse.y"
+                                                   {(yyval.node) = (yyvsp[-1].node);}
+#line 1655 "parse.c"
     break;
 
-  case 54:
-#line 143 "parse.y" /* yacc.c:1646  */
-    {(yyval.value) = MULTI;}
-#line 1632 "parse.c" /* yacc.c:1646  */
+  case 57: /* factor: var  */
+#line 178 "parse.y"
+                                              {(yyval.node) = (yyvsp[0].node);}
+#line 1661 "parse.c"
     break;
 
-  case 55:
-#line 144 "parse.y" /* yacc.c:1646  */
-    {(yyval.value) = DIV;}
-#line 1638 "parse.c" /* yacc.c:1646  */
+  case 58: /* factor: call  */
+#line 179 "parse.y"
+                                               {(yyval.node) = (yyvsp[0].node);}
+#line 1667 "parse.c"
     break;
 
-  case 56:
-#line 147 "parse.y" /* yacc.c:1646  */
-    {(yyval.node) = (yyvsp[-1].node);}
-#line 1644 "parse.c" /* yacc.c:1646  */
+  case 59: /* factor: NUMBER  */
+#line 180 "parse.y"
+                                                 {(yyval.node) = newNumNode(ctx, (yyvsp[0].value), (yylsp[0]));}
+#line 1673 "parse.c"
     break;
 
-  case 57:
-#line 148 "parse.y" /* yacc.c:1646  */
-    {(yyval.node) = (yyvsp[0].node);}
-#line 1650 "parse.c" /* yacc.c:1646  */
+  case 60: /* call: ID LBracket args RBracket  */
+#line 183 "parse.y"
+                                                {(yyval.node) = newCall(ctx, (yyvsp[-3].name), (yyvsp[-1].node), (yylsp[-3]));}
+#line 1679 "parse.c"
     break;
 
-  case 58:
-#line 149 "parse.y" /* yacc.c:1646  */
-    {(yyval.node) = (yyvsp[0].node);}
-#line 1656 "parse.c" /* yacc.c:1646  */
+  case 61: /* args: arg_list  */
+#line 186 "parse.y"
+                               {(yyval.node) = (yyvsp[0].list).head;}
+#line 1685 "parse.c"
     break;
 
-  case 59:
-#line 150 "parse.y" /* yacc.c:1646  */
-    {(yyval.node) = newNumNode((yyvsp[0].value), yylineno);}
-#line 1662 "parse.c" /* yacc.c:1646  */
+  case 62: /* args: %empty  */
+#line 187 "parse.y"
+                                          {(yyval.node) = NULL;}
+#line 1691 "parse.c"
     break;
 
-  case 60:
-#line 153 "parse.y" /* yacc.c:1646  */
-    {(yyval.node) = newCall((yyvsp[-3].name), (yyvsp[-1].node), yylineno);}
-#line 1668 "parse.c" /* yacc.c:1646  */
+  case 63: /* arg_list: arg_list COMMA expression  */
+#line 190 "parse.y"
+                                                {(yyval.list) = newArgList((yyvsp[-2].list), (yyvsp[0].node));}
+#line 1697 "parse.c"
     break;
 
-  case 61:
-#line 156 "parse.y" /* yacc.c:1646  */
-    {(yyval.node) = (yyvsp[0].node);}
-#line 1674 "parse.c" /* yacc.c:1646  */
+  case 64: /* arg_list: expression  */
+#line 191 "parse.y"
+                                                     {(yyval.list) = newArgList(EMPTY_LIST, (yyvsp[0].node));}
+#line 1703 "parse.c"
     break;
 
-  case 62:
-#line 157 "parse.y" /* yacc.c:1646  */
-    {(yyval.node) = NULL;}
-#line 1680 "parse.c" /* yacc.c:1646  */
-    break;
-
-  case 63:
-#line 160 "parse.y" /* yacc.c:1646  */
-    {(yyval.node) = newArgList((yyvsp[-2].node), (yyvsp[0].node));}
-#line 1686 "parse.c" /* yacc.c:1646  */
-    break;
-
-  case 64:
-#line 161 "parse.y" /* yacc.c:1646  */
-    {(yyval.node) = (yyvsp[0].node);}
-#line 1692 "parse.c" /* yacc.c:1646  */
-    break;
 
+#line 1707 "parse.c"
 
-#line 1696 "parse.c" /* yacc.c:1646  */
       default: break;
     }
   /* User semantic actions sometimes alter yychar, and that requires
@@ -1706,25 +1718,24 @@ yyreduce:
      case of YYERROR or YYBACKUP, subsequent parser actions might lead
      to an incorrect destructor call or verbose syntax error message
      before the lookahead is translated.  */
-  YY_SYMBOL_PRINT ("-> $$ =", yyr1[yyn], &yyval, &yyloc);
+  YY_SYMBOL_PRINT ("-> $$ =", YY_CAST (yysymbol_kind_t, yyr1[yyn]), &yyval, &yyloc);
 
   YYPOPSTACK (yylen);
   yylen = 0;
-  YY_STACK_PRINT (yyss, yyssp);
 
   *++yyvsp = yyval;
+  *++yylsp = yyloc;
 
   /* Now 'shift' the result of the reduction.  Determine what state
      that goes to, based on the state we popped back to and the rule
      number reduced by.  */
-
-  yyn = yyr1[yyn];
-
-  yystate = yypgoto[yyn - YYNTOKENS] + *yyssp;
-  if (0 <= yystate && yystate <= YYLAST && yycheck[yystate] == *yyssp)
-    yystate = yytable[yystate];
-  else
-    yystate = yydefgoto[yyn - YYNTOKENS];
+  {
+    const int yylhs = yyr1[yyn] - YYNTOKENS;
+    const int yyi = yypgoto[yylhs] + *yyssp;
+    yystate = (0 <= yyi && yyi <= YYLAST && yycheck[yyi] == *yyssp
+               ? yytable[yyi]
+               : yydefgoto[yylhs]);
+  }
 
   goto yynewstate;
 
@@ -1735,50 +1746,15 @@ yyreduce:
 yyerrlab:
   /* Make sure we have latest lookahead translation.  See comments at
      user semantic actions for why this is necessary.  */
-  yytoken = yychar == YYEMPTY ? YYEMPTY : YYTRANSLATE (yychar);
-
+  yytoken = yychar == YYEMPTY ? YYSYMBOL_YYEMPTY : YYTRANSLATE (yychar);
   /* If not already recovering from an error, report this error.  */
   if (!yyerrstatus)
     {
       ++yynerrs;
-#if ! YYERROR_VERBOSE
-      yyerror (YY_("syntax error"));
-#else
-# define YYSYNTAX_ERROR yysyntax_error (&yymsg_alloc, &yymsg, \
-                                        yyssp, yytoken)
-      {
-        char const *yymsgp = YY_("syntax error");
-        int yysyntax_error_status;
-        yysyntax_error_status = YYSYNTAX_ERROR;
-        if (yysyntax_error_status == 0)
-          yymsgp = yymsg;
-        else if (yysyntax_error_status == 1)
-          {
-            if (yymsg != yymsgbuf)
-              YYSTACK_FREE (yymsg);
-            yymsg = (char *) YYSTACK_ALLOC (yymsg_alloc);
-            if (!yymsg)
-              {
-                yymsg = yymsgbuf;
-                yymsg_alloc = sizeof yymsgbuf;
-                yysyntax_error_status = 2;
-              }
-            else
-              {
-                yysyntax_error_status = YYSYNTAX_ERROR;
-                yymsgp = yymsg;
-              }
-          }
-        yyerror (yymsgp);
-        if (yysyntax_error_status == 2)
-          goto yyexhaustedlab;
-      }
-# undef YYSYNTAX_ERROR
-#endif
+      yyerror (&yylloc, scanner, ctx, YY_("syntax error"));
     }
 
-
-
+  yyerror_range[1] = yylloc;
   if (yyerrstatus == 3)
     {
       /* If just tried and failed to reuse lookahead token after an
@@ -1793,7 +1769,7 @@ yyerrlab:
       else
         {
           yydestruct ("Error: discarding",
-                      yytoken, &yylval);
+                      yytoken, &yylval, &yylloc, scanner, ctx);
           yychar = YYEMPTY;
         }
     }
@@ -1807,12 +1783,11 @@ yyerrlab:
 | yyerrorlab -- error raised explicitly by YYERROR.  |
 `---------------------------------------------------*/
 yyerrorlab:
-
-  /* Pacify compilers like GCC when the user code never invokes
-     YYERROR and the label yyerrorlab therefore never appears in user
-     code.  */
-  if (/*CONSTCOND*/ 0)
-     goto yyerrorlab;
+  /* Pacify compilers when the user code never invokes YYERROR and the
+     label yyerrorlab therefore never appears in user code.  */
+  if (0)
+    YYERROR;
+  ++yynerrs;
 
   /* Do not reclaim the symbols of the rule whose action triggered
      this YYERROR.  */
@@ -1829,13 +1804,14 @@ yyerrorlab:
 yyerrlab1:
   yyerrstatus = 3;      /* Each real token shifted decrements this.  */
 
+  /* Pop stack until we find a state that shifts the error token.  */
   for (;;)
     {
       yyn = yypact[yystate];
       if (!yypact_value_is_default (yyn))
         {
-          yyn += YYTERROR;
-          if (0 <= yyn && yyn <= YYLAST && yycheck[yyn] == YYTERROR)
+          yyn += YYSYMBOL_YYerror;
+          if (0 <= yyn && yyn <= YYLAST && yycheck[yyn] == YYSYMBOL_YYerror)
             {
               yyn = yytable[yyn];
               if (0 < yyn)
@@ -1847,9 +1823,9 @@ yyerrlab1:
       if (yyssp == yyss)
         YYABORT;
 
-
+      yyerror_range[1] = *yylsp;
       yydestruct ("Error: popping",
-                  yystos[yystate], yyvsp);
+                  YY_ACCESSING_SYMBOL (yystate), yyvsp, yylsp, scanner, ctx);
       YYPOPSTACK (1);
       yystate = *yyssp;
       YY_STACK_PRINT (yyss, yyssp);
@@ -1859,9 +1835,12 @@ yyerrlab1:
   *++yyvsp = yylval;
   YY_IGNORE_MAYBE_UNINITIALIZED_END
 
+  yyerror_range[2] = yylloc;
+  ++yylsp;
+  YYLLOC_DEFAULT (*yylsp, yyerror_range, 2);
 
   /* Shift the error token.  */
-  YY_SYMBOL_PRINT ("Shifting", yystos[yyn], yyvsp, yylsp);
+  YY_SYMBOL_PRINT ("Shifting", YY_ACCESSING_SYMBOL (yyn), yyvsp, yylsp);
 
   yystate = yyn;
   goto yynewstate;
@@ -1872,33 +1851,37 @@ yyerrlab1:
 `-------------------------------------*/
 yyacceptlab:
   yyresult = 0;
-  goto yyreturn;
+  goto yyreturnlab;
+
 
 /*-----------------------------------.
 | yyabortlab -- YYABORT comes here.  |
 `-----------------------------------*/
 yyabortlab:
   yyresult = 1;
-  goto yyreturn;
+  goto yyreturnlab;
 
-#if !defined yyoverflow || YYERROR_VERBOSE
-/*-------------------------------------------------.
-| yyexhaustedlab -- memory exhaustion comes here.  |
-`-------------------------------------------------*/
+
+/*-----------------------------------------------------------.
+| yyexhaustedlab -- YYNOMEM (memory exhaustion) comes here.  |
+`-----------------------------------------------------------*/
 yyexhaustedlab:
-  yyerror (YY_("memory exhausted"));
+  yyerror (&yylloc, scanner, ctx, YY_("memory exhausted"));
   yyresult = 2;
-  /* Fall through.  */
-#endif
+  goto yyreturnlab;
+
 
-yyreturn:
+/*----------------------------------------------------------.
+| yyreturnlab -- parsing is finished, clean up and return.  |
+`----------------------------------------------------------*/
+yyreturnlab:
   if (yychar != YYEMPTY)
     {
       /* Make sure we have latest lookahead translation.  See comments at
          user semantic actions for why this is necessary.  */
       yytoken = YYTRANSLATE (yychar);
       yydestruct ("Cleanup: discarding lookahead",
-                  yytoken, &yylval);
+                  yytoken, &yylval, &yylloc, scanner, ctx);
     }
   /* Do not reclaim the symbols of the rule whose action triggered
      this YYABORT or YYACCEPT.  */
@@ -1907,24 +1890,40 @@ yyreturn:
   while (yyssp != yyss)
     {
       yydestruct ("Cleanup: popping",
-                  yystos[*yyssp], yyvsp);
+                  YY_ACCESSING_SYMBOL (+*yyssp), yyvsp, yylsp, scanner, ctx);
       YYPOPSTACK (1);
     }
 #ifndef yyoverflow
   if (yyss != yyssa)
     YYSTACK_FREE (yyss);
 #endif
-#if YYERROR_VERBOSE
-  if (yymsg != yymsgbuf)
-    YYSTACK_FREE (yymsg);
-#endif
+
   return yyresult;
 }
-#line 164 "parse.y" /* yacc.c:1906  */
 
+#line 194 "parse.y"
+
+
+
+static int timedLex(CompilerContext *ctx, YYSTYPE *lvalp, YYLTYPE *llocp, void *scanner) {
+     int token;
+     if(ctx->tokenMode != TOKENS_PULL) {
+          token = replayToken(ctx, lvalp);
+     } else if(!ctx->timer.enabled) {
+          token = (yylex)(lvalp, scanner);
+     } else {
+          timerStart(ctx, PHASE_SCAN);
+          token = (yylex)(lvalp, scanner);
+          timerStop(ctx);
+     }
+     *llocp = tokenStart(ctx);
+     return token;
+}
 
 
-int yyerror(char *errmsg) {
-     fprintf(stderr, "%d: %s at '%s' \n", yylineno, errmsg, yytext);
+int yyerror(YYLTYPE *llocp, void *scanner, CompilerContext *ctx, const char *errmsg) {
+     /* bison passes every parse-param; the message only needs ctx. */
+     (void)scanner;
+     fprintf(ctx->diagnostics, "%s: %s at '%s' \n", sourcePosition(ctx, *llocp), errmsg, tokenText(ctx));
      return 0;
 }
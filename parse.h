@@ -1,8 +1,9 @@
-/* A Bison parser, made by GNU Bison 3.0.2.  */
+/* A Bison parser, made by GNU Bison 3.8.2.  */
 
 /* Bison interface for Yacc-like parsers in C
 
-   Copyright (C) 1984, 1989-1990, 2000-2013 Free Software Foundation, Inc.
+   Copyright (C) 1984, 1989-1990, 2000-2015, 2018-2021 Free Software Foundation,
+   Inc.
 
    This program is free software: you can redistribute it and/or modify
    it under the terms of the GNU General Public License as published by
@@ -15,7 +16,7 @@
    GNU General Public License for more details.
 
    You should have received a copy of the GNU General Public License
-   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.  */
 
 /* As a special exception, you may create a larger work that contains
    part or all of the Bison parser skeleton and distribute that work
@@ -30,6 +31,10 @@
    This special exception was added by the Free Software Foundation in
    version 2.2 of Bison.  */
 
+/* DO NOT RELY ON FEATURES THAT ARE NOT DOCUMENTED in the manual,
+   especially those whose name start with YY_ or yy_.  They are
+   private implementation details that can be changed or removed.  */
+
 #ifndef YY_YY_PARSE_H_INCLUDED
 # define YY_YY_PARSE_H_INCLUDED
 /* Debug traces.  */
@@ -39,63 +44,80 @@
 #if YYDEBUG
 extern int yydebug;
 #endif
+/* "%code requires" blocks.  */
+#line 1 "parse.y"
+
+#include "globals.h"
+
+#line 53 "parse.h"
 
-/* Token type.  */
+/* Token kinds.  */
 #ifndef YYTOKENTYPE
 # define YYTOKENTYPE
   enum yytokentype
   {
-    IF = 258,
-    ELSE = 259,
-    RETURN = 260,
-    WHILE = 261,
-    INT = 262,
-    VOID = 263,
-    LBracket = 264,
-    RBracket = 265,
-    LBrace = 266,
-    RBrace = 267,
-    Quote = 268,
-    LSB = 269,
-    RSB = 270,
-    COMMA = 271,
-    SEMI = 272,
-    ASSIGN = 273,
-    MINUS = 274,
-    PLUS = 275,
-    MULTI = 276,
-    DIV = 277,
-    GT = 278,
-    LT = 279,
-    GE = 280,
-    LE = 281,
-    EQ = 282,
-    NE = 283,
-    NUMBER = 284,
-    ID = 285
+    YYEMPTY = -2,
+    YYEOF = 0,                     /* "end of file"  */
+    YYerror = 256,                 /* error  */
+    YYUNDEF = 257,                 /* "invalid token"  */
+    IF = 258,                      /* IF  */
+    ELSE = 259,                    /* ELSE  */
+    RETURN = 260,                  /* RETURN  */
+    WHILE = 261,                   /* WHILE  */
+    INT = 262,                     /* INT  */
+    VOID = 263,                    /* VOID  */
+    LBracket = 264,                /* LBracket  */
+    RBracket = 265,                /* RBracket  */
+    LBrace = 266,                  /* LBrace  */
+    RBrace = 267,                  /* RBrace  */
+    Quote = 268,                   /* Quote  */
+    LSB = 269,                     /* LSB  */
+    RSB = 270,                     /* RSB  */
+    COMMA = 271,                   /* COMMA  */
+    SEMI = 272,                    /* SEMI  */
+    ASSIGN = 273,                  /* ASSIGN  */
+    MINUS = 274,                   /* MINUS  */
+    PLUS = 275,                    /* PLUS  */
+    MULTI = 276,                   /* MULTI  */
+    DIV = 277,                     /* DIV  */
+    GT = 278,                      /* GT  */
+    LT = 279,                      /* LT  */
+    GE = 280,                      /* GE  */
+    LE = 281,                      /* LE  */
+    EQ = 282,                      /* EQ  */
+    NE = 283,                      /* NE  */
+    NUMBER = 284,                  /* NUMBER  */
+    ID = 285                       /* ID  */
   };
+  typedef enum yytokentype yytoken_kind_t;
 #endif
 
 /* Value type.  */
 #if ! defined YYSTYPE && ! defined YYSTYPE_IS_DECLARED
-typedef union YYSTYPE YYSTYPE;
 union YYSTYPE
 {
-#line 30 "parse.y" /* yacc.c:1909  */
+#line 49 "parse.y"
 
      char *name;
      int value;
      struct ASTNode *node;
+     NodeList list;
+
+#line 107 "parse.h"
 
-#line 91 "parse.h" /* yacc.c:1909  */
 };
+typedef union YYSTYPE YYSTYPE;
 # define YYSTYPE_IS_TRIVIAL 1
 # define YYSTYPE_IS_DECLARED 1
 #endif
 
+/* Location type.  */
+typedef int YYLTYPE;
+
+
+
 
-extern YYSTYPE yylval;
+int yyparse (void *scanner, CompilerContext *ctx);
 
-int yyparse (void);
 
 #endif /* !YY_YY_PARSE_H_INCLUDED  */
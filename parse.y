@@ -1,14 +1,33 @@
+%code requires {
+#include "globals.h"
+}
+
 %{
 #define YYPARSER
 
 #include "globals.h"
 #include "SyntaxTree.h"
-
-extern int yylineno;
-extern char* yytext;
+#include "Timer.h"
+#include "CodeGeneration.h"
+#include "CompactTree.h"
+#include "Tokens.h"
+#include "Location.h"
+
+/* A location is the byte offset at which a construct starts: that of
+ * its first token, which Tokens.c gives whether the tokens come from
+ * the scanner, a token array or a pipeline. An empty rule is located
+ * where the symbol before it starts. */
+#define YYLLOC_DEFAULT(Current, Rhs, N) \
+     ((Current) = (N) > 0 ? YYRHSLOC(Rhs, 1) : YYRHSLOC(Rhs, 0))
 
 %}
 
+%define api.pure full
+%define api.location.type {int}
+%locations
+%parse-param {void *scanner} {CompilerContext *ctx}
+%lex-param {void *scanner}
+
 %token IF ELSE RETURN WHILE INT VOID
 %token LBracket RBracket LBrace RBrace Quote LSB RSB COMMA SEMI ASSIGN
 
@@ -18,72 +37,83 @@ extern char* yytext;
 %token <value>NUMBER
 %token <name>ID
 
-%type <node> program declaration_list declaration 
 %type <node> var_declaration fun_declaration type_specifier 
-%type <node> fun_head params param_list param compound_stmt 
-%type <node> local_declarations statement_list statement
+%type <node> fun_head params param compound_stmt 
+%type <node> statement
 %type <node> expression_stmt selection_stmt iteration_stmt return_stmt 
 %type <node> expression var
-%type <node> simple_expression additive_expression term factor call args arg_list
+%type <node> simple_expression additive_expression term factor call args
+%type <list> param_list local_declarations statement_list arg_list
 %type <value> relop addop mulop
 
 %union {
      char *name;
      int value;
      struct ASTNode *node;
+     NodeList list;
+}
+
+%code {
+int yylex(YYSTYPE *lvalp, void *scanner);
+int yyerror(YYLTYPE *llocp, void *scanner, CompilerContext *ctx, const char *errmsg);
+
+/* Tokens are read through timedLex so -ftime-report can separate
+ * scanning from the parser actions, and so each is located. */
+static int timedLex(CompilerContext *ctx, YYSTYPE *lvalp, YYLTYPE *llocp, void *scanner);
+#define yylex(lvalp, llocp, scanner) timedLex(ctx, lvalp, llocp, scanner)
 }
 
 
 %%
 
-program				: declaration_list {ASTRoot = $1;}
+program				: declaration_list
 					;
 
-declaration_list	: declaration_list declaration {$$ = newDecList($1, $2);}
-					| declaration {$$ = $1;}
+declaration_list	: declaration_list declaration
+					| declaration
 					;
 
-declaration     	: var_declaration {$$ = $1;}
-					| fun_declaration {$$ = $1;}
+declaration     	: var_declaration {streamDeclaration(ctx, addDeclaration(ctx, $1));}
+					| fun_declaration {streamDeclaration(ctx, addDeclaration(ctx, $1));}
 					;
 
-type_specifier		: INT {$$ = newTypeSpe(TYPE_INTEGER, yylineno);}
-					| VOID {$$ = newTypeSpe(TYPE_VOID, yylineno);}
+type_specifier		: INT {$$ = newTypeSpe(ctx, TYPE_INTEGER, @1);}
+					| VOID {$$ = newTypeSpe(ctx, TYPE_VOID, @1);}
 					;
 
-var_declaration		: type_specifier ID SEMI {$$ = newVarDec($1, $2, yylineno);}
-					| type_specifier ID LSB NUMBER RSB SEMI	{$$ = newArrayDec($1, $2, $4, yylineno);}
+var_declaration		: type_specifier ID SEMI {$$ = newVarDec(ctx, $1, $2, @2);}
+					| type_specifier ID LSB NUMBER RSB SEMI	{$$ = newArrayDec(ctx, $1, $2, $4, @2);}
 					;
 
-fun_declaration		: fun_head compound_stmt {$$ = newFunDec($1, $2, yylineno);}
+fun_declaration		: fun_head compound_stmt {$$ = newFunDec(ctx, $1, $2, @1);}
 					;
 
-fun_head			: type_specifier ID LBracket params RBracket {$$ = newFunHead($1, $2, $4, yylineno);}
+fun_head			: type_specifier ID LBracket params RBracket {$$ = newFunHead(ctx, $1, $2, $4, @2);}
 					;
 
-compound_stmt		: LBrace local_declarations statement_list RBrace {$$ = newCompound($2, $3, yylineno);}
+compound_stmt		: LBrace local_declarations statement_list RBrace {$$ = newCompound(ctx, $2.head, $3.head, @1);}
 					;
 
-params          	: param_list {$$ = $1;}
+params          	: param_list {$$ = $1.head;}
 					| VOID	{$$ = NULL;}
 					;
 
 param_list			: param_list COMMA param {$$ = newParamList($1, $3);}
-					| param	{$$ = newParamList(NULL, $1);}
+					| param	{$$ = newParamList(EMPTY_LIST, $1);}
 					;
 
-param           	: type_specifier ID	{$$ = newParam($1, $2, 0, yylineno);}
-					| type_specifier ID LSB RSB	{$$ = newParam($1, $2, 1, yylineno);}
+param           	: type_specifier ID	{$$ = newParam(ctx, $1, $2, 0, @2);}
+					| type_specifier ID LSB RSB	{$$ = newParam(ctx, $1, $2, 1, @2);}
 					;
 
 
 
 local_declarations: local_declarations var_declaration {$$ = newLocalDecs($1, $2);}
-					| {$$ = NULL;}
+					| {$$ = EMPTY_LIST;}
 					;
 
-statement_list		: statement_list statement {$$ = newStmtList($1, $2, yylineno);}
-					| {$$ = NULL;}
+statement_list		: statement_list statement {$$ = newStmtList($1, $2);}
+					| {$$ = EMPTY_LIST;}
 					;
 
 statement           : expression_stmt {$$ = $1;}
@@ -97,26 +127,26 @@ expression_stmt		: expression SEMI {$$ = $1;}
 					| SEMI {$$ = NULL;}
 					;
 
-selection_stmt		: IF LBracket expression RBracket statement	{$$ = newSelectStmt($3,$5,NULL, yylineno);}
-					| IF LBracket expression RBracket statement ELSE statement {$$ = newSelectStmt($3,$5,$7, yylineno);}
+selection_stmt		: IF LBracket expression RBracket statement	{$$ = newSelectStmt(ctx, $3,$5,NULL, @1);}
+					| IF LBracket expression RBracket statement ELSE statement {$$ = newSelectStmt(ctx, $3,$5,$7, @1);}
 					;
 
-iteration_stmt		: WHILE LBracket expression RBracket statement {$$ = newIterStmt($3, $5, yylineno);}
+iteration_stmt		: WHILE LBracket expression RBracket statement {$$ = newIterStmt(ctx, $3, $5, @1);}
 					;
 
-return_stmt			: RETURN SEMI {$$ = newRetStmt(NULL, yylineno);}
-					| RETURN expression SEMI {$$ = newRetStmt($2, yylineno);}
+return_stmt			: RETURN SEMI {$$ = newRetStmt(ctx, NULL, @1);}
+					| RETURN expression SEMI {$$ = newRetStmt(ctx, $2, @1);}
 					;
 
-expression          : var ASSIGN expression {$$ = newAssignExp($1, $3, yylineno);}
+expression          : var ASSIGN expression {$$ = newAssignExp(ctx, $1, $3, @2);}
 					| simple_expression	{$$ = $1;}
 					;
 
-var                 : ID {$$ = newVar($1, yylineno);}
-					| ID LSB expression RSB	{$$ = newArrayVar($1, $3, yylineno);}
+var                 : ID {$$ = newVar(ctx, $1, @1);}
+					| ID LSB expression RSB	{$$ = newArrayVar(ctx, $1, $3, @1);}
 					;
 
-simple_expression   : additive_expression relop additive_expression	{$$ = newSimpExp($1, $2, $3, yylineno);}
+simple_expression   : additive_expression relop additive_expression	{$$ = newSimpExp(ctx, $1, $2, $3, @2);}
 					| additive_expression {$$ = $1;}
 					;
 
@@ -128,7 +158,7 @@ relop				: GT {$$ = GT;}
 					| NE {$$ = NE;}
 					;
 
-additive_expression	: additive_expression addop term {$$ = newAddExp($1, $2, $3, yylineno);}
+additive_expression	: additive_expression addop term {$$ = newAddExp(ctx, $1, $2, $3, @2);}
 					| term {$$ = $1;}
 					;
 
@@ -136,7 +166,7 @@ addop               : PLUS {$$ = PLUS;}
 					| MINUS	{$$ = MINUS;}
 					;
 
-term                : term mulop factor	{$$ = newTerm($1, $2, $3, yylineno);}
+term                : term mulop factor	{$$ = newTerm(ctx, $1, $2, $3, @2);}
 					| factor {$$ = $1;}
 					;
 
@@ -147,24 +177,42 @@ mulop               : MULTI	{$$ = MULTI;}
 factor              : LBracket expression RBracket {$$ = $2;}
 					| var {$$ = $1;}
 					| call {$$ = $1;}
-					| NUMBER {$$ = newNumNode($1, yylineno);}
+					| NUMBER {$$ = newNumNode(ctx, $1, @1);}
 					;
 
-call                : ID LBracket args RBracket	{$$ = newCall($1, $3, yylineno);}
+call                : ID LBracket args RBracket	{$$ = newCall(ctx, $1, $3, @1);}
 					;
 
-args                : arg_list {$$ = $1;}
+args                : arg_list {$$ = $1.head;}
 					| {$$ = NULL;}
 					;
 
 arg_list            : arg_list COMMA expression	{$$ = newArgList($1, $3);}
-					| expression {$$ = $1;}
+					| expression {$$ = newArgList(EMPTY_LIST, $1);}
 					;
 
 %%
 
 
-int yyerror(char *errmsg) {
-     fprintf(stderr, "%d: %s at '%s' \n", yylineno, errmsg, yytext);
+static int timedLex(CompilerContext *ctx, YYSTYPE *lvalp, YYLTYPE *llocp, void *scanner) {
+     int token;
+     if(ctx->tokenMode != TOKENS_PULL) {
+          token = replayToken(ctx, lvalp);
+     } else if(!ctx->timer.enabled) {
+          token = (yylex)(lvalp, scanner);
+     } else {
+          timerStart(ctx, PHASE_SCAN);
+          token = (yylex)(lvalp, scanner);
+          timerStop(ctx);
+     }
+     *llocp = tokenStart(ctx);
+     return token;
+}
+
+
+int yyerror(YYLTYPE *llocp, void *scanner, CompilerContext *ctx, const char *errmsg) {
+     /* bison passes every parse-param; the message only needs ctx. */
+     (void)scanner;
+     fprintf(ctx->diagnostics, "%s: %s at '%s' \n", sourcePosition(ctx, *llocp), errmsg, tokenText(ctx));
      return 0;
 }